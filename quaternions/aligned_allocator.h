@@ -0,0 +1,37 @@
+#ifndef QUATERNIONS_ALIGNED_ALLOCATOR_H
+#define QUATERNIONS_ALIGNED_ALLOCATOR_H
+
+#include <cstddef>
+#include <new>
+
+namespace quaternions {
+    /**
+     * Allocator for storage aligned to the widest vector register (64 bytes for AVX-512)
+     */
+    template<typename T, std::size_t Alignment = 64>
+    struct aligned_allocator {
+        using value_type = T;
+
+        template<typename U>
+        struct rebind {
+            using other = aligned_allocator<U, Alignment>;
+        };
+
+        aligned_allocator() = default;
+
+        template<typename U>
+        aligned_allocator(const aligned_allocator<U, Alignment>&) {}
+
+        T* allocate(std::size_t n) {
+            return static_cast<T*>(::operator new(n * sizeof(T), std::align_val_t{Alignment}));
+        }
+
+        void deallocate(T* p, std::size_t) {
+            ::operator delete(p, std::align_val_t{Alignment});
+        }
+
+        bool operator==(const aligned_allocator&) const = default;
+    };
+}
+
+#endif //QUATERNIONS_ALIGNED_ALLOCATOR_H
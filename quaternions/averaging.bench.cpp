@@ -0,0 +1,31 @@
+#include <catch2/catch_test_macros.hpp>
+#include <catch2/benchmark/catch_benchmark.hpp>
+#include "averaging.h"
+#include <vector>
+#include "../test/benchmarks.h"
+#include "../test/helpers.h"
+
+namespace q = quaternions;
+
+TEST_CASE("rotation averaging")
+{
+    for (const auto n : benchmark_batch_sizes) {
+        const auto samples = random_unit_quaternions(n, 1);
+        const auto weights = std::vector<double>(n, 0.5);
+        BENCHMARK("sum and normalize x" + batch_label(n)) {
+            auto sum = q::quaternion{0, 0, 0, 0};
+            for (const auto& s : samples)
+                sum = sum + s;
+            return sum.normalized();
+        };
+        BENCHMARK("average x" + batch_label(n)) {
+            return q::average(samples);
+        };
+        BENCHMARK("weighted average x" + batch_label(n)) {
+            return q::average(samples, weights);
+        };
+        BENCHMARK("parallel average x" + batch_label(n)) {
+            return q::average(q::execution::par, samples);
+        };
+    }
+}
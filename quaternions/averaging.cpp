@@ -0,0 +1,223 @@
+#include "averaging.h"
+#include "parallel.h"
+#include <algorithm>
+#include <cmath>
+#include <stdexcept>
+#include <vector>
+
+namespace q = quaternions;
+
+namespace {
+    constexpr std::size_t min_chunk = 16384;
+
+    struct sums {
+        std::array<double, 10> m{};
+        double weight = 0;
+    };
+
+    void check_weights(std::span<const q::quaternion> quaternions, std::span<const double> weights) {
+        if (quaternions.size() != weights.size())
+            throw std::domain_error("averaging needs one weight per quaternion!");
+        if (std::any_of(weights.begin(), weights.end(), [](double w) { return w < 0; }))
+            throw std::domain_error("weights must not be negative!");
+    }
+
+    /**
+     * Outer products of in[begin, end), weighted by weights unless that is empty
+     */
+    sums accumulate(std::span<const q::quaternion> in, std::span<const double> weights, std::size_t begin,
+                    std::size_t end) {
+        // two independent sets of sums halve the chains of dependent additions
+        double m[2][10] = {};
+        double weight[2] = {};
+        for (auto i = begin; i < end; ++i) {
+            const auto& q = in[i];
+            const auto w = weights.empty() ? 1.0 : weights[i];
+            const auto wq = q::quaternion{w * q.w, w * q.x, w * q.y, w * q.z};
+            auto& s = m[i & 1];
+            s[0] += wq.w * q.w;
+            s[1] += wq.w * q.x;
+            s[2] += wq.w * q.y;
+            s[3] += wq.w * q.z;
+            s[4] += wq.x * q.x;
+            s[5] += wq.x * q.y;
+            s[6] += wq.x * q.z;
+            s[7] += wq.y * q.y;
+            s[8] += wq.y * q.z;
+            s[9] += wq.z * q.z;
+            weight[i & 1] += w;
+        }
+        auto result = sums{};
+        for (std::size_t k = 0; k < 10; ++k)
+            result.m[k] = m[0][k] + m[1][k];
+        result.weight = weight[0] + weight[1];
+        return result;
+    }
+
+    /**
+     * Sums of blocks on the executor of policy, added up in block order. The blocks depend on
+     * nothing but the number of rotations, so neither scheduling nor the executor changes the sum.
+     */
+    sums parallel_accumulate(q::execution::parallel_policy policy, std::span<const q::quaternion> in,
+                             std::span<const double> weights) {
+        const auto n = in.size();
+        if (n < 2 * min_chunk)
+            return accumulate(in, weights, 0, n);
+        const auto blocks = n / min_chunk;
+        auto partial = std::vector<sums>(blocks);
+        q::parallel_for(policy, blocks, 1, [&](std::size_t first, std::size_t last) {
+            for (auto block = first; block < last; ++block)
+                partial[block] = accumulate(in, weights, block * n / blocks, (block + 1) * n / blocks);
+        });
+        auto result = sums{};
+        for (const auto& p : partial) {
+            for (std::size_t k = 0; k < 10; ++k)
+                result.m[k] += p.m[k];
+            result.weight += p.weight;
+        }
+        return result;
+    }
+
+    /**
+     * Eigenvector of the largest eigenvalue of the symmetric 4x4 matrix a, by cyclic Jacobi
+     * rotations, which converge quadratically and stay accurate for close eigenvalues
+     */
+    std::array<double, 4> dominant_eigenvector(double a[4][4]) {
+        double v[4][4] = {{1, 0, 0, 0}, {0, 1, 0, 0}, {0, 0, 1, 0}, {0, 0, 0, 1}};
+        for (int sweep = 0; sweep < 50; ++sweep) {
+            auto off_diagonal = 0.0;
+            auto diagonal = 0.0;
+            for (std::size_t p = 0; p < 4; ++p) {
+                diagonal += a[p][p] * a[p][p];
+                for (auto r = p + 1; r < 4; ++r)
+                    off_diagonal += a[p][r] * a[p][r];
+            }
+            if (off_diagonal <= 1E-36 * diagonal)
+                break;
+
+            for (std::size_t p = 0; p < 3; ++p)
+                for (auto r = p + 1; r < 4; ++r) {
+                    if (a[p][r] == 0)
+                        continue;
+                    // rotation by t = tan(φ) in the (p, r) plane that zeroes a[p][r]
+                    const auto theta = (a[r][r] - a[p][p]) / (2 * a[p][r]);
+                    const auto t = std::copysign(1.0, theta) / (std::abs(theta) + std::sqrt(theta * theta + 1));
+                    const auto c = 1 / std::sqrt(t * t + 1);
+                    const auto s = t * c;
+                    for (std::size_t k = 0; k < 4; ++k) {
+                        const auto akp = a[k][p], akr = a[k][r];
+                        a[k][p] = c * akp - s * akr;
+                        a[k][r] = s * akp + c * akr;
+                    }
+                    for (std::size_t k = 0; k < 4; ++k) {
+                        const auto apk = a[p][k], ark = a[r][k];
+                        a[p][k] = c * apk - s * ark;
+                        a[r][k] = s * apk + c * ark;
+                    }
+                    for (std::size_t k = 0; k < 4; ++k) {
+                        const auto vkp = v[k][p], vkr = v[k][r];
+                        v[k][p] = c * vkp - s * vkr;
+                        v[k][r] = s * vkp + c * vkr;
+                    }
+                }
+        }
+
+        std::size_t largest = 0;
+        for (std::size_t k = 1; k < 4; ++k)
+            largest = a[k][k] > a[largest][largest] ? k : largest;
+        return {v[0][largest], v[1][largest], v[2][largest], v[3][largest]};
+    }
+}
+
+void q::rotation_accumulator::add(const quaternion& q, double weight) {
+    add(std::span(&q, 1), std::span(&weight, 1));
+}
+
+void q::rotation_accumulator::add(std::span<const quaternion> quaternions) {
+    add(execution::seq, quaternions);
+}
+
+void q::rotation_accumulator::add(std::span<const quaternion> quaternions, std::span<const double> weights) {
+    add(execution::seq, quaternions, weights);
+}
+
+void q::rotation_accumulator::add(execution::sequenced_policy, std::span<const quaternion> quaternions) {
+    const auto s = accumulate(quaternions, {}, 0, quaternions.size());
+    merge(s.m, s.weight);
+}
+
+void q::rotation_accumulator::add(execution::sequenced_policy, std::span<const quaternion> quaternions,
+                                  std::span<const double> weights) {
+    check_weights(quaternions, weights);
+    const auto s = accumulate(quaternions, weights, 0, quaternions.size());
+    merge(s.m, s.weight);
+}
+
+void q::rotation_accumulator::add(execution::parallel_policy policy, std::span<const quaternion> quaternions) {
+    const auto s = parallel_accumulate(policy, quaternions, {});
+    merge(s.m, s.weight);
+}
+
+void q::rotation_accumulator::add(execution::parallel_policy policy, std::span<const quaternion> quaternions,
+                                  std::span<const double> weights) {
+    check_weights(quaternions, weights);
+    const auto s = parallel_accumulate(policy, quaternions, weights);
+    merge(s.m, s.weight);
+}
+
+void q::rotation_accumulator::merge(const rotation_accumulator& other) {
+    merge(other.m, other.weight);
+}
+
+void q::rotation_accumulator::merge(const std::array<double, 10>& sums, double sum_of_weights) {
+    for (std::size_t k = 0; k < m.size(); ++k)
+        m[k] += sums[k];
+    weight += sum_of_weights;
+}
+
+double q::rotation_accumulator::total_weight() const {
+    return weight;
+}
+
+const std::array<double, 10>& q::rotation_accumulator::matrix() const {
+    return m;
+}
+
+std::optional<q::quaternion> q::rotation_accumulator::mean() const {
+    if (!(weight > 0) || std::all_of(m.begin(), m.end(), [](double e) { return e == 0; }))
+        return std::nullopt;
+    double a[4][4] = {
+        {m[0], m[1], m[2], m[3]},
+        {m[1], m[4], m[5], m[6]},
+        {m[2], m[5], m[7], m[8]},
+        {m[3], m[6], m[8], m[9]},
+    };
+    const auto v = dominant_eigenvector(a);
+    const auto mean = quaternion{v[0], v[1], v[2], v[3]}.normalized();
+    return mean.w < 0 ? -1.0 * mean : mean;
+}
+
+std::optional<q::quaternion> q::average(std::span<const quaternion> quaternions) {
+    auto accumulator = rotation_accumulator{};
+    accumulator.add(quaternions);
+    return accumulator.mean();
+}
+
+std::optional<q::quaternion> q::average(std::span<const quaternion> quaternions, std::span<const double> weights) {
+    auto accumulator = rotation_accumulator{};
+    accumulator.add(quaternions, weights);
+    return accumulator.mean();
+}
+
+std::optional<q::quaternion> q::average(execution::parallel_policy policy, std::span<const quaternion> quaternions) {
+    auto accumulator = rotation_accumulator{};
+    accumulator.add(policy, quaternions);
+    return accumulator.mean();
+}
+
+std::optional<q::quaternion> q::average(execution::parallel_policy policy, std::span<const quaternion> quaternions,
+                                        std::span<const double> weights) {
+    auto accumulator = rotation_accumulator{};
+    accumulator.add(policy, quaternions, weights);
+    return accumulator.mean();
+}
@@ -0,0 +1,67 @@
+#ifndef QUATERNIONS_AVERAGING_H
+#define QUATERNIONS_AVERAGING_H
+
+#include <array>
+#include <optional>
+#include <span>
+#include "execution.h"
+#include "quaternion.h"
+
+namespace quaternions {
+    /**
+     * Markley's rotation average: accumulates M = sum of w q q^T over weighted quaternions and
+     * takes the eigenvector of M with the largest eigenvalue, the rotation maximizing the sum of
+     * w (q . mean)². q and -q add the same outer product, so the average is unaffected by which
+     * of the two was measured. Quaternions are used as given, non-unit ones weigh with their
+     * squared length in addition to w.
+     *
+     * Accumulators can be fed in chunks as data streams in and merged, e.g. one per thread.
+     */
+    class rotation_accumulator {
+    public:
+        void add(const quaternion& q, double weight = 1);
+        /**
+         * Adds every quaternion with weight 1, respectively with its weight. weights must have
+         * the same size as quaternions. Weights must not be negative.
+         */
+        void add(std::span<const quaternion> quaternions);
+        void add(std::span<const quaternion> quaternions, std::span<const double> weights);
+        void add(execution::sequenced_policy, std::span<const quaternion> quaternions);
+        void add(execution::sequenced_policy, std::span<const quaternion> quaternions, std::span<const double> weights);
+        /**
+         * Accumulates on the executor of the policy, in blocks fixed by the number of rotations so
+         * that results depend on neither scheduling nor the executor
+         */
+        void add(execution::parallel_policy, std::span<const quaternion> quaternions);
+        void add(execution::parallel_policy, std::span<const quaternion> quaternions, std::span<const double> weights);
+        void merge(const rotation_accumulator& other);
+
+        double total_weight() const;
+        /**
+         * Upper triangle of M, row by row: m00, m01, m02, m03, m11, m12, m13, m22, m23, m33
+         * with indices 0 to 3 for w, x, y and z
+         */
+        const std::array<double, 10>& matrix() const;
+        /**
+         * Normalized average with w >= 0, or nothing if no weight was added
+         */
+        std::optional<quaternion> mean() const;
+
+    private:
+        void merge(const std::array<double, 10>& sums, double sum_of_weights);
+
+        std::array<double, 10> m{};
+        double weight = 0;
+    };
+
+    /**
+     * Markley average of quaternions, optionally weighted, or nothing for no weight at all
+     */
+    std::optional<quaternion> average(std::span<const quaternion> quaternions);
+    std::optional<quaternion> average(std::span<const quaternion> quaternions, std::span<const double> weights);
+    std::optional<quaternion> average(execution::parallel_policy, std::span<const quaternion> quaternions);
+    std::optional<quaternion> average(execution::parallel_policy, std::span<const quaternion> quaternions,
+                                      std::span<const double> weights);
+}
+
+#endif //QUATERNIONS_AVERAGING_H
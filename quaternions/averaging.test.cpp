@@ -0,0 +1,131 @@
+#include <catch2/catch_test_macros.hpp>
+#include <catch2/matchers/catch_matchers_floating_point.hpp>
+#include "averaging.h"
+#include "interpolation.h"
+#include "thread_pool.h"
+#include <cmath>
+#include <stdexcept>
+#include <vector>
+#include "../test/helpers.h"
+
+namespace q = quaternions;
+using Catch::Matchers::WithinAbs;
+
+namespace {
+    /**
+     * Unit quaternions scattered around r by up to about 0.1 rad, half of them with flipped sign
+     */
+    std::vector<q::quaternion> noisy_samples(const q::quaternion& r, std::size_t n, std::uint32_t seed) {
+        auto result = std::vector<q::quaternion>{};
+        for (const auto& v : random_vectors(n, seed)) {
+            const auto sample = r * q::quaternion::from_rotation({v.normalized(), 0.1 * v.length()});
+            result.push_back(result.size() % 2 ? -1.0 * sample : sample);
+        }
+        return result;
+    }
+
+    double objective(std::span<const q::quaternion> samples, const q::quaternion& mean) {
+        auto sum = 0.0;
+        for (const auto& s : samples)
+            sum += s.dot(mean) * s.dot(mean);
+        return sum;
+    }
+}
+
+TEST_CASE("the average of one rotation is that rotation with w >= 0")
+{
+    const auto r = q::quaternion::from_rotation({{0, 1, 0}, 1});
+    const auto one = std::vector<q::quaternion>{-1.0 * r};
+    CHECK_THAT(q::average(one).value(), WithinAbs(r, 1E-15));
+}
+
+TEST_CASE("averaging is unaffected by the double cover")
+{
+    const auto r = q::quaternion::from_rotation({q::xyz{1, -2, 0.5}.normalized(), 2});
+    const auto samples = noisy_samples(r, 10001, 1);
+    const auto mean = q::average(samples).value();
+    CHECK(std::abs(mean.dot(r)) > std::cos(0.005));
+
+    // adding up the quaternions mostly cancels them instead
+    auto sum = q::quaternion{0, 0, 0, 0};
+    for (const auto& s : samples)
+        sum = sum + s;
+    CHECK(std::abs(sum.normalized().dot(r)) < std::cos(0.1));
+
+    // the mean maximizes the sum of squared dot products
+    for (const auto& v : random_vectors(10, 2)) {
+        const auto nearby = mean * q::quaternion::from_rotation({v.normalized(), 1E-3});
+        CHECK(objective(samples, nearby) < objective(samples, mean));
+    }
+}
+
+TEST_CASE("weighted averages")
+{
+    const auto a = q::quaternion::from_rotation({{0, 0, 1}, 0});
+    const auto b = q::quaternion::from_rotation({{0, 0, 1}, 1.2});
+    const auto both = std::vector<q::quaternion>{a, b};
+    CHECK_THAT(q::average(both).value(), WithinAbs(q::slerp(a, b, 0.5), 1E-14));
+    const auto only_b = std::vector<double>{0, 2};
+    CHECK_THAT(q::average(both, only_b).value(), WithinAbs(b, 1E-14));
+
+    // a weight of 2 counts like adding the rotation twice
+    const auto weights = std::vector<double>{2, 1};
+    const auto repeated = std::vector<q::quaternion>{a, a, b};
+    CHECK_THAT(q::average(both, weights).value(), WithinAbs(q::average(repeated).value(), 1E-14));
+    const auto mean = q::average(both, weights).value();
+    CHECK(mean.dot(a) > mean.dot(b));
+}
+
+TEST_CASE("accumulators stream in chunks and merge")
+{
+    const auto samples = noisy_samples(q::quaternion{0.5, 0.5, -0.5, 0.5}, 3000, 3);
+    const auto weights = std::vector<double>(samples.size(), 0.5);
+    auto streamed = q::rotation_accumulator{};
+    auto other = q::rotation_accumulator{};
+    streamed.add(std::span(samples).first(1000));
+    for (std::size_t i = 1000; i < 2000; ++i)
+        streamed.add(samples[i]);
+    other.add(std::span(samples).last(1000), std::span(weights).last(1000));
+    streamed.merge(other);
+    CHECK_THAT(streamed.total_weight(), WithinAbs(2500, 1E-9));
+
+    const auto& m = streamed.matrix();
+    CHECK_THAT(m[0] + m[4] + m[7] + m[9], WithinAbs(2500, 1E-9));
+
+    auto whole = q::rotation_accumulator{};
+    auto all_weights = std::vector<double>(samples.size(), 1);
+    std::fill(all_weights.begin() + 2000, all_weights.end(), 0.5);
+    whole.add(samples, all_weights);
+    CHECK_THAT(streamed.mean().value(), WithinAbs(whole.mean().value(), 1E-12));
+}
+
+TEST_CASE("parallel averaging matches sequential averaging")
+{
+    const auto r = q::quaternion::from_rotation({{0, 1, 0}, -0.7});
+    const auto samples = noisy_samples(r, 300'001, 4);
+    auto weights = std::vector<double>{};
+    for (const auto& v : random_vectors(samples.size(), 5))
+        weights.push_back(1 + v.x);
+    CHECK_THAT(q::average(q::execution::par, samples).value(), WithinAbs(q::average(samples).value(), 1E-12));
+    CHECK_THAT(q::average(q::execution::par, samples, weights).value(),
+               WithinAbs(q::average(samples, weights).value(), 1E-12));
+    CHECK(std::abs(q::average(q::execution::par, samples).value().dot(r)) > std::cos(0.001));
+
+    // the same blocks on every executor
+    auto one = q::thread_pool(1);
+    auto three = q::thread_pool(3);
+    const auto shared = q::average(q::execution::par, samples, weights).value();
+    CHECK(q::average(q::execution::par.on(one), samples, weights).value() == shared);
+    CHECK(q::average(q::execution::par.on(three), samples, weights).value() == shared);
+}
+
+TEST_CASE("averaging nothing and bad weights")
+{
+    CHECK(q::average(std::vector<q::quaternion>{}) == std::nullopt);
+    CHECK(q::rotation_accumulator{}.mean() == std::nullopt);
+    const auto samples = std::vector<q::quaternion>{{1, 0, 0, 0}, {0, 1, 0, 0}};
+    CHECK(q::average(samples, std::vector<double>{0, 0}) == std::nullopt);
+    CHECK_THROWS_AS(q::average(samples, std::vector<double>{1}), std::domain_error);
+    CHECK_THROWS_AS(q::average(samples, std::vector<double>{1, -1}), std::domain_error);
+    CHECK_THROWS_AS(q::average(q::execution::par, samples, std::vector<double>{1}), std::domain_error);
+}
@@ -0,0 +1,662 @@
+#ifndef QUATERNIONS_BATCH_KERNELS_H
+#define QUATERNIONS_BATCH_KERNELS_H
+
+#include <cstddef>
+#include "dispatch.h"
+#include "exponential.h"
+#include "simd.h"
+#include "swing_twist.h"
+#include "trigonometry.h"
+
+namespace quaternions::kernels {
+    namespace {
+        /**
+         * Calls step(S{}, i) for every full vector register and step(simd::scalar{}, i) for the tail.
+         */
+        template<typename S, typename Step>
+        void for_each_pack(std::size_t n, Step step) {
+            std::size_t i = 0;
+            for (; i + S::width <= n; i += S::width)
+                step(S{}, i);
+            for (; i < n; ++i)
+                step(simd::scalar{}, i);
+        }
+
+        template<typename V>
+        struct pack {
+            typename V::reg w;
+            typename V::reg x;
+            typename V::reg y;
+            typename V::reg z;
+        };
+
+        template<typename V>
+        pack<V> load(soa_in q, std::size_t i) {
+            return {V::load(q.w + i), V::load(q.x + i), V::load(q.y + i), V::load(q.z + i)};
+        }
+
+        template<typename V>
+        void store(soa_out q, std::size_t i, const pack<V>& p) {
+            V::store(q.w + i, p.w);
+            V::store(q.x + i, p.x);
+            V::store(q.y + i, p.y);
+            V::store(q.z + i, p.z);
+        }
+
+        template<typename V>
+        pack<V> product(const pack<V>& a, const pack<V>& b) {
+            return {
+                V::fnmadd(a.z, b.z, V::fnmadd(a.y, b.y, V::fnmadd(a.x, b.x, V::mul(a.w, b.w)))),
+                V::fnmadd(a.z, b.y, V::fmadd(a.y, b.z, V::fmadd(a.x, b.w, V::mul(a.w, b.x)))),
+                V::fmadd(a.z, b.x, V::fmadd(a.y, b.w, V::fnmadd(a.x, b.z, V::mul(a.w, b.y)))),
+                V::fmadd(a.z, b.w, V::fnmadd(a.y, b.x, V::fmadd(a.x, b.y, V::mul(a.w, b.z)))),
+            };
+        }
+
+        template<typename S>
+        void multiply(soa_in a, soa_in b, soa_out out, std::size_t n) {
+            for_each_pack<S>(n, [=]<typename V>(V, std::size_t i) {
+                store<V>(out, i, product<V>(load<V>(a, i), load<V>(b, i)));
+            });
+        }
+
+        template<typename S>
+        void add(soa_in a, soa_in b, soa_out out, std::size_t n) {
+            for_each_pack<S>(n, [=]<typename V>(V, std::size_t i) {
+                const auto pa = load<V>(a, i);
+                const auto pb = load<V>(b, i);
+                store<V>(out, i, {V::add(pa.w, pb.w), V::add(pa.x, pb.x), V::add(pa.y, pb.y), V::add(pa.z, pb.z)});
+            });
+        }
+
+        template<typename S>
+        void subtract(soa_in a, soa_in b, soa_out out, std::size_t n) {
+            for_each_pack<S>(n, [=]<typename V>(V, std::size_t i) {
+                const auto pa = load<V>(a, i);
+                const auto pb = load<V>(b, i);
+                store<V>(out, i, {V::sub(pa.w, pb.w), V::sub(pa.x, pb.x), V::sub(pa.y, pb.y), V::sub(pa.z, pb.z)});
+            });
+        }
+
+        template<typename S>
+        void scale(soa_in a, double s, soa_out out, std::size_t n) {
+            for_each_pack<S>(n, [=]<typename V>(V, std::size_t i) {
+                const auto p = load<V>(a, i);
+                const auto vs = V::broadcast(s);
+                store<V>(out, i, {V::mul(p.w, vs), V::mul(p.x, vs), V::mul(p.y, vs), V::mul(p.z, vs)});
+            });
+        }
+
+        template<typename S>
+        void conjugate(soa_in a, soa_out out, std::size_t n) {
+            for_each_pack<S>(n, [=]<typename V>(V, std::size_t i) {
+                const auto p = load<V>(a, i);
+                store<V>(out, i, {p.w, V::neg(p.x), V::neg(p.y), V::neg(p.z)});
+            });
+        }
+
+        template<typename S>
+        void normalize(soa_in a, soa_out out, std::size_t n) {
+            for_each_pack<S>(n, [=]<typename V>(V, std::size_t i) {
+                const auto p = load<V>(a, i);
+                const auto length = V::sqrt(V::fmadd(p.z, p.z, V::fmadd(p.y, p.y, V::fmadd(p.x, p.x, V::mul(p.w, p.w)))));
+                store<V>(out, i, {V::div(p.w, length), V::div(p.x, length), V::div(p.y, length), V::div(p.z, length)});
+            });
+        }
+
+        template<typename S>
+        void rotate(soa_in q, soa_in r, soa_out out, std::size_t n) {
+            // sandwich() of quaternion.h
+            for_each_pack<S>(n, [=]<typename V>(V, std::size_t i) {
+                const auto [w, ux, uy, uz] = load<V>(r, i);
+                const auto [s, vx, vy, vz] = load<V>(q, i);
+                const auto ww = V::mul(w, w);
+                const auto uu = V::fmadd(uz, uz, V::fmadd(uy, uy, V::mul(ux, ux)));
+                const auto a = V::sub(ww, uu);
+                const auto two = V::broadcast(2.0);
+                const auto uv2 = V::mul(two, V::fmadd(uz, vz, V::fmadd(uy, vy, V::mul(ux, vx))));
+                const auto w2 = V::mul(two, w);
+                const auto cx = V::fnmadd(uz, vy, V::mul(uy, vz));
+                const auto cy = V::fnmadd(ux, vz, V::mul(uz, vx));
+                const auto cz = V::fnmadd(uy, vx, V::mul(ux, vy));
+                store<V>(out, i, {
+                    V::mul(s, V::add(ww, uu)),
+                    V::fmadd(w2, cx, V::fmadd(uv2, ux, V::mul(a, vx))),
+                    V::fmadd(w2, cy, V::fmadd(uv2, uy, V::mul(a, vy))),
+                    V::fmadd(w2, cz, V::fmadd(uv2, uz, V::mul(a, vz))),
+                });
+            });
+        }
+
+        /**
+         * products() of products.h: the real parts ab ∓ u·v and the vector parts a v ± b u and u × v
+         * are computed once and combined into the requested products
+         */
+        template<typename S>
+        void products(soa_in p, soa_in q, const soa_products& out, std::size_t n) {
+            for_each_pack<S>(n, [=, &out]<typename V>(V, std::size_t i) {
+                const auto [a, ux, uy, uz] = load<V>(p, i);
+                const auto [b, vx, vy, vz] = load<V>(q, i);
+                const auto zero = V::broadcast(0.0);
+                const auto ab = V::mul(a, b);
+                const auto uv = V::fmadd(uz, vz, V::fmadd(uy, vy, V::mul(ux, vx)));
+                const auto cx = V::fnmadd(uz, vy, V::mul(uy, vz));
+                const auto cy = V::fnmadd(ux, vz, V::mul(uz, vx));
+                const auto cz = V::fnmadd(uy, vx, V::mul(ux, vy));
+                const auto avx = V::mul(a, vx);
+                const auto avy = V::mul(a, vy);
+                const auto avz = V::mul(a, vz);
+                if (out.grassmann.w || out.grassmann_even.w) {
+                    const auto sx = V::fmadd(b, ux, avx);
+                    const auto sy = V::fmadd(b, uy, avy);
+                    const auto sz = V::fmadd(b, uz, avz);
+                    const auto real = V::sub(ab, uv);
+                    if (out.grassmann.w)
+                        store<V>(out.grassmann, i, {real, V::add(sx, cx), V::add(sy, cy), V::add(sz, cz)});
+                    if (out.grassmann_even.w)
+                        store<V>(out.grassmann_even, i, {real, sx, sy, sz});
+                }
+                if (out.grassmann_odd.w)
+                    store<V>(out.grassmann_odd, i, {zero, cx, cy, cz});
+                if (out.euclidean.w || out.euclidean_odd.w) {
+                    const auto dx = V::sub(V::fnmadd(b, ux, avx), cx);
+                    const auto dy = V::sub(V::fnmadd(b, uy, avy), cy);
+                    const auto dz = V::sub(V::fnmadd(b, uz, avz), cz);
+                    if (out.euclidean.w)
+                        store<V>(out.euclidean, i, {V::add(ab, uv), dx, dy, dz});
+                    if (out.euclidean_odd.w)
+                        store<V>(out.euclidean_odd, i, {zero, dx, dy, dz});
+                }
+                if (out.euclidean_even)
+                    V::store(out.euclidean_even + i, V::add(ab, uv));
+            });
+        }
+
+        template<typename S, typename E>
+        void to_matrix(soa_in q, const matrix_layout& layout, E* out, std::size_t n) {
+            for_each_pack<S>(n, [=, &layout]<typename V>(V, std::size_t i) {
+                const auto [w, x, y, z] = load<V>(q, i);
+                const auto one = V::broadcast(1.0);
+                const auto two = V::broadcast(2.0);
+                const auto xx = V::mul(x, x), yy = V::mul(y, y), zz = V::mul(z, z);
+                const auto xy = V::mul(x, y), xz = V::mul(x, z), yz = V::mul(y, z);
+                const auto xw = V::mul(x, w), yw = V::mul(y, w), zw = V::mul(z, w);
+                const typename V::reg columns[9] = {
+                    V::fnmadd(two, V::add(yy, zz), one), V::mul(two, V::add(xy, zw)), V::mul(two, V::sub(xz, yw)),
+                    V::mul(two, V::sub(xy, zw)), V::fnmadd(two, V::add(xx, zz), one), V::mul(two, V::add(yz, xw)),
+                    V::mul(two, V::add(xz, yw)), V::mul(two, V::sub(yz, xw)), V::fnmadd(two, V::add(xx, yy), one),
+                };
+                alignas(64) double lanes[9][V::width];
+                for (std::size_t k = 0; k < 9; ++k)
+                    V::store(lanes[k], columns[k]);
+                for (std::size_t lane = 0; lane < V::width; ++lane) {
+                    const auto matrix = out + (i + lane) * layout.stride;
+                    for (std::size_t k = 0; k < 9; ++k)
+                        matrix[layout.offsets[k]] = static_cast<E>(lanes[k][lane]);
+                    for (std::size_t k = 0; k < layout.padding_count; ++k)
+                        matrix[layout.padding[k]] = E(0);
+                }
+            });
+        }
+
+        /**
+         * Shepperd's method without branches: the quaternion is computed from the largest of
+         * 4w², 4x², 4y² and 4z², which are read off the diagonal, so the square root and the
+         * division never see a small value
+         */
+        template<typename S, typename E>
+        void from_matrix(const E* in, const matrix_layout& layout, soa_out out, std::size_t n) {
+            for_each_pack<S>(n, [=, &layout]<typename V>(V, std::size_t i) {
+                alignas(64) double lanes[9][V::width];
+                for (std::size_t lane = 0; lane < V::width; ++lane) {
+                    const auto matrix = in + (i + lane) * layout.stride;
+                    for (std::size_t k = 0; k < 9; ++k)
+                        lanes[k][lane] = static_cast<double>(matrix[layout.offsets[k]]);
+                }
+                // m[c][r] is row r of column c
+                typename V::reg m[3][3];
+                for (std::size_t k = 0; k < 9; ++k)
+                    m[k / 3][k % 3] = V::load(lanes[k]);
+
+                const auto one = V::broadcast(1.0);
+                const auto two = V::broadcast(2.0);
+                const auto trace = V::add(V::add(m[0][0], m[1][1]), m[2][2]);
+                // 4w², 4x², 4y², 4z²
+                const auto dw = V::add(one, trace);
+                const auto dx = V::fmadd(two, m[0][0], V::sub(one, trace));
+                const auto dy = V::fmadd(two, m[1][1], V::sub(one, trace));
+                const auto dz = V::fmadd(two, m[2][2], V::sub(one, trace));
+                // 4xw, 4yw, 4zw, 4xy, 4xz, 4yz
+                const auto xw = V::sub(m[1][2], m[2][1]);
+                const auto yw = V::sub(m[2][0], m[0][2]);
+                const auto zw = V::sub(m[0][1], m[1][0]);
+                const auto xy = V::add(m[1][0], m[0][1]);
+                const auto xz = V::add(m[2][0], m[0][2]);
+                const auto yz = V::add(m[2][1], m[1][2]);
+
+                // 4 * largest component * (w, x, y, z)
+                auto largest = dw;
+                auto p = pack<V>{dw, xw, yw, zw};
+                const auto take = [&](typename V::reg d, const pack<V>& candidate) {
+                    p = {
+                        V::select_greater(d, largest, candidate.w, p.w),
+                        V::select_greater(d, largest, candidate.x, p.x),
+                        V::select_greater(d, largest, candidate.y, p.y),
+                        V::select_greater(d, largest, candidate.z, p.z),
+                    };
+                    largest = V::select_greater(d, largest, d, largest);
+                };
+                take(dx, {xw, dx, xy, xz});
+                take(dy, {yw, xy, dy, yz});
+                take(dz, {zw, xz, yz, dz});
+
+                const auto f = V::div(V::broadcast(0.5), V::sqrt(largest));
+                store<V>(out, i, {V::mul(p.w, f), V::mul(p.x, f), V::mul(p.y, f), V::mul(p.z, f)});
+            });
+        }
+
+        template<typename S>
+        void blend(soa_in a, soa_in b, const double* wa, const double* wb, soa_out out, std::size_t n) {
+            for_each_pack<S>(n, [=]<typename V>(V, std::size_t i) {
+                const auto pa = load<V>(a, i);
+                const auto pb = load<V>(b, i);
+                const auto va = V::load(wa + i);
+                const auto vb = V::load(wb + i);
+                const auto w = V::fmadd(pb.w, vb, V::mul(pa.w, va));
+                const auto x = V::fmadd(pb.x, vb, V::mul(pa.x, va));
+                const auto y = V::fmadd(pb.y, vb, V::mul(pa.y, va));
+                const auto z = V::fmadd(pb.z, vb, V::mul(pa.z, va));
+                const auto length = V::sqrt(V::fmadd(z, z, V::fmadd(y, y, V::fmadd(x, x, V::mul(w, w)))));
+                store<V>(out, i, {V::div(w, length), V::div(x, length), V::div(y, length), V::div(z, length)});
+            });
+        }
+
+        template<typename V, std::size_t N>
+        typename V::reg polynomial(const double (&coefficients)[N], typename V::reg x) {
+            auto result = V::broadcast(coefficients[0]);
+            for (std::size_t i = 1; i < N; ++i)
+                result = V::fmadd(result, x, V::broadcast(coefficients[i]));
+            return result;
+        }
+
+        template<typename S>
+        void sincos(const double* x, double* sin, double* cos, std::size_t n) {
+            namespace c = fast::constants;
+            for_each_pack<S>(n, [=]<typename V>(V, std::size_t i) {
+                // same steps as fast::sincos, with the quadrant picked by selects
+                const auto round = V::broadcast(1.5 * 4503599627370496.0);
+                const auto xi = V::load(x + i);
+                const auto k = V::sub(V::fmadd(xi, V::broadcast(c::two_over_pi), round), round);
+                const auto r = V::fnmadd(k, V::broadcast(c::pi_over_2_low),
+                                         V::fnmadd(k, V::broadcast(c::pi_over_2_high), xi));
+                const auto r2 = V::mul(r, r);
+                const auto s = V::mul(r, polynomial<V>(c::sin, r2));
+                const auto co = polynomial<V>(c::cos, r2);
+
+                // k mod 4 as one of -2, -1, 0, 1, 2
+                const auto m = V::fnmadd(V::broadcast(4.0), V::sub(V::fmadd(k, V::broadcast(0.25), round), round), k);
+                const auto m2 = V::mul(m, m);
+                const auto zero = V::broadcast(0.0);
+                const auto half = V::broadcast(0.5);
+                const auto two = V::broadcast(2.0);
+                const auto odd_sin = V::select_greater(m, zero, co, V::neg(co));
+                const auto odd_cos = V::select_greater(m, zero, V::neg(s), s);
+                V::store(sin + i, V::select_greater(m2, two, V::neg(s), V::select_greater(m2, half, odd_sin, s)));
+                V::store(cos + i, V::select_greater(m2, two, V::neg(co), V::select_greater(m2, half, odd_cos, co)));
+            });
+        }
+
+        /**
+         * sin(x) / x for 0 <= x <= pi / 2, exact to rounding: the exponential polynomial up to
+         * exponential::max_angle and cos(pi / 2 - x) / x above
+         */
+        template<typename V>
+        typename V::reg sinc(typename V::reg x) {
+            const auto r = V::sub(V::broadcast(M_PI_2), x);
+            const auto near = polynomial<V>(exponential::sin, V::mul(x, x));
+            const auto far = V::div(polynomial<V>(exponential::cos, V::mul(r, r)), x);
+            return V::select_greater(x, V::broadcast(exponential::max_angle), far, near);
+        }
+
+        template<typename S>
+        void slerp_weights(const double* t, const double* angle, double* wa, double* wb, std::size_t n) {
+            for_each_pack<S>(n, [=]<typename V>(V, std::size_t i) {
+                // sin(k angle) / sin(angle) = k sinc(k angle) / sinc(angle) stays accurate down to angle = 0
+                const auto ti = V::load(t + i);
+                const auto ai = V::load(angle + i);
+                const auto s = V::sub(V::broadcast(1.0), ti);
+                const auto sinc_angle = sinc<V>(ai);
+                V::store(wa + i, V::div(V::mul(s, sinc<V>(V::mul(s, ai))), sinc_angle));
+                V::store(wb + i, V::div(V::mul(ti, sinc<V>(V::mul(ti, ai))), sinc_angle));
+            });
+        }
+
+        template<typename S>
+        void acos(const double* x, double* out, std::size_t n) {
+            for_each_pack<S>(n, [=]<typename V>(V, std::size_t i) {
+                const auto xi = V::load(x + i);
+                const auto zero = V::broadcast(0.0);
+                const auto a = V::select_greater(xi, zero, xi, V::neg(xi));
+                const auto result = V::mul(V::sqrt(V::sub(V::broadcast(1.0), a)), polynomial<V>(fast::constants::acos, a));
+                V::store(out + i, V::select_greater(zero, xi, V::sub(V::broadcast(M_PI), result), result));
+            });
+        }
+
+        template<typename S>
+        void abs_dots(const double* q, soa_in b, double* out, std::size_t n) {
+            for_each_pack<S>(n, [=]<typename V>(V, std::size_t i) {
+                const auto p = load<V>(b, i);
+                const auto dot = V::fmadd(V::broadcast(q[3]), p.z, V::fmadd(V::broadcast(q[2]), p.y,
+                                          V::fmadd(V::broadcast(q[1]), p.x, V::mul(V::broadcast(q[0]), p.w))));
+                const auto one = V::broadcast(1.0);
+                const auto magnitude = V::select_greater(dot, V::broadcast(0.0), dot, V::neg(dot));
+                V::store(out + i, V::select_greater(magnitude, one, one, magnitude));
+            });
+        }
+
+        template<typename S>
+        void transform_points(const double* m, const double* in, double* out, std::size_t n) {
+            // interleaved points would need shuffles into vector registers that cost more than they
+            // save, so this stays a loop of scalar fused multiply-adds on every instruction set level
+            using V = simd::scalar;
+            for (std::size_t i = 0; i < 3 * n; i += 3) {
+                const auto x = in[i], y = in[i + 1], z = in[i + 2];
+                out[i] = V::fmadd(m[6], z, V::fmadd(m[3], y, V::mul(m[0], x)));
+                out[i + 1] = V::fmadd(m[7], z, V::fmadd(m[4], y, V::mul(m[1], x)));
+                out[i + 2] = V::fmadd(m[8], z, V::fmadd(m[5], y, V::mul(m[2], x)));
+            }
+        }
+
+        template<typename V>
+        struct vectors {
+            typename V::reg x;
+            typename V::reg y;
+            typename V::reg z;
+        };
+
+        /**
+         * Vectors i to i + V::width of interleaved (x, y, z) triples
+         */
+        template<typename V>
+        vectors<V> load_interleaved(const double* p, std::size_t i) {
+            alignas(64) double lanes[3][V::width];
+            for (std::size_t lane = 0; lane < V::width; ++lane)
+                for (std::size_t k = 0; k < 3; ++k)
+                    lanes[k][lane] = p[3 * (i + lane) + k];
+            return {V::load(lanes[0]), V::load(lanes[1]), V::load(lanes[2])};
+        }
+
+        template<typename V>
+        typename V::reg squared_length(const vectors<V>& v) {
+            return V::fmadd(v.z, v.z, V::fmadd(v.y, v.y, V::mul(v.x, v.x)));
+        }
+
+        /**
+         * v normalized, zero vectors stay zero
+         */
+        template<typename V>
+        vectors<V> unit(const vectors<V>& v) {
+            const auto length2 = squared_length<V>(v);
+            const auto zero = V::broadcast(0.0);
+            const auto f = V::select_greater(length2, zero, V::div(V::broadcast(1.0), V::sqrt(length2)), zero);
+            return {V::mul(v.x, f), V::mul(v.y, f), V::mul(v.z, f)};
+        }
+
+        template<typename V>
+        vectors<V> cross(const vectors<V>& a, const vectors<V>& b) {
+            return {
+                V::fnmadd(a.z, b.y, V::mul(a.y, b.z)),
+                V::fnmadd(a.x, b.z, V::mul(a.z, b.x)),
+                V::fnmadd(a.y, b.x, V::mul(a.x, b.y)),
+            };
+        }
+
+        /**
+         * Directions of gravity and of the earth's magnetic field in the sensor frame predicted by
+         * the orientation q, which turns sensor into earth coordinates. The field is taken as
+         * (bx, 0, bz) with bx and bz fitted to the measured direction m, as Madgwick and Mahony do.
+         */
+        template<typename V>
+        struct references {
+            vectors<V> gravity;
+            vectors<V> field;
+            typename V::reg bx;
+            typename V::reg bz;
+        };
+
+        template<typename V>
+        references<V> predicted_references(const pack<V>& q, const vectors<V>& m) {
+            const auto [q0, q1, q2, q3] = q;
+            const auto one = V::broadcast(1.0);
+            const auto two = V::broadcast(2.0);
+            // rows of the rotation matrix of q
+            const auto r0 = vectors<V>{
+                V::fnmadd(two, V::fmadd(q3, q3, V::mul(q2, q2)), one),
+                V::mul(two, V::fnmadd(q0, q3, V::mul(q1, q2))),
+                V::mul(two, V::fmadd(q0, q2, V::mul(q1, q3))),
+            };
+            const auto r1 = vectors<V>{
+                V::mul(two, V::fmadd(q0, q3, V::mul(q1, q2))),
+                V::fnmadd(two, V::fmadd(q3, q3, V::mul(q1, q1)), one),
+                V::mul(two, V::fnmadd(q0, q1, V::mul(q2, q3))),
+            };
+            const auto r2 = vectors<V>{
+                V::mul(two, V::fnmadd(q0, q2, V::mul(q1, q3))),
+                V::mul(two, V::fmadd(q0, q1, V::mul(q2, q3))),
+                V::fnmadd(two, V::fmadd(q2, q2, V::mul(q1, q1)), one),
+            };
+            // the measured field in earth coordinates
+            const auto hx = V::fmadd(r0.z, m.z, V::fmadd(r0.y, m.y, V::mul(r0.x, m.x)));
+            const auto hy = V::fmadd(r1.z, m.z, V::fmadd(r1.y, m.y, V::mul(r1.x, m.x)));
+            const auto bz = V::fmadd(r2.z, m.z, V::fmadd(r2.y, m.y, V::mul(r2.x, m.x)));
+            const auto bx = V::sqrt(V::fmadd(hy, hy, V::mul(hx, hx)));
+            return {
+                r2,
+                {V::fmadd(bz, r2.x, V::mul(bx, r0.x)), V::fmadd(bz, r2.y, V::mul(bx, r0.y)), V::fmadd(bz, r2.z, V::mul(bx, r0.z))},
+                bx,
+                bz,
+            };
+        }
+
+        /**
+         * q + dt (q * (0, g) / 2 - step), normalized
+         */
+        template<typename V>
+        pack<V> advance(const pack<V>& q, const vectors<V>& g, const pack<V>& step, double dt) {
+            const auto zero = V::broadcast(0.0);
+            const auto rate = product<V>(q, {zero, g.x, g.y, g.z});
+            const auto h = V::broadcast(0.5 * dt);
+            const auto d = V::broadcast(dt);
+            const auto w = V::fnmadd(d, step.w, V::fmadd(h, rate.w, q.w));
+            const auto x = V::fnmadd(d, step.x, V::fmadd(h, rate.x, q.x));
+            const auto y = V::fnmadd(d, step.y, V::fmadd(h, rate.y, q.y));
+            const auto z = V::fnmadd(d, step.z, V::fmadd(h, rate.z, q.z));
+            const auto f = V::div(V::broadcast(1.0), V::sqrt(V::fmadd(z, z, V::fmadd(y, y, V::fmadd(x, x, V::mul(w, w))))));
+            return {V::mul(w, f), V::mul(x, f), V::mul(y, f), V::mul(z, f)};
+        }
+
+        /**
+         * Madgwick's filter: a gradient descent step of length beta towards the orientation that
+         * predicts the measured directions, on top of integrating the rates
+         */
+        template<typename S>
+        void madgwick(soa_out q, imu_readings readings, double dt, double beta, std::size_t n) {
+            for_each_pack<S>(n, [=]<typename V>(V, std::size_t i) {
+                const auto p = load<V>(soa_in{q.w, q.x, q.y, q.z}, i);
+                const auto [q0, q1, q2, q3] = p;
+                const auto zero = V::broadcast(0.0);
+                const auto two = V::broadcast(2.0);
+                const auto four = V::broadcast(4.0);
+                const auto accelerometer = load_interleaved<V>(readings.accelerometer, i);
+                const auto a = unit<V>(accelerometer);
+                const auto m = readings.magnetometer
+                    ? unit<V>(load_interleaved<V>(readings.magnetometer, i)) : vectors<V>{zero, zero, zero};
+                const auto predicted = predicted_references<V>(p, m);
+
+                // gradient J^T f of the errors f = predicted - measured
+                const auto f1 = V::sub(predicted.gravity.x, a.x);
+                const auto f2 = V::sub(predicted.gravity.y, a.y);
+                const auto f3 = V::sub(predicted.gravity.z, a.z);
+                auto s0 = V::mul(two, V::fnmadd(q2, f1, V::mul(q1, f2)));
+                auto s1 = V::fnmadd(V::mul(four, q1), f3, V::mul(two, V::fmadd(q3, f1, V::mul(q0, f2))));
+                auto s2 = V::fnmadd(V::mul(four, q2), f3, V::mul(two, V::fnmadd(q0, f1, V::mul(q3, f2))));
+                auto s3 = V::mul(two, V::fmadd(q1, f1, V::mul(q2, f2)));
+                if (readings.magnetometer) {
+                    const auto f4 = V::sub(predicted.field.x, m.x);
+                    const auto f5 = V::sub(predicted.field.y, m.y);
+                    const auto f6 = V::sub(predicted.field.z, m.z);
+                    const auto bx2 = V::mul(two, predicted.bx);
+                    const auto bz2 = V::mul(two, predicted.bz);
+                    const auto bx4 = V::mul(two, bx2);
+                    const auto bz4 = V::mul(two, bz2);
+                    s0 = V::fmadd(V::mul(bx2, q2), f6, V::fmadd(V::fnmadd(bx2, q3, V::mul(bz2, q1)), f5,
+                                                                V::fnmadd(V::mul(bz2, q2), f4, s0)));
+                    s1 = V::fmadd(V::fnmadd(bz4, q1, V::mul(bx2, q3)), f6, V::fmadd(V::fmadd(bx2, q2, V::mul(bz2, q0)), f5,
+                                                                                   V::fmadd(V::mul(bz2, q3), f4, s1)));
+                    s2 = V::fmadd(V::fnmadd(bz4, q2, V::mul(bx2, q0)), f6, V::fmadd(V::fmadd(bx2, q1, V::mul(bz2, q3)), f5,
+                                                                                   V::fnmadd(V::fmadd(bx4, q2, V::mul(bz2, q0)), f4, s2)));
+                    s3 = V::fmadd(V::mul(bx2, q1), f6, V::fmadd(V::fnmadd(bx2, q0, V::mul(bz2, q2)), f5,
+                                                                V::fmadd(V::fnmadd(bx4, q3, V::mul(bz2, q1)), f4, s3)));
+                }
+
+                // no correction without an accelerometer reading or once the gradient vanishes
+                const auto s_length2 = V::fmadd(s3, s3, V::fmadd(s2, s2, V::fmadd(s1, s1, V::mul(s0, s0))));
+                const auto valid = V::select_greater(squared_length<V>(accelerometer), zero, s_length2, zero);
+                const auto f = V::select_greater(valid, zero, V::div(V::broadcast(beta), V::sqrt(s_length2)), zero);
+                const auto step = pack<V>{V::mul(s0, f), V::mul(s1, f), V::mul(s2, f), V::mul(s3, f)};
+                store<V>(q, i, advance<V>(p, load_interleaved<V>(readings.gyroscope, i), step, dt));
+            });
+        }
+
+        /**
+         * Mahony's filter: the rates are corrected by kp times the cross product of the measured
+         * and predicted directions plus ki times its integral
+         */
+        template<typename S>
+        void mahony(soa_out q, soa_vectors integral, imu_readings readings, double dt, double kp, double ki,
+                    std::size_t n) {
+            for_each_pack<S>(n, [=]<typename V>(V, std::size_t i) {
+                const auto p = load<V>(soa_in{q.w, q.x, q.y, q.z}, i);
+                const auto zero = V::broadcast(0.0);
+                const auto a = unit<V>(load_interleaved<V>(readings.accelerometer, i));
+                const auto m = readings.magnetometer
+                    ? unit<V>(load_interleaved<V>(readings.magnetometer, i)) : vectors<V>{zero, zero, zero};
+                const auto predicted = predicted_references<V>(p, m);
+                auto e = cross<V>(a, predicted.gravity);
+                if (readings.magnetometer) {
+                    const auto em = cross<V>(m, predicted.field);
+                    e = {V::add(e.x, em.x), V::add(e.y, em.y), V::add(e.z, em.z)};
+                }
+
+                auto g = load_interleaved<V>(readings.gyroscope, i);
+                const auto vkp = V::broadcast(kp);
+                g = {V::fmadd(vkp, e.x, g.x), V::fmadd(vkp, e.y, g.y), V::fmadd(vkp, e.z, g.z)};
+                if (ki > 0) {
+                    const auto k = V::broadcast(ki * dt);
+                    const auto ix = V::fmadd(k, e.x, V::load(integral.x + i));
+                    const auto iy = V::fmadd(k, e.y, V::load(integral.y + i));
+                    const auto iz = V::fmadd(k, e.z, V::load(integral.z + i));
+                    V::store(integral.x + i, ix);
+                    V::store(integral.y + i, iy);
+                    V::store(integral.z + i, iz);
+                    g = {V::add(g.x, ix), V::add(g.y, iy), V::add(g.z, iz)};
+                }
+                store<V>(q, i, advance<V>(p, g, {zero, zero, zero, zero}, dt));
+            });
+        }
+
+        template<typename S>
+        void integrate(soa_out q, const double* rates, double half_dt, std::size_t n) {
+            for_each_pack<S>(n, [=]<typename V>(V, std::size_t i) {
+                const auto rate = load_interleaved<V>(rates, i);
+                const auto h = V::broadcast(half_dt);
+                const auto x = V::mul(rate.x, h);
+                const auto y = V::mul(rate.y, h);
+                const auto z = V::mul(rate.z, h);
+                const auto angle2 = V::fmadd(z, z, V::fmadd(y, y, V::mul(x, x)));
+                const auto sinc = polynomial<V>(exponential::sin, angle2);
+                const auto step = pack<V>{
+                    polynomial<V>(exponential::cos, angle2), V::mul(x, sinc), V::mul(y, sinc), V::mul(z, sinc)
+                };
+                const auto current = load<V>(soa_in{q.w, q.x, q.y, q.z}, i);
+                store<V>(q, i, product<V>(current, step));
+            });
+        }
+
+        /**
+         * clamped() of swing_twist.h: q is turned to w >= 0 and split into swing and twist, the sine
+         * of the half twist angle is clamped between those of the limits, a swing beyond the cone is
+         * scaled back onto it, and their product is turned back
+         */
+        template<typename S>
+        void clamp_joints(soa_out q, soa_limits limits, std::size_t n) {
+            for_each_pack<S>(n, [=]<typename V>(V, std::size_t i) {
+                const auto zero = V::broadcast(0.0);
+                const auto one = V::broadcast(1.0);
+                const auto in = load<V>(soa_in{q.w, q.x, q.y, q.z}, i);
+                const auto sign = V::select_greater(zero, in.w, V::neg(one), one);
+                const auto p = pack<V>{V::mul(in.w, sign), V::mul(in.x, sign), V::mul(in.y, sign), V::mul(in.z, sign)};
+                const auto ax = V::load(limits.axis_x + i);
+                const auto ay = V::load(limits.axis_y + i);
+                const auto az = V::load(limits.axis_z + i);
+
+                // twist (tw, ts axis), the identity where it is not determined
+                const auto projection = V::fmadd(p.z, az, V::fmadd(p.y, ay, V::mul(p.x, ax)));
+                const auto length = V::sqrt(V::fmadd(projection, projection, V::mul(p.w, p.w)));
+                const auto degenerate = V::broadcast(twist::degenerate);
+                const auto inverse = V::select_greater(length, degenerate, V::div(one, length), zero);
+                const auto tw = V::select_greater(length, degenerate, V::mul(p.w, inverse), one);
+                const auto ts = V::mul(projection, inverse);
+                const auto swing = product<V>(p, {tw, V::neg(V::mul(ts, ax)), V::neg(V::mul(ts, ay)), V::neg(V::mul(ts, az))});
+
+                const auto low = V::load(limits.sin_half_min_twist + i);
+                const auto high = V::load(limits.sin_half_max_twist + i);
+                const auto s = V::select_greater(ts, high, high, V::select_greater(low, ts, low, ts));
+                const auto twist = pack<V>{V::sqrt(V::fnmadd(s, s, one)), V::mul(s, ax), V::mul(s, ay), V::mul(s, az)};
+
+                const auto c = V::load(limits.cos_half_swing + i);
+                const auto swing_length = V::sqrt(V::fmadd(swing.z, swing.z, V::fmadd(swing.y, swing.y, V::mul(swing.x, swing.x))));
+                const auto onto_cone = V::select_greater(swing_length, zero,
+                                                         V::div(V::load(limits.sin_half_swing + i), swing_length), zero);
+                const auto f = V::select_greater(c, swing.w, onto_cone, one);
+                const auto limited = pack<V>{
+                    V::select_greater(c, swing.w, c, swing.w), V::mul(swing.x, f), V::mul(swing.y, f), V::mul(swing.z, f)
+                };
+
+                const auto r = product<V>(limited, twist);
+                store<V>(q, i, {V::mul(r.w, sign), V::mul(r.x, sign), V::mul(r.y, sign), V::mul(r.z, sign)});
+            });
+        }
+
+        template<typename S>
+        constexpr table make_table(isa level) {
+            return table{
+                level,
+                &add<S>,
+                &subtract<S>,
+                &multiply<S>,
+                &scale<S>,
+                &conjugate<S>,
+                &normalize<S>,
+                &rotate<S>,
+                &to_matrix<S, double>,
+                &to_matrix<S, float>,
+                &from_matrix<S, double>,
+                &from_matrix<S, float>,
+                &blend<S>,
+                &slerp_weights<S>,
+                &sincos<S>,
+                &acos<S>,
+                &transform_points<S>,
+                &integrate<S>,
+                &madgwick<S>,
+                &mahony<S>,
+                &abs_dots<S>,
+                &products<S>,
+                &clamp_joints<S>,
+            };
+        }
+    }
+}
+
+#endif //QUATERNIONS_BATCH_KERNELS_H
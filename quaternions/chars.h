@@ -0,0 +1,115 @@
+#ifndef QUATERNIONS_CHARS_H
+#define QUATERNIONS_CHARS_H
+
+#include <algorithm>
+#include <array>
+#include <charconv>
+#include <cstddef>
+#include <iterator>
+#include <limits>
+#include <system_error>
+#include <version>
+#if defined(__cpp_lib_format)
+#include <format>
+#endif
+
+namespace quaternions {
+    /**
+     * Upper bound of the characters to_chars writes for one value of type T: the shortest
+     * round-trip digits plus sign, decimal point and exponent. Specialized for xyz and quaternion.
+     */
+    template<typename T>
+    inline constexpr std::size_t max_chars = std::numeric_limits<T>::max_digits10 + 10;
+}
+
+/**
+ * Text conversion shared by xyz and quaternion: `{ x: 1, y: 0.5, z: -2 }` with every number in its
+ * shortest form that parses back to the same value
+ */
+namespace quaternions::chars {
+    template<typename T, std::size_t N>
+    std::to_chars_result write_fields(char* first, char* last,
+                                      const std::array<char, N>& labels, const std::array<T, N>& values) {
+        for (std::size_t i = 0; i < N; ++i) {
+            const char prefix[] = {i == 0 ? '{' : ',', ' ', labels[i], ':', ' '};
+            if (last - first < static_cast<std::ptrdiff_t>(std::size(prefix)))
+                return {last, std::errc::value_too_large};
+            first = std::copy(std::begin(prefix), std::end(prefix), first);
+            const auto [end, error] = std::to_chars(first, last, values[i]);
+            if (error != std::errc{})
+                return {end, error};
+            first = end;
+        }
+        if (last - first < 2)
+            return {last, std::errc::value_too_large};
+        *first++ = ' ';
+        *first++ = '}';
+        return {first, std::errc{}};
+    }
+
+    inline const char* skip_blanks(const char* first, const char* last) {
+        while (first != last && (*first == ' ' || *first == '\t'))
+            ++first;
+        return first;
+    }
+
+    /**
+     * Position after c and the blanks before it, or nullptr if c is not next
+     */
+    inline const char* skip(const char* first, const char* last, char c) {
+        first = skip_blanks(first, last);
+        return first != last && *first == c ? first + 1 : nullptr;
+    }
+
+    /**
+     * Parses what write_fields writes, with any number of blanks between the tokens.
+     * values are only assigned on success.
+     */
+    template<typename T, std::size_t N>
+    std::from_chars_result read_fields(const char* first, const char* last,
+                                       const std::array<char, N>& labels, std::array<T, N>& values) {
+        const auto invalid = std::from_chars_result{first, std::errc::invalid_argument};
+        auto parsed = std::array<T, N>{};
+        auto p = first;
+        for (std::size_t i = 0; i < N; ++i) {
+            if (!(p = skip(p, last, i == 0 ? '{' : ',')) || !(p = skip(p, last, labels[i])) || !(p = skip(p, last, ':')))
+                return invalid;
+            p = skip_blanks(p, last);
+            const auto [end, error] = std::from_chars(p, last, parsed[i]);
+            if (error == std::errc::invalid_argument)
+                return invalid;
+            if (error != std::errc{})
+                return {end, error};
+            p = end;
+        }
+        if (!(p = skip(p, last, '}')))
+            return invalid;
+        values = parsed;
+        return {p, std::errc{}};
+    }
+
+#if defined(__cpp_lib_format)
+    /**
+     * std::formatter for types with to_chars, taking no format specification
+     */
+    template<typename V>
+    struct formatter {
+        template<typename ParseContext>
+        constexpr auto parse(ParseContext& context) {
+            const auto it = context.begin();
+            if (it != context.end() && *it != '}')
+                throw std::format_error("quaternions and vectors take no format specification");
+            return it;
+        }
+
+        template<typename FormatContext>
+        auto format(const V& v, FormatContext& context) const {
+            char buffer[max_chars<V>];
+            const auto end = to_chars(std::begin(buffer), std::end(buffer), v).ptr;
+            return std::copy(buffer, end, context.out());
+        }
+    };
+#endif
+}
+
+#endif //QUATERNIONS_CHARS_H
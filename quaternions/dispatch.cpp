@@ -0,0 +1,91 @@
+#include "dispatch.h"
+#include <cstdlib>
+
+namespace q = quaternions;
+
+namespace {
+    bool cpu_supports(q::isa level) {
+#if (defined(__x86_64__) || defined(__i386__)) && (defined(__GNUC__) || defined(__clang__))
+        switch (level) {
+            case q::isa::scalar:
+                return true;
+            case q::isa::sse2:
+                return __builtin_cpu_supports("sse2");
+            case q::isa::avx2:
+                return __builtin_cpu_supports("avx2") && __builtin_cpu_supports("fma");
+            case q::isa::avx512:
+                return __builtin_cpu_supports("avx512f");
+        }
+        return false;
+#else
+        return level == q::isa::scalar;
+#endif
+    }
+
+    const q::kernels::table* compiled_table(q::isa level) {
+        switch (level) {
+            case q::isa::scalar:
+                return q::kernels::scalar_table();
+            case q::isa::sse2:
+                return q::kernels::sse2_table();
+            case q::isa::avx2:
+                return q::kernels::avx2_table();
+            case q::isa::avx512:
+                return q::kernels::avx512_table();
+        }
+        return nullptr;
+    }
+
+    q::isa select_isa() {
+        const auto supported = q::supported_isas();
+        if (const auto* requested = std::getenv("QUATERNIONS_ISA")) {
+            const auto level = q::parse_isa(requested);
+            for (const auto s : supported)
+                if (level == s)
+                    return s;
+        }
+        return supported.back();
+    }
+}
+
+std::string q::to_string(isa level) {
+    switch (level) {
+        case isa::scalar:
+            return "scalar";
+        case isa::sse2:
+            return "sse2";
+        case isa::avx2:
+            return "avx2";
+        case isa::avx512:
+            return "avx512";
+    }
+    return "unknown";
+}
+
+std::optional<q::isa> q::parse_isa(std::string_view name) {
+    for (const auto level : {isa::scalar, isa::sse2, isa::avx2, isa::avx512})
+        if (name == to_string(level))
+            return level;
+    return std::nullopt;
+}
+
+std::vector<q::isa> q::supported_isas() {
+    auto result = std::vector<isa>{};
+    for (const auto level : {isa::scalar, isa::sse2, isa::avx2, isa::avx512})
+        if (kernels::table_for(level) != nullptr)
+            result.push_back(level);
+    return result;
+}
+
+q::isa q::active_isa() {
+    return kernels::active().level;
+}
+
+const q::kernels::table* q::kernels::table_for(isa level) {
+    return cpu_supports(level) ? compiled_table(level) : nullptr;
+}
+
+const q::kernels::table& q::kernels::active() {
+    static const table& selected = *table_for(select_isa());
+    return selected;
+}
@@ -0,0 +1,174 @@
+#ifndef QUATERNIONS_DISPATCH_H
+#define QUATERNIONS_DISPATCH_H
+
+#include <cstddef>
+#include <optional>
+#include <string>
+#include <string_view>
+#include <vector>
+
+namespace quaternions {
+    /**
+     * Instruction set levels the batch kernels are compiled for, from lowest to highest
+     */
+    enum class isa {
+        scalar,
+        sse2,
+        avx2,
+        avx512,
+    };
+
+    std::string to_string(isa level);
+    std::optional<isa> parse_isa(std::string_view name);
+
+    /**
+     * Levels which are both compiled into the library and supported by the running CPU
+     */
+    std::vector<isa> supported_isas();
+
+    /**
+     * Level used by all batch operations. It is chosen once on first use: the highest supported
+     * level, or the one named by the environment variable QUATERNIONS_ISA if that is supported.
+     */
+    isa active_isa();
+
+    namespace kernels {
+        /**
+         * Read-only view on quaternion components stored as structure of arrays
+         */
+        struct soa_in {
+            const double* w;
+            const double* x;
+            const double* y;
+            const double* z;
+        };
+
+        /**
+         * Writable view on quaternion components stored as structure of arrays
+         */
+        struct soa_out {
+            double* w;
+            double* x;
+            double* y;
+            double* z;
+        };
+
+        /**
+         * Writable view on vectors stored as structure of arrays
+         */
+        struct soa_vectors {
+            double* x;
+            double* y;
+            double* z;
+        };
+
+        /**
+         * Where the products kernel writes, products whose w is nullptr are skipped
+         */
+        struct soa_products {
+            soa_out grassmann;
+            soa_out grassmann_even;
+            soa_out grassmann_odd;
+            soa_out euclidean;
+            double* euclidean_even;
+            soa_out euclidean_odd;
+        };
+
+        /**
+         * One sample of n sensors, each reading interleaved (x, y, z). magnetometer may be nullptr.
+         */
+        struct imu_readings {
+            const double* gyroscope;
+            const double* accelerometer;
+            const double* magnetometer;
+        };
+
+        /**
+         * Limits of joints stored as structure of arrays, see joint_limits in swing_twist.h
+         */
+        struct soa_limits {
+            const double* axis_x;
+            const double* axis_y;
+            const double* axis_z;
+            const double* cos_half_swing;
+            const double* sin_half_swing;
+            const double* sin_half_min_twist;
+            const double* sin_half_max_twist;
+        };
+
+        /**
+         * Where matrices live in a contiguous buffer: element k of the column-major 3x3 rotation
+         * of matrix i is at i * stride + offsets[k], and the padding_count elements at
+         * i * stride + padding[j] hold no rotation (they are written as zeros)
+         */
+        struct matrix_layout {
+            std::size_t stride;
+            std::size_t offsets[9];
+            std::size_t padding_count;
+            std::size_t padding[3];
+        };
+
+        /**
+         * One set of batch kernels, all compiled for the same instruction set level
+         */
+        struct table {
+            isa level;
+            void (*add)(soa_in a, soa_in b, soa_out out, std::size_t n);
+            void (*subtract)(soa_in a, soa_in b, soa_out out, std::size_t n);
+            void (*multiply)(soa_in a, soa_in b, soa_out out, std::size_t n);
+            void (*scale)(soa_in a, double s, soa_out out, std::size_t n);
+            void (*conjugate)(soa_in a, soa_out out, std::size_t n);
+            void (*normalize)(soa_in a, soa_out out, std::size_t n);
+            // out = r * q * r.conjugated()
+            void (*rotate)(soa_in q, soa_in r, soa_out out, std::size_t n);
+            // writes the rotation matrix of every unit quaternion
+            void (*to_matrix)(soa_in q, const matrix_layout& layout, double* out, std::size_t n);
+            void (*to_matrix_float)(soa_in q, const matrix_layout& layout, float* out, std::size_t n);
+            // reads rotation matrices and writes their unit quaternions
+            void (*from_matrix)(const double* in, const matrix_layout& layout, soa_out out, std::size_t n);
+            void (*from_matrix_float)(const float* in, const matrix_layout& layout, soa_out out, std::size_t n);
+            // out = (wa * a + wb * b).normalized()
+            void (*blend)(soa_in a, soa_in b, const double* wa, const double* wb, soa_out out, std::size_t n);
+            // slerp weights sin((1 - t) angle) / sin(angle) and sin(t angle) / sin(angle), exact to
+            // rounding for 0 <= angle <= pi / 2 and 0 <= t <= 1
+            void (*slerp_weights)(const double* t, const double* angle, double* wa, double* wb, std::size_t n);
+            // fast::sincos and fast::acos of every element
+            void (*sincos)(const double* x, double* sin, double* cos, std::size_t n);
+            void (*acos)(const double* x, double* out, std::size_t n);
+            // multiplies n interleaved points (x, y, z) with the column-major 3x3 matrix m
+            void (*transform_points)(const double* m, const double* in, double* out, std::size_t n);
+            // q = q * exp(half_dt * (0, rate)) for n interleaved rates (x, y, z), exact to rounding as
+            // long as every |rate| half_dt <= exponential::max_angle
+            void (*integrate)(soa_out q, const double* rates, double half_dt, std::size_t n);
+            // one update of Madgwick's and of Mahony's orientation filter, the latter keeping its
+            // integral feedback in integral
+            void (*madgwick)(soa_out q, imu_readings readings, double dt, double beta, std::size_t n);
+            void (*mahony)(soa_out q, soa_vectors integral, imu_readings readings, double dt, double kp, double ki,
+                           std::size_t n);
+            // out[i] = min(|q . b[i]|, 1) for the quaternion q given as w, x, y, z
+            void (*abs_dots)(const double* q, soa_in b, double* out, std::size_t n);
+            // the products of products.h of every pair, computed from shared terms in one pass
+            void (*products)(soa_in p, soa_in q, const soa_products& out, std::size_t n);
+            // clamps the swing and twist of every unit quaternion to the limits with the same index
+            void (*clamp_joints)(soa_out q, soa_limits limits, std::size_t n);
+        };
+
+        /**
+         * Kernels for the given level, or nullptr if the level is not compiled in or not
+         * supported by the running CPU
+         */
+        const table* table_for(isa level);
+
+        /**
+         * Kernels for active_isa()
+         */
+        const table& active();
+
+        const table* scalar_table();
+        const table* sse2_table();
+        const table* avx2_table();
+        const table* avx512_table();
+    }
+}
+
+#endif //QUATERNIONS_DISPATCH_H
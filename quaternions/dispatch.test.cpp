@@ -0,0 +1,174 @@
+#include <catch2/catch_test_macros.hpp>
+#include <catch2/matchers/catch_matchers_floating_point.hpp>
+#include "dispatch.h"
+#include "exponential.h"
+#include "quaternion.h"
+#include "quaternion_batch.h"
+#include "trigonometry.h"
+#include <algorithm>
+#include <cmath>
+#include <vector>
+#include "../test/helpers.h"
+
+namespace q = quaternions;
+namespace k = quaternions::kernels;
+
+namespace {
+    k::soa_in in(const q::quaternion_batch& b) {
+        return {b.w.data(), b.x.data(), b.y.data(), b.z.data()};
+    }
+
+    k::soa_out out(q::quaternion_batch& b) {
+        return {b.w.data(), b.x.data(), b.y.data(), b.z.data()};
+    }
+}
+
+TEST_CASE("instruction set levels can be parsed from their names")
+{
+    for (const auto level : {q::isa::scalar, q::isa::sse2, q::isa::avx2, q::isa::avx512})
+        CHECK(q::parse_isa(q::to_string(level)) == level);
+    CHECK(q::parse_isa("mmx") == std::nullopt);
+}
+
+TEST_CASE("scalar kernels are always available and the active level is supported")
+{
+    const auto supported = q::supported_isas();
+    REQUIRE(!supported.empty());
+    CHECK(supported.front() == q::isa::scalar);
+    CHECK(k::table_for(q::active_isa()) == &k::active());
+}
+
+TEST_CASE("kernels of every supported level match single quaternion operations")
+{
+    const auto n = std::size_t{37};
+    const auto a = q::quaternion_batch::from(random_quaternions(n, 1));
+    const auto r = q::quaternion_batch::from(random_unit_quaternions(n, 2));
+    for (const auto level : q::supported_isas()) {
+        INFO("instruction set level " << q::to_string(level));
+        const auto& kernels = *k::table_for(level);
+        CHECK(kernels.level == level);
+
+        auto product = q::quaternion_batch(n);
+        auto rotated = q::quaternion_batch(n);
+        auto matrices = std::vector<q::matrix_3x3>(n);
+        auto blended = q::quaternion_batch(n);
+        const auto wa = std::vector<double>(n, 0.25);
+        const auto wb = std::vector<double>(n, 0.5);
+        kernels.multiply(in(a), in(r), out(product), n);
+        kernels.blend(in(a), in(r), wa.data(), wb.data(), out(blended), n);
+        kernels.rotate(in(a), in(r), out(rotated), n);
+        const auto column_major = k::matrix_layout{9, {0, 1, 2, 3, 4, 5, 6, 7, 8}, 0, {}};
+        kernels.to_matrix(in(r), column_major, reinterpret_cast<double*>(matrices.data()), n);
+        auto from_matrices = q::quaternion_batch(n);
+        kernels.from_matrix(reinterpret_cast<const double*>(matrices.data()), column_major, out(from_matrices), n);
+        const auto points = random_vectors(n, 5);
+        auto transformed = std::vector<q::xyz>(n);
+        kernels.transform_points(reinterpret_cast<const double*>(&matrices[0]),
+                                 reinterpret_cast<const double*>(points.data()),
+                                 reinterpret_cast<double*>(transformed.data()), n);
+        auto angles = std::vector<double>(n);
+        for (std::size_t i = 0; i < n; ++i)
+            angles[i] = (static_cast<double>(i) - 18) * 0.9;
+        auto sin = std::vector<double>(n);
+        auto cos = std::vector<double>(n);
+        auto acos = std::vector<double>(n);
+        kernels.sincos(angles.data(), sin.data(), cos.data(), n);
+        kernels.acos(a.w.data(), acos.data(), n);
+        auto dots = std::vector<double>(n);
+        const double first[] = {r[0].w, r[0].x, r[0].y, r[0].z};
+        kernels.abs_dots(first, in(r), dots.data(), n);
+        for (std::size_t i = 0; i < n; ++i) {
+            const auto [s, c] = q::fast::sincos(angles[i]);
+            CHECK_THAT(sin[i], Catch::Matchers::WithinAbs(s, 1E-15));
+            CHECK_THAT(cos[i], Catch::Matchers::WithinAbs(c, 1E-15));
+            CHECK_THAT(acos[i], Catch::Matchers::WithinAbs(q::fast::acos(a[i].w), 1E-15));
+            CHECK_THAT(dots[i], Catch::Matchers::WithinAbs(std::min(1.0, std::abs(r[0].dot(r[i]))), 1E-15));
+            CHECK_THAT(transformed[i], WithinAbs(q::quaternion::from_vector(points[i]).rotated(r[0])->vector()));
+            CHECK_THAT(product[i], WithinAbs(a[i] * r[i]));
+            CHECK_THAT(rotated[i], WithinAbs(a[i].rotated(r[i]).value()));
+            CHECK_THAT(blended[i], WithinAbs((0.25 * a[i] + 0.5 * r[i]).normalized()));
+            const auto expected = r[i].to_matrix();
+            CHECK_THAT(matrices[i].c1, WithinAbs(expected.c1));
+            CHECK_THAT(matrices[i].c2, WithinAbs(expected.c2));
+            CHECK_THAT(matrices[i].c3, WithinAbs(expected.c3));
+            CHECK_THAT(from_matrices[i], WithinAbs(q::quaternion::from_matrix(expected)));
+        }
+    }
+}
+
+TEST_CASE("slerp weight kernels of every supported level are exact to rounding")
+{
+    // angles up to pi / 2 on both sides of exponential::max_angle, with t = 0 and t = 1 included
+    const auto n = std::size_t{37};
+    auto t = std::vector<double>(n);
+    auto angles = std::vector<double>(n);
+    for (std::size_t i = 0; i < n; ++i) {
+        t[i] = static_cast<double>(i % 6) / 5;
+        angles[i] = static_cast<double>(i) / static_cast<double>(n - 1) * M_PI_2;
+    }
+    for (const auto level : q::supported_isas()) {
+        INFO("instruction set level " << q::to_string(level));
+        auto wa = std::vector<double>(n);
+        auto wb = std::vector<double>(n);
+        k::table_for(level)->slerp_weights(t.data(), angles.data(), wa.data(), wb.data(), n);
+        CHECK(wa[0] == 1);
+        CHECK(wb[0] == 0);
+        for (std::size_t i = 1; i < n; ++i) {
+            const auto expected_a = std::sin((1 - t[i]) * angles[i]) / std::sin(angles[i]);
+            const auto expected_b = std::sin(t[i] * angles[i]) / std::sin(angles[i]);
+            CHECK_THAT(wa[i], Catch::Matchers::WithinAbs(expected_a, 1E-15));
+            CHECK_THAT(wb[i], Catch::Matchers::WithinAbs(expected_b, 1E-15));
+        }
+    }
+}
+
+TEST_CASE("batch rotation and matrix conversion match single quaternion operations")
+{
+    const auto v = q::quaternion_batch::from(random_quaternions(21, 3));
+    const auto r = q::quaternion_batch::from(random_unit_quaternions(21, 4));
+    const auto rotated = v.rotated(r);
+    const auto matrices = r.to_matrix();
+    REQUIRE(rotated.has_value());
+    for (std::size_t i = 0; i < v.size(); ++i) {
+        CHECK_THAT((*rotated)[i], WithinAbs(v[i].rotated(r[i]).value()));
+        CHECK_THAT(matrices[i].c2, WithinAbs(r[i].to_matrix().c2));
+    }
+    CHECK(r.rotated(v) == std::nullopt);
+}
+
+TEST_CASE("integration and filter kernels of every supported level match the scalar ones")
+{
+    const auto n = std::size_t{37};
+    const auto start = q::quaternion_batch::from(random_unit_quaternions(n, 6));
+    const auto gyroscope = random_vectors(n, 7);
+    const auto accelerometer = random_vectors(n, 8);
+    const auto magnetometer = random_vectors(n, 9);
+    const auto readings = k::imu_readings{
+        reinterpret_cast<const double*>(gyroscope.data()),
+        reinterpret_cast<const double*>(accelerometer.data()),
+        reinterpret_cast<const double*>(magnetometer.data()),
+    };
+    const auto run = [&](const k::table& kernels) {
+        auto integrated = start;
+        auto madgwick = start;
+        auto mahony = start;
+        auto integral = std::vector<double>(3 * n);
+        kernels.integrate(out(integrated), readings.gyroscope, 0.05, n);
+        kernels.madgwick(out(madgwick), readings, 0.01, 0.1, n);
+        kernels.mahony(out(mahony), {integral.data(), integral.data() + n, integral.data() + 2 * n},
+                       readings, 0.01, 1, 0.5, n);
+        return std::vector<q::quaternion_batch>{integrated, madgwick, mahony};
+    };
+    const auto expected = run(*k::scalar_table());
+    for (const auto level : q::supported_isas()) {
+        INFO("instruction set level " << q::to_string(level));
+        const auto results = run(*k::table_for(level));
+        for (std::size_t j = 0; j < results.size(); ++j)
+            for (std::size_t i = 0; i < n; ++i)
+                CHECK_THAT(results[j][i], WithinAbs(expected[j][i], 1E-15));
+    }
+    for (std::size_t i = 0; i < n; ++i) {
+        const auto& w = gyroscope[i];
+        CHECK_THAT(expected[0][i], WithinAbs(start[i] * q::exp(q::quaternion{0, w.x, w.y, w.z} * 0.05), 1E-15));
+    }
+}
@@ -0,0 +1,45 @@
+#include <catch2/catch_test_macros.hpp>
+#include <catch2/benchmark/catch_benchmark.hpp>
+#include "distance_matrix.h"
+#include <algorithm>
+#include <cmath>
+#include <vector>
+#include "../test/helpers.h"
+
+namespace q = quaternions;
+
+TEST_CASE("all pairs distances")
+{
+    // 1000 x 1000 pairs
+    const auto a = random_unit_quaternions(1000, 1);
+    const auto b = random_unit_quaternions(1000, 2);
+    auto out = std::vector<double>(a.size() * b.size());
+    BENCHMARK("nested loops with dot and acos 1000x1000") {
+        for (std::size_t i = 0; i < a.size(); ++i)
+            for (std::size_t j = 0; j < b.size(); ++j)
+                out[i * b.size() + j] = 2 * std::acos(std::min(1.0, std::abs(a[i].dot(b[j]))));
+        return out[0];
+    };
+    BENCHMARK("angles 1000x1000") {
+        q::distance_matrix(a, b, out);
+        return out[0];
+    };
+    BENCHMARK("fast angles 1000x1000") {
+        q::distance_matrix(a, b, out, q::distance_measure::fast_angle);
+        return out[0];
+    };
+    BENCHMARK("abs dots 1000x1000") {
+        q::distance_matrix(a, b, out, q::distance_measure::abs_dot);
+        return out[0];
+    };
+    BENCHMARK("angles 1000x1000 on all cores") {
+        q::distance_matrix(q::execution::par, a, b, out);
+        return out[0];
+    };
+    BENCHMARK("fast angles in 256x256 tiles 1000x1000") {
+        auto sum = 0.0;
+        q::distance_tiles(a, b, 256, 256, [&](const q::distance_tile& tile) { sum += tile.values[0]; },
+                          q::distance_measure::fast_angle);
+        return sum;
+    };
+}
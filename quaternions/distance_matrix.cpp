@@ -0,0 +1,124 @@
+#include "distance_matrix.h"
+#include "dispatch.h"
+#include "parallel.h"
+#include "quaternion_batch.h"
+#include <algorithm>
+#include <cmath>
+#include <stdexcept>
+#include <vector>
+
+namespace q = quaternions;
+namespace k = quaternions::kernels;
+
+namespace {
+    // 4 components x 1024 x 8 bytes of b stay in the level 1 or 2 cache while rows pass over them
+    constexpr std::size_t block_columns = 1024;
+    // pairs per thread below which spreading rows costs more than it saves
+    constexpr std::size_t min_pairs = 65536;
+
+    std::size_t min_rows(std::size_t columns) {
+        return std::max<std::size_t>(1, min_pairs / std::max<std::size_t>(1, columns));
+    }
+
+    /**
+     * Rows [row_begin, row_end) and columns [column_begin, column_end) of the matrix, written
+     * row-major with the given stride starting at out
+     */
+    void fill(std::span<const q::quaternion> a, const q::quaternion_batch& b, std::size_t row_begin,
+              std::size_t row_end, std::size_t column_begin, std::size_t column_end, double* out,
+              std::size_t stride, q::distance_measure measure) {
+        const auto& kernels = k::active();
+        for (auto block = column_begin; block < column_end; block += block_columns) {
+            const auto columns = std::min(block_columns, column_end - block);
+            const auto in = k::soa_in{b.w.data() + block, b.x.data() + block, b.y.data() + block, b.z.data() + block};
+            for (auto i = row_begin; i < row_end; ++i) {
+                const double r[] = {a[i].w, a[i].x, a[i].y, a[i].z};
+                const auto row = out + (i - row_begin) * stride + (block - column_begin);
+                kernels.abs_dots(r, in, row, columns);
+                if (measure == q::distance_measure::angle) {
+                    for (std::size_t j = 0; j < columns; ++j)
+                        row[j] = 2 * std::acos(row[j]);
+                } else if (measure == q::distance_measure::fast_angle) {
+                    kernels.acos(row, row, columns);
+                    for (std::size_t j = 0; j < columns; ++j)
+                        row[j] *= 2;
+                }
+            }
+        }
+    }
+
+    void check_size(std::span<const q::quaternion> a, std::span<const q::quaternion> b, std::span<double> out) {
+        if (out.size() != a.size() * b.size())
+            throw std::domain_error("the distance matrix needs one element per pair!");
+    }
+
+    void check_tiles(std::size_t tile_rows, std::size_t tile_columns) {
+        if (tile_rows == 0 || tile_columns == 0)
+            throw std::domain_error("tiles must not be empty!");
+    }
+
+    template<typename FillRows>
+    void for_each_tile(std::span<const q::quaternion> a, std::span<const q::quaternion> b, std::size_t tile_rows,
+                       std::size_t tile_columns, const std::function<void(const q::distance_tile&)>& consume,
+                       FillRows fill_rows) {
+        auto values = std::vector<double>(std::min(tile_rows, a.size()) * std::min(tile_columns, b.size()));
+        for (std::size_t row = 0; row < a.size(); row += tile_rows)
+            for (std::size_t column = 0; column < b.size(); column += tile_columns) {
+                const auto tile = q::distance_tile{
+                    row,
+                    column,
+                    std::min(tile_rows, a.size() - row),
+                    std::min(tile_columns, b.size() - column),
+                    {},
+                };
+                fill_rows(tile, values.data());
+                consume({tile.row, tile.column, tile.rows, tile.columns,
+                         std::span(values).first(tile.rows * tile.columns)});
+            }
+    }
+}
+
+void q::distance_matrix(std::span<const quaternion> a, std::span<const quaternion> b, std::span<double> out,
+                        distance_measure measure) {
+    distance_matrix(execution::seq, a, b, out, measure);
+}
+
+void q::distance_matrix(execution::sequenced_policy, std::span<const quaternion> a, std::span<const quaternion> b,
+                        std::span<double> out, distance_measure measure) {
+    check_size(a, b, out);
+    const auto batch = quaternion_batch::from(b);
+    fill(a, batch, 0, a.size(), 0, b.size(), out.data(), b.size(), measure);
+}
+
+void q::distance_matrix(execution::parallel_policy policy, std::span<const quaternion> a, std::span<const quaternion> b,
+                        std::span<double> out, distance_measure measure) {
+    check_size(a, b, out);
+    const auto batch = quaternion_batch::from(b);
+    parallel_for(policy, a.size(), min_rows(b.size()), [&](std::size_t begin, std::size_t end) {
+        fill(a, batch, begin, end, 0, b.size(), out.data() + begin * b.size(), b.size(), measure);
+    });
+}
+
+void q::distance_tiles(std::span<const quaternion> a, std::span<const quaternion> b, std::size_t tile_rows,
+                       std::size_t tile_columns, const std::function<void(const distance_tile&)>& consume,
+                       distance_measure measure) {
+    check_tiles(tile_rows, tile_columns);
+    const auto batch = quaternion_batch::from(b);
+    for_each_tile(a, b, tile_rows, tile_columns, consume, [&](const distance_tile& tile, double* values) {
+        fill(a, batch, tile.row, tile.row + tile.rows, tile.column, tile.column + tile.columns, values,
+             tile.columns, measure);
+    });
+}
+
+void q::distance_tiles(execution::parallel_policy policy, std::span<const quaternion> a, std::span<const quaternion> b,
+                       std::size_t tile_rows, std::size_t tile_columns,
+                       const std::function<void(const distance_tile&)>& consume, distance_measure measure) {
+    check_tiles(tile_rows, tile_columns);
+    const auto batch = quaternion_batch::from(b);
+    for_each_tile(a, b, tile_rows, tile_columns, consume, [&](const distance_tile& tile, double* values) {
+        parallel_for(policy, tile.rows, min_rows(tile.columns), [&](std::size_t begin, std::size_t end) {
+            fill(a, batch, tile.row + begin, tile.row + end, tile.column, tile.column + tile.columns,
+                 values + begin * tile.columns, tile.columns, measure);
+        });
+    });
+}
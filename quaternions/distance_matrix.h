@@ -0,0 +1,63 @@
+#ifndef QUATERNIONS_DISTANCE_MATRIX_H
+#define QUATERNIONS_DISTANCE_MATRIX_H
+
+#include <cstddef>
+#include <functional>
+#include <span>
+#include "execution.h"
+#include "quaternion.h"
+
+namespace quaternions {
+    /**
+     * What distance_matrix computes for each pair of unit quaternions a and b
+     */
+    enum class distance_measure {
+        // the angle of the rotation between them in radians, 2 acos(|a . b|)
+        angle,
+        // the same with fast::acos, off by less than 6E-8
+        fast_angle,
+        // the cosine similarity |a . b|, skipping the acos
+        abs_dot,
+    };
+
+    /**
+     * Fills the row-major a.size() x b.size() matrix out with the measure of every pair
+     * (a[i], b[j]). Blocks of b are kept in cache while all rows pass over them.
+     * out must have exactly that size.
+     */
+    void distance_matrix(std::span<const quaternion> a, std::span<const quaternion> b, std::span<double> out,
+                         distance_measure measure = distance_measure::angle);
+    void distance_matrix(execution::sequenced_policy, std::span<const quaternion> a, std::span<const quaternion> b,
+                         std::span<double> out, distance_measure measure = distance_measure::angle);
+    void distance_matrix(execution::parallel_policy, std::span<const quaternion> a, std::span<const quaternion> b,
+                         std::span<double> out, distance_measure measure = distance_measure::angle);
+
+    /**
+     * Part of a distance matrix: rows [row, row + rows) and columns [column, column + columns),
+     * row-major. The values are only valid during the callback.
+     */
+    struct distance_tile {
+        std::size_t row;
+        std::size_t column;
+        std::size_t rows;
+        std::size_t columns;
+        std::span<const double> values;
+    };
+
+    /**
+     * Computes the distance matrix one tile of at most tile_rows x tile_columns at a time and
+     * hands each tile to consume, row of tiles by row of tiles, so that matrices larger than
+     * memory can be streamed, e.g. to disk. Only one tile is held at a time. With
+     * execution::par the rows of each tile are spread over the executor of the policy, while consume
+     * is always called on the calling thread in order.
+     */
+    void distance_tiles(std::span<const quaternion> a, std::span<const quaternion> b, std::size_t tile_rows,
+                        std::size_t tile_columns, const std::function<void(const distance_tile&)>& consume,
+                        distance_measure measure = distance_measure::angle);
+    void distance_tiles(execution::parallel_policy, std::span<const quaternion> a, std::span<const quaternion> b,
+                        std::size_t tile_rows, std::size_t tile_columns,
+                        const std::function<void(const distance_tile&)>& consume,
+                        distance_measure measure = distance_measure::angle);
+}
+
+#endif //QUATERNIONS_DISTANCE_MATRIX_H
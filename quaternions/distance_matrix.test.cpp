@@ -0,0 +1,95 @@
+#include <catch2/catch_test_macros.hpp>
+#include <catch2/matchers/catch_matchers_floating_point.hpp>
+#include "distance_matrix.h"
+#include <cmath>
+#include <stdexcept>
+#include <vector>
+#include "../test/helpers.h"
+
+namespace q = quaternions;
+using Catch::Matchers::WithinAbs;
+
+namespace {
+    double abs_dot(const q::quaternion& a, const q::quaternion& b) {
+        return std::min(1.0, std::abs(a.dot(b)));
+    }
+}
+
+TEST_CASE("distance matrices match pairwise angles and dot products")
+{
+    // more columns than one cache block, and a tail that is no multiple of the vector width
+    const auto a = random_unit_quaternions(7, 1);
+    const auto b = random_unit_quaternions(1500, 2);
+    auto angles = std::vector<double>(a.size() * b.size());
+    auto fast = std::vector<double>(angles.size());
+    auto dots = std::vector<double>(angles.size());
+    auto parallel = std::vector<double>(angles.size());
+    q::distance_matrix(a, b, angles);
+    q::distance_matrix(a, b, fast, q::distance_measure::fast_angle);
+    q::distance_matrix(a, b, dots, q::distance_measure::abs_dot);
+    q::distance_matrix(q::execution::par, a, b, parallel);
+    for (std::size_t i = 0; i < a.size(); ++i)
+        for (std::size_t j = 0; j < b.size(); ++j) {
+            const auto k = i * b.size() + j;
+            CHECK_THAT(dots[k], WithinAbs(abs_dot(a[i], b[j]), 1E-15));
+            CHECK_THAT(angles[k], WithinAbs(2 * std::acos(abs_dot(a[i], b[j])), 1E-14));
+            CHECK_THAT(fast[k], WithinAbs(angles[k], 6E-8));
+            CHECK(parallel[k] == angles[k]);
+        }
+}
+
+TEST_CASE("distances ignore the sign of quaternions")
+{
+    const auto r = q::quaternion::from_rotation({{0, 0, 1}, 0.5});
+    const auto a = std::vector<q::quaternion>{r, -1.0 * r};
+    const auto b = std::vector<q::quaternion>{{1, 0, 0, 0}, r};
+    auto out = std::vector<double>(4);
+    q::distance_matrix(a, b, out);
+    CHECK_THAT(out[0], WithinAbs(0.5, 1E-15));
+    CHECK_THAT(out[1], WithinAbs(0, 1E-7));
+    CHECK(out[2] == out[0]);
+    CHECK(out[3] == out[1]);
+}
+
+TEST_CASE("tiles cover the distance matrix once")
+{
+    const auto a = random_unit_quaternions(23, 3);
+    const auto b = random_unit_quaternions(41, 4);
+    auto whole = std::vector<double>(a.size() * b.size());
+    q::distance_matrix(a, b, whole, q::distance_measure::abs_dot);
+
+    for (const auto parallel : {false, true}) {
+        auto assembled = std::vector<double>(whole.size(), -1);
+        auto tiles = std::size_t{0};
+        const auto consume = [&](const q::distance_tile& tile) {
+            CHECK(tile.values.size() == tile.rows * tile.columns);
+            CHECK(tile.rows <= 10);
+            CHECK(tile.columns <= 16);
+            for (std::size_t i = 0; i < tile.rows; ++i)
+                for (std::size_t j = 0; j < tile.columns; ++j) {
+                    auto& element = assembled[(tile.row + i) * b.size() + tile.column + j];
+                    CHECK(element == -1);
+                    element = tile.values[i * tile.columns + j];
+                }
+            ++tiles;
+        };
+        if (parallel)
+            q::distance_tiles(q::execution::par, a, b, 10, 16, consume, q::distance_measure::abs_dot);
+        else
+            q::distance_tiles(a, b, 10, 16, consume, q::distance_measure::abs_dot);
+        CHECK(tiles == 3 * 3);
+        CHECK(assembled == whole);
+    }
+}
+
+TEST_CASE("distance matrices check their sizes")
+{
+    const auto a = random_unit_quaternions(3, 5);
+    auto out = std::vector<double>(8);
+    CHECK_THROWS_AS(q::distance_matrix(a, a, out), std::domain_error);
+    CHECK_THROWS_AS(q::distance_tiles(a, a, 0, 4, [](const q::distance_tile&) {}), std::domain_error);
+    auto calls = 0;
+    q::distance_tiles(a, std::vector<q::quaternion>{}, 4, 4, [&](const q::distance_tile&) { ++calls; });
+    CHECK(calls == 0);
+    CHECK_NOTHROW(q::distance_matrix(a, std::vector<q::quaternion>{}, std::span<double>{}));
+}
@@ -0,0 +1,31 @@
+#include <catch2/catch_test_macros.hpp>
+#include <catch2/benchmark/catch_benchmark.hpp>
+#include "dual_quaternion.h"
+#include <vector>
+#include "../test/benchmarks.h"
+#include "../test/helpers.h"
+
+namespace q = quaternions;
+
+TEST_CASE("dual quaternion skinning")
+{
+    const auto rotations = random_unit_quaternions(64, 1);
+    const auto translations = random_vectors(64, 2);
+    auto bones = std::vector<q::dual_quaternion>{};
+    for (std::size_t i = 0; i < rotations.size(); ++i)
+        bones.push_back(q::dual_quaternion::from_transform(rotations[i], translations[i]));
+
+    for (const auto n : benchmark_batch_sizes) {
+        const auto positions = random_vectors(n, 3);
+        auto influences = std::vector<q::skin_influence>(n);
+        for (std::size_t i = 0; i < n; ++i) {
+            const auto b = static_cast<std::uint32_t>(i % 61);
+            influences[i] = {{b, b + 1, b + 2, b + 3}, {0.4, 0.3, 0.2, 0.1}};
+        }
+        auto out = std::vector<q::xyz>(n);
+        BENCHMARK("skin 4 bones x" + batch_label(n)) {
+            q::skin(bones, positions, influences, out);
+            return out[0];
+        };
+    }
+}
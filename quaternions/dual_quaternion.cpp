@@ -0,0 +1,76 @@
+#include "dual_quaternion.h"
+#include "parallel.h"
+#include <stdexcept>
+#include <string>
+
+namespace q = quaternions;
+
+namespace {
+    // vertices per chunk, large enough to amortize starting a thread
+    constexpr std::size_t skin_chunk = 4096;
+
+    q::dual_quaternion blend(std::span<const q::dual_quaternion> bones, const q::skin_influence& influence) {
+        const q::dual_quaternion* pivot = nullptr;
+        auto blended = q::dual_quaternion{{0, 0, 0, 0}, {0, 0, 0, 0}};
+        for (std::size_t k = 0; k < influence.bones.size(); ++k) {
+            const auto weight = influence.weights[k];
+            if (weight == 0)
+                continue;
+            const auto bone = influence.bones[k];
+            if (bone >= bones.size())
+                throw std::domain_error("bone index " + std::to_string(bone) + " too high for " +
+                                        std::to_string(bones.size()) + " bones!");
+            // q and -q are the same transformation, blend all bones on the side of the first one
+            const auto& b = bones[bone];
+            if (pivot == nullptr)
+                pivot = &b;
+            blended = blended + b * (pivot->real.dot(b.real) < 0 ? -weight : weight);
+        }
+        // vertices without influences stay where they are
+        if (pivot == nullptr)
+            return q::dual_quaternion::identity();
+        return blended.normalized();
+    }
+
+    void check_sizes(std::span<const q::dual_quaternion> bones, std::span<const q::xyz> positions,
+                     std::span<const q::skin_influence> influences, std::span<q::xyz> out) {
+        if (positions.size() != influences.size() || positions.size() != out.size())
+            throw std::domain_error("skinning needs one influence and one output per position!");
+        if (bones.empty() && !positions.empty())
+            throw std::domain_error("skinning needs at least one bone!");
+    }
+
+    void skin_range(std::span<const q::dual_quaternion> bones, std::span<const q::xyz> positions,
+                    std::span<const q::skin_influence> influences, std::span<q::xyz> out,
+                    std::size_t begin, std::size_t end) {
+        for (auto i = begin; i < end; ++i)
+            out[i] = blend(bones, influences[i]).transformed(positions[i]);
+    }
+}
+
+void q::skin(std::span<const dual_quaternion> bones,
+             std::span<const xyz> positions,
+             std::span<const skin_influence> influences,
+             std::span<xyz> out) {
+    skin(execution::par, bones, positions, influences, out);
+}
+
+void q::skin(execution::sequenced_policy,
+             std::span<const dual_quaternion> bones,
+             std::span<const xyz> positions,
+             std::span<const skin_influence> influences,
+             std::span<xyz> out) {
+    check_sizes(bones, positions, influences, out);
+    skin_range(bones, positions, influences, out, 0, positions.size());
+}
+
+void q::skin(execution::parallel_policy policy,
+             std::span<const dual_quaternion> bones,
+             std::span<const xyz> positions,
+             std::span<const skin_influence> influences,
+             std::span<xyz> out) {
+    check_sizes(bones, positions, influences, out);
+    parallel_for(policy, positions.size(), skin_chunk, [&](std::size_t begin, std::size_t end) {
+        skin_range(bones, positions, influences, out, begin, end);
+    });
+}
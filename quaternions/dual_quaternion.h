@@ -0,0 +1,210 @@
+#ifndef QUATERNIONS_DUAL_QUATERNION_H
+#define QUATERNIONS_DUAL_QUATERNION_H
+#include <array>
+#include <cmath>
+#include <cstdint>
+#include <span>
+#include <string>
+#include <type_traits>
+#include "execution.h"
+#include "quaternion.h"
+#include "xyz.h"
+
+namespace quaternions {
+    /**
+     * Dual quaternion real + ε dual with ε² = 0. A unit dual quaternion describes a rigid
+     * transformation: real is the rotation and dual = ½ translation * real.
+     */
+    template<typename T>
+    class basic_dual_quaternion {
+    public:
+        basic_quaternion<T> real;
+        basic_quaternion<T> dual;
+        constexpr basic_dual_quaternion static identity();
+        constexpr basic_dual_quaternion static from_transform(const basic_quaternion<T>& rotation,
+                                                              const basic_xyz<T>& translation);
+        std::string to_string() const;
+        constexpr basic_xyz<T> translation() const;
+        constexpr basic_dual_quaternion conjugated() const;
+        constexpr basic_dual_quaternion inverted() const;
+        basic_dual_quaternion normalized() const;
+        /**
+         * Rotates and then translates p, expects a unit dual quaternion
+         */
+        constexpr basic_xyz<T> transformed(const basic_xyz<T>& p) const;
+    };
+
+    template<typename T>
+    constexpr basic_dual_quaternion<T> operator+(const basic_dual_quaternion<T>& a,
+                                                 const basic_dual_quaternion<T>& b);
+    template<typename T>
+    constexpr basic_dual_quaternion<T> operator*(const basic_dual_quaternion<T>& a,
+                                                 const basic_dual_quaternion<T>& b);
+    template<typename T>
+    constexpr basic_dual_quaternion<T> operator*(const basic_dual_quaternion<T>& d, const std::type_identity_t<T> s);
+    template<typename T>
+    constexpr basic_dual_quaternion<T> operator*(const std::type_identity_t<T> s, const basic_dual_quaternion<T>& d);
+
+    template<typename T>
+    constexpr bool operator==(const basic_dual_quaternion<T>& a, const basic_dual_quaternion<T>& b);
+    template<typename T>
+    constexpr bool almost_equal(const basic_dual_quaternion<T>& a, const basic_dual_quaternion<T>& b,
+                                std::type_identity_t<T> eps = default_eps<T>);
+
+    /**
+     * Screw linear interpolation between two unit dual quaternions along the shortest path,
+     * t = 0 gives a and t = 1 gives b
+     */
+    template<typename T>
+    basic_dual_quaternion<T> sclerp(const basic_dual_quaternion<T>& a, const basic_dual_quaternion<T>& b,
+                                    std::type_identity_t<T> t);
+
+    using dual_quaternion = basic_dual_quaternion<double>;
+
+    /**
+     * Up to four bones influencing one vertex, unused slots have weight 0. A vertex with all
+     * slots unused is not moved by skinning.
+     */
+    struct skin_influence {
+        std::array<std::uint32_t, 4> bones;
+        std::array<double, 4> weights;
+    };
+
+    /**
+     * Dual quaternion linear blend skinning: every position is transformed by the normalized,
+     * weighted sum of its bones. Large meshes are split into chunks on the executor of the
+     * policy, execution::par unless one is given.
+     */
+    void skin(std::span<const dual_quaternion> bones,
+              std::span<const xyz> positions,
+              std::span<const skin_influence> influences,
+              std::span<xyz> out);
+    void skin(execution::sequenced_policy,
+              std::span<const dual_quaternion> bones,
+              std::span<const xyz> positions,
+              std::span<const skin_influence> influences,
+              std::span<xyz> out);
+    void skin(execution::parallel_policy,
+              std::span<const dual_quaternion> bones,
+              std::span<const xyz> positions,
+              std::span<const skin_influence> influences,
+              std::span<xyz> out);
+
+    template<typename T>
+    constexpr basic_dual_quaternion<T> basic_dual_quaternion<T>::identity() {
+        return basic_dual_quaternion{{1, 0, 0, 0}, {0, 0, 0, 0}};
+    }
+
+    template<typename T>
+    constexpr basic_dual_quaternion<T> basic_dual_quaternion<T>::from_transform(const basic_quaternion<T>& rotation,
+                                                                                const basic_xyz<T>& translation) {
+        return basic_dual_quaternion{rotation, T(0.5) * (basic_quaternion<T>::from_vector(translation) * rotation)};
+    }
+
+    template<typename T>
+    std::string basic_dual_quaternion<T>::to_string() const {
+        return std::string("{ ") +
+            "real: " + real.to_string() + ", " +
+            "dual: " + dual.to_string() +
+            " }";
+    }
+
+    template<typename T>
+    constexpr basic_xyz<T> basic_dual_quaternion<T>::translation() const {
+        return (T(2) * (dual * real.conjugated())).vector();
+    }
+
+    template<typename T>
+    constexpr basic_dual_quaternion<T> basic_dual_quaternion<T>::conjugated() const {
+        return basic_dual_quaternion{real.conjugated(), dual.conjugated()};
+    }
+
+    template<typename T>
+    constexpr basic_dual_quaternion<T> basic_dual_quaternion<T>::inverted() const {
+        const auto real_inverted = real.inverted();
+        return basic_dual_quaternion{real_inverted, -(real_inverted * dual * real_inverted)};
+    }
+
+    template<typename T>
+    basic_dual_quaternion<T> basic_dual_quaternion<T>::normalized() const {
+        const auto length = real.length();
+        const auto r = real * (1 / length);
+        const auto d = dual * (1 / length);
+        return basic_dual_quaternion{r, d - r * r.dot(d)};
+    }
+
+    template<typename T>
+    constexpr basic_xyz<T> basic_dual_quaternion<T>::transformed(const basic_xyz<T>& p) const {
+        const auto u = real.vector();
+        const auto t = T(2) * (u * p);
+        return p + real.w * t + u * t + translation();
+    }
+
+    template<typename T>
+    constexpr basic_dual_quaternion<T> operator+(const basic_dual_quaternion<T>& a,
+                                                 const basic_dual_quaternion<T>& b) {
+        return basic_dual_quaternion<T>{a.real + b.real, a.dual + b.dual};
+    }
+
+    template<typename T>
+    constexpr basic_dual_quaternion<T> operator*(const basic_dual_quaternion<T>& a,
+                                                 const basic_dual_quaternion<T>& b) {
+        return basic_dual_quaternion<T>{a.real * b.real, a.real * b.dual + a.dual * b.real};
+    }
+
+    template<typename T>
+    constexpr basic_dual_quaternion<T> operator*(const basic_dual_quaternion<T>& d, const std::type_identity_t<T> s) {
+        return basic_dual_quaternion<T>{d.real * s, d.dual * s};
+    }
+
+    template<typename T>
+    constexpr basic_dual_quaternion<T> operator*(const std::type_identity_t<T> s, const basic_dual_quaternion<T>& d) {
+        return d * s;
+    }
+
+    template<typename T>
+    constexpr bool operator==(const basic_dual_quaternion<T>& a, const basic_dual_quaternion<T>& b) {
+        return a.real == b.real && a.dual == b.dual;
+    }
+
+    template<typename T>
+    constexpr bool almost_equal(const basic_dual_quaternion<T>& a, const basic_dual_quaternion<T>& b,
+                                std::type_identity_t<T> eps) {
+        return almost_equal(a.real, b.real, eps) && almost_equal(a.dual, b.dual, eps);
+    }
+
+    template<typename T>
+    basic_dual_quaternion<T> sclerp(const basic_dual_quaternion<T>& a, const basic_dual_quaternion<T>& b,
+                                    std::type_identity_t<T> t) {
+        auto diff = a.conjugated() * b;
+        if (diff.real.w < 0)
+            diff = diff * T(-1);
+
+        const auto r = diff.real;
+        const auto d = diff.dual;
+        const auto s = r.vector().length();
+        if (s < default_eps<T>) {
+            // pure translation, the screw degenerates to a straight line
+            return a * basic_dual_quaternion<T>{{1, 0, 0, 0}, d * t};
+        }
+
+        // screw parameters: angle, axis direction, pitch and moment
+        const auto angle = 2 * std::atan2(s, r.w);
+        const auto l = r.vector() * (1 / s);
+        const auto pitch = -2 * d.w / s;
+        const auto moment = (d.vector() + l * (-pitch / 2 * r.w)) * (1 / s);
+
+        const auto half_angle = t * angle / 2;
+        const auto half_pitch = t * pitch / 2;
+        const auto sin_half = std::sin(half_angle);
+        const auto cos_half = std::cos(half_angle);
+        const auto power = basic_dual_quaternion<T>{
+            {cos_half, sin_half * l.x, sin_half * l.y, sin_half * l.z},
+            basic_quaternion<T>{-half_pitch * sin_half, 0, 0, 0} +
+                basic_quaternion<T>::from_vector(sin_half * moment + half_pitch * cos_half * l),
+        };
+        return a * power;
+    }
+}
+
+#endif //QUATERNIONS_DUAL_QUATERNION_H
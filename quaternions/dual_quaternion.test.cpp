@@ -0,0 +1,121 @@
+#include <catch2/catch_test_macros.hpp>
+#include <catch2/matchers/catch_matchers_floating_point.hpp>
+#include "dual_quaternion.h"
+#include "execution.h"
+#include "quaternion.h"
+#include "thread_pool.h"
+#include "xyz.h"
+#include <cmath>
+#include <vector>
+#include "../test/helpers.h"
+
+namespace q = quaternions;
+using Catch::Matchers::WithinRel;
+using Catch::Matchers::WithinAbs;
+
+TEST_CASE("dual quaternion from rotation and translation")
+{
+    const auto r = q::quaternion::from_rotation({{0, 0, 1}, M_PI_2});
+    const auto t = q::xyz{1, 2, 3};
+    const auto d = q::dual_quaternion::from_transform(r, t);
+    CHECK_THAT(d.real, WithinAbs(r));
+    CHECK_THAT(d.translation(), WithinAbs(t));
+    CHECK_THAT(d.transformed({1, 0, 0}), WithinAbs(q::xyz{1, 3, 3}));
+}
+
+TEST_CASE("composition of dual quaternions applies the right one first")
+{
+    const auto a = q::dual_quaternion::from_transform(q::quaternion::from_rotation({{1, 0, 0}, M_PI_2}), {0, 1, 0});
+    const auto b = q::dual_quaternion::from_transform(q::quaternion::from_rotation({{0, 0, 1}, M_PI_4}), {3, 0, -1});
+    const auto p = q::xyz{0.5, -2, 1};
+    CHECK_THAT((a * b).transformed(p), WithinAbs(a.transformed(b.transformed(p))));
+}
+
+TEST_CASE("inverted dual quaternion undoes the transformation")
+{
+    const auto d = q::dual_quaternion::from_transform(q::quaternion{1, 2, 3, 4}.normalized(), {-1, 5, 2});
+    CHECK(q::almost_equal(d * d.inverted(), q::dual_quaternion::identity()));
+    CHECK(q::almost_equal(d.inverted(), d.conjugated()));
+    CHECK_THAT(d.inverted().transformed(d.transformed({1, 2, 3})), WithinAbs(q::xyz{1, 2, 3}));
+}
+
+TEST_CASE("normalized dual quaternion is a rigid transformation")
+{
+    const auto d = q::dual_quaternion::from_transform(q::quaternion{1, 2, 3, 4}.normalized(), {-1, 5, 2}) * 3.0;
+    const auto n = d.normalized();
+    CHECK_THAT(n.real.length(), WithinRel(1.0));
+    CHECK_THAT(n.real.dot(n.dual), WithinAbs(0.0, 1E-12));
+    CHECK_THAT(n.translation(), WithinAbs(q::xyz{-1, 5, 2}));
+}
+
+TEST_CASE("screw linear interpolation")
+{
+    const auto a = q::dual_quaternion::identity();
+    const auto b = q::dual_quaternion::from_transform(q::quaternion::from_rotation({{0, 0, 1}, M_PI_2}), {0, 0, 2});
+    CHECK(q::almost_equal(q::sclerp(a, b, 0.0), a));
+    CHECK(q::almost_equal(q::sclerp(a, b, 1.0), b));
+
+    // a screw along z: half the angle and half the translation
+    const auto half = q::sclerp(a, b, 0.5);
+    CHECK_THAT(half.real, WithinAbs(q::quaternion::from_rotation({{0, 0, 1}, M_PI_4})));
+    CHECK_THAT(half.translation(), WithinAbs(q::xyz{0, 0, 1}));
+
+    const auto c = q::dual_quaternion::from_transform({1, 0, 0, 0}, {4, 0, 0});
+    CHECK_THAT(q::sclerp(a, c, 0.25).translation(), WithinAbs(q::xyz{1, 0, 0}));
+}
+
+TEST_CASE("skinning with a single bone transforms rigidly")
+{
+    const auto bone = q::dual_quaternion::from_transform(q::quaternion::from_rotation({{0, 1, 0}, 0.3}), {1, 1, 1});
+    const auto bones = std::vector<q::dual_quaternion>{q::dual_quaternion::identity(), bone};
+    const auto positions = random_vectors(10'000, 5);
+    const auto influences = std::vector<q::skin_influence>(positions.size(), {{1, 0, 0, 0}, {1, 0, 0, 0}});
+    auto out = std::vector<q::xyz>(positions.size());
+    q::skin(bones, positions, influences, out);
+    for (std::size_t i = 0; i < positions.size(); ++i)
+        CHECK_THAT(out[i], WithinAbs(bone.transformed(positions[i])));
+
+    auto pool = q::thread_pool(2);
+    auto seq = std::vector<q::xyz>(positions.size()), par = seq;
+    q::skin(q::execution::seq, bones, positions, influences, seq);
+    q::skin(q::execution::par.on(pool), bones, positions, influences, par);
+    for (std::size_t i = 0; i < positions.size(); i += 97) {
+        CHECK_THAT(seq[i], WithinAbs(out[i]));
+        CHECK_THAT(par[i], WithinAbs(out[i]));
+    }
+}
+
+TEST_CASE("skinning blends bones across the double cover")
+{
+    const auto a = q::dual_quaternion::from_transform(q::quaternion::from_rotation({{0, 0, 1}, 0.2}), {1, 0, 0});
+    const auto b = q::dual_quaternion::from_transform(q::quaternion::from_rotation({{0, 0, 1}, 0.6}), {1, 0, 0});
+    // -b describes the same transformation as b
+    const auto bones = std::vector<q::dual_quaternion>{a, b * -1.0};
+    const auto positions = std::vector<q::xyz>{{1, 0, 0}};
+    const auto influences = std::vector<q::skin_influence>{{{0, 1, 0, 0}, {0.5, 0.5, 0, 0}}};
+    auto out = std::vector<q::xyz>(1);
+    q::skin(bones, positions, influences, out);
+    const auto expected = q::dual_quaternion::from_transform(q::quaternion::from_rotation({{0, 0, 1}, 0.4}), {1, 0, 0});
+    CHECK_THAT(out[0], WithinAbs(expected.transformed({1, 0, 0})));
+}
+
+TEST_CASE("skinning leaves vertices without influences in place")
+{
+    const auto bone = q::dual_quaternion::from_transform(q::quaternion::from_rotation({{0, 1, 0}, 0.3}), {1, 1, 1});
+    const auto bones = std::vector<q::dual_quaternion>{bone};
+    const auto positions = std::vector<q::xyz>{{1, 2, 3}, {1, 2, 3}};
+    const auto influences = std::vector<q::skin_influence>{{{0, 0, 0, 0}, {0, 0, 0, 0}}, {{0, 0, 0, 0}, {1, 0, 0, 0}}};
+    auto out = std::vector<q::xyz>(2);
+    q::skin(bones, positions, influences, out);
+    CHECK_THAT(out[0], WithinAbs(positions[0]));
+    CHECK_THAT(out[1], WithinAbs(bone.transformed(positions[1])));
+}
+
+TEST_CASE("skinning with an unknown bone should fail")
+{
+    const auto bones = std::vector<q::dual_quaternion>{q::dual_quaternion::identity()};
+    const auto positions = std::vector<q::xyz>{{1, 0, 0}};
+    const auto influences = std::vector<q::skin_influence>{{{0, 7, 0, 0}, {0.5, 0.5, 0, 0}}};
+    auto out = std::vector<q::xyz>(1);
+    CHECK_THROWS(q::skin(bones, positions, influences, out));
+}
@@ -0,0 +1,40 @@
+#include <catch2/catch_test_macros.hpp>
+#include <catch2/benchmark/catch_benchmark.hpp>
+#include "euler.h"
+#include <algorithm>
+#include <vector>
+#include "../test/benchmarks.h"
+#include "../test/helpers.h"
+
+namespace q = quaternions;
+
+TEST_CASE("to_euler and from_euler")
+{
+    for (const auto n : benchmark_batch_sizes) {
+        const auto unit = random_unit_quaternions(n, 1);
+        auto angles = std::vector<q::euler_angles>(n);
+        auto exact = std::vector<q::quaternion>(n);
+        auto fast = std::vector<q::quaternion>(n);
+        BENCHMARK("to_euler zyx x" + batch_label(n)) {
+            q::to_euler<q::euler_order::zyx>(unit, angles);
+            return angles[0];
+        };
+        BENCHMARK("to_euler zxz x" + batch_label(n)) {
+            q::to_euler(q::euler_order::zxz, unit, angles);
+            return angles[0];
+        };
+        BENCHMARK("from_euler zxz x" + batch_label(n)) {
+            q::from_euler(q::euler_order::zxz, angles, exact);
+            return exact[0];
+        };
+        BENCHMARK("fast from_euler zxz x" + batch_label(n)) {
+            q::fast::from_euler(q::euler_order::zxz, angles, fast);
+            return fast[0];
+        };
+
+        auto error = 0.0;
+        for (std::size_t i = 0; i < n; ++i)
+            error = std::max(error, (fast[i] - exact[i]).length());
+        WARN("fast from_euler x" << batch_label(n) << ": largest error " << error);
+    }
+}
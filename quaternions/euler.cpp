@@ -0,0 +1,77 @@
+#include "euler.h"
+#include "dispatch.h"
+#include <algorithm>
+#include <array>
+#include <stdexcept>
+#include <utility>
+
+namespace q = quaternions;
+namespace k = quaternions::kernels;
+
+namespace {
+    constexpr std::size_t block_size = 128;
+
+    template<q::euler_order Order>
+    void fast_from_euler(std::span<const q::euler_angles> in, std::span<q::quaternion> out) {
+        // the half angles of block_size triples at a time go through the vectorized kernel
+        double half[3][block_size], sin[3][block_size], cos[3][block_size];
+        const auto& kernels = k::active();
+        for (std::size_t begin = 0; begin < in.size(); begin += block_size) {
+            const auto count = std::min(block_size, in.size() - begin);
+            for (std::size_t j = 0; j < count; ++j) {
+                half[0][j] = in[begin + j].first / 2;
+                half[1][j] = in[begin + j].second / 2;
+                half[2][j] = in[begin + j].third / 2;
+            }
+            for (std::size_t a = 0; a < 3; ++a)
+                kernels.sincos(half[a], sin[a], cos[a], count);
+            for (std::size_t j = 0; j < count; ++j)
+                out[begin + j] = q::euler::compose<Order>(cos[0][j], sin[0][j], cos[1][j], sin[1][j],
+                                                          cos[2][j], sin[2][j]);
+        }
+    }
+
+    using from_euler_batch = void (*)(std::span<const q::euler_angles>, std::span<q::quaternion>);
+    using to_euler_batch = void (*)(std::span<const q::quaternion>, std::span<q::euler_angles>);
+
+    /**
+     * One instantiation per order, indexed by the value of the order
+     */
+    template<std::size_t... I>
+    constexpr auto from_euler_batches(std::index_sequence<I...>) {
+        return std::array<from_euler_batch, sizeof...(I)>{&q::from_euler<q::euler_orders[I]>...};
+    }
+
+    template<std::size_t... I>
+    constexpr auto to_euler_batches(std::index_sequence<I...>) {
+        return std::array<to_euler_batch, sizeof...(I)>{&q::to_euler<q::euler_orders[I]>...};
+    }
+
+    template<std::size_t... I>
+    constexpr auto fast_from_euler_batches(std::index_sequence<I...>) {
+        return std::array<from_euler_batch, sizeof...(I)>{&fast_from_euler<q::euler_orders[I]>...};
+    }
+
+    constexpr auto orders = std::make_index_sequence<std::size(q::euler_orders)>{};
+    constexpr auto from_euler_by_order = from_euler_batches(orders);
+    constexpr auto to_euler_by_order = to_euler_batches(orders);
+    constexpr auto fast_from_euler_by_order = fast_from_euler_batches(orders);
+}
+
+void q::euler::check_sizes(std::size_t in, std::size_t out) {
+    if (in != out)
+        throw std::domain_error("converting Euler angles needs one output per input!");
+}
+
+void q::from_euler(euler_order order, std::span<const euler_angles> in, std::span<quaternion> out) {
+    from_euler_by_order[static_cast<std::size_t>(order)](in, out);
+}
+
+void q::to_euler(euler_order order, std::span<const quaternion> in, std::span<euler_angles> out) {
+    to_euler_by_order[static_cast<std::size_t>(order)](in, out);
+}
+
+void q::fast::from_euler(euler_order order, std::span<const euler_angles> in, std::span<quaternion> out) {
+    euler::check_sizes(in.size(), out.size());
+    fast_from_euler_by_order[static_cast<std::size_t>(order)](in, out);
+}
@@ -0,0 +1,192 @@
+#ifndef QUATERNIONS_EULER_H
+#define QUATERNIONS_EULER_H
+
+#include <cmath>
+#include <cstddef>
+#include <span>
+#include "quaternion.h"
+
+namespace quaternions {
+    /**
+     * Axis sequences of Euler angles: the six Tait-Bryan orders about three different axes and the
+     * six proper Euler orders whose first and last axis are the same
+     */
+    enum class euler_order {
+        xyz, xzy, yxz, yzx, zxy, zyx,
+        xyx, xzx, yxy, yzy, zxz, zyz,
+    };
+
+    inline constexpr euler_order euler_orders[] = {
+        euler_order::xyz, euler_order::xzy, euler_order::yxz, euler_order::yzx, euler_order::zxy, euler_order::zyx,
+        euler_order::xyx, euler_order::xzx, euler_order::yxy, euler_order::yzy, euler_order::zxz, euler_order::zyz,
+    };
+
+    /**
+     * Intrinsic rotations by first, second and third about the axes of an euler_order, i.e. the
+     * quaternion q_first * q_second * q_third. E.g. euler_order::zyx gives yaw, pitch and roll.
+     */
+    template<typename T>
+    struct basic_euler_angles {
+        T first;
+        T second;
+        T third;
+    };
+
+    using euler_angles = basic_euler_angles<double>;
+
+    /**
+     * Quaternion of Euler angles, specialized for the order at compile time
+     */
+    template<euler_order Order, typename T>
+    basic_quaternion<T> from_euler(const basic_euler_angles<T>& angles);
+
+    /**
+     * Euler angles of a unit quaternion by Bernardes and Viollet's direct method, without a rotation
+     * matrix. first and third are in (-π, π], second is in [-π/2, π/2] for Tait-Bryan orders and
+     * in [0, π] for proper Euler orders. In gimbal lock, when second is within euler::gimbal_lock
+     * of its limits, only the sum or the difference of first and third is determined: third is
+     * then 0 and first takes all of the rotation. Both cases are blended in rather than branched to.
+     */
+    template<euler_order Order, typename T>
+    basic_euler_angles<T> to_euler(const basic_quaternion<T>& q);
+
+    /**
+     * Batch from_euler and to_euler, in and out must have the same size. The order may also be
+     * chosen at run time, it is then dispatched once per batch.
+     */
+    template<euler_order Order>
+    void from_euler(std::span<const euler_angles> in, std::span<quaternion> out);
+    template<euler_order Order>
+    void to_euler(std::span<const quaternion> in, std::span<euler_angles> out);
+    void from_euler(euler_order order, std::span<const euler_angles> in, std::span<quaternion> out);
+    void to_euler(euler_order order, std::span<const quaternion> in, std::span<euler_angles> out);
+
+    namespace fast {
+        /**
+         * Batch from_euler with the half angles going through the vectorized fast::sincos,
+         * components off by less than 4E-9
+         */
+        void from_euler(euler_order order, std::span<const euler_angles> in, std::span<quaternion> out);
+    }
+
+    namespace euler {
+        // distance in radians of the middle angle from its limits below which third is set to 0
+        inline constexpr double gimbal_lock = 1E-9;
+
+        // throws std::domain_error unless a batch has one output per input
+        void check_sizes(std::size_t in, std::size_t out);
+
+        /**
+         * Axes of an order as indices 0, 1, 2 for x, y, z
+         */
+        struct axes {
+            int first;
+            int second;
+            int third;
+            // first == third
+            bool proper;
+        };
+
+        constexpr axes axes_of(euler_order order) {
+            constexpr int sequences[][3] = {
+                {0, 1, 2}, {0, 2, 1}, {1, 0, 2}, {1, 2, 0}, {2, 0, 1}, {2, 1, 0},
+                {0, 1, 0}, {0, 2, 0}, {1, 0, 1}, {1, 2, 1}, {2, 0, 2}, {2, 1, 2},
+            };
+            const auto& s = sequences[static_cast<int>(order)];
+            return {s[0], s[1], s[2], s[0] == s[2]};
+        }
+
+        /**
+         * q * (c, s e_axis), touching only the components the axis requires
+         */
+        template<int Axis, typename T>
+        constexpr void multiply_axis(T& w, T (&v)[3], T c, T s) {
+            constexpr auto a1 = (Axis + 1) % 3;
+            constexpr auto a2 = (Axis + 2) % 3;
+            const auto w0 = w, v0 = v[Axis], v1 = v[a1], v2 = v[a2];
+            w = c * w0 - s * v0;
+            v[Axis] = c * v0 + s * w0;
+            v[a1] = c * v1 + s * v2;
+            v[a2] = c * v2 - s * v1;
+        }
+
+        /**
+         * q_first * q_second * q_third from the cosines and sines of the half angles
+         */
+        template<euler_order Order, typename T>
+        constexpr basic_quaternion<T> compose(T c1, T s1, T c2, T s2, T c3, T s3) {
+            constexpr auto axes = axes_of(Order);
+            auto w = c1;
+            T v[3] = {0, 0, 0};
+            v[axes.first] = s1;
+            multiply_axis<axes.second>(w, v, c2, s2);
+            multiply_axis<axes.third>(w, v, c3, s3);
+            return basic_quaternion<T>{w, v[0], v[1], v[2]};
+        }
+
+        /**
+         * x wrapped into (-π, π] for x in (-3π, 3π]
+         */
+        template<typename T>
+        T wrap(T x) {
+            const auto pi = T(M_PI);
+            return x + 2 * pi * (T(x <= -pi) - T(x > pi));
+        }
+    }
+
+    template<euler_order Order, typename T>
+    basic_quaternion<T> from_euler(const basic_euler_angles<T>& angles) {
+        return euler::compose<Order>(std::cos(angles.first / 2), std::sin(angles.first / 2),
+                                     std::cos(angles.second / 2), std::sin(angles.second / 2),
+                                     std::cos(angles.third / 2), std::sin(angles.third / 2));
+    }
+
+    template<euler_order Order, typename T>
+    basic_euler_angles<T> to_euler(const basic_quaternion<T>& q) {
+        // the method is stated for extrinsic rotations about i, j and k, which are the intrinsic
+        // ones about k, j and i; the last axis of a proper order is replaced by the unused one
+        constexpr auto axes = euler::axes_of(Order);
+        constexpr auto i = axes.third;
+        constexpr auto j = axes.second;
+        constexpr auto k = axes.proper ? 3 - i - j : axes.first;
+        constexpr auto parity = (i - j) * (j - k) * (k - i) / 2;
+        const T v[3] = {q.x, q.y, q.z};
+        const auto e = T(parity);
+        // (a, b, c, d) is q turned so that a Tait-Bryan order becomes a proper one
+        const auto a = axes.proper ? q.w : q.w - v[j];
+        const auto b = axes.proper ? v[i] : v[i] + e * v[k];
+        const auto c = axes.proper ? v[j] : v[j] + q.w;
+        const auto d = axes.proper ? e * v[k] : e * v[k] - v[i];
+
+        const auto middle = 2 * std::atan2(std::hypot(c, d), std::hypot(a, b));
+        const auto half_sum = std::atan2(b, a);
+        const auto half_difference = std::atan2(d, c);
+        // in gimbal lock the rotation about i is 0 and the one about k takes all of it: 2 half_sum
+        // at zero, 2 half_difference at π; blended with 0 and 1 rather than branched on
+        const auto at_zero = T(middle <= T(euler::gimbal_lock));
+        const auto at_pi = T(middle >= T(M_PI - euler::gimbal_lock));
+        const auto about_i = (1 - at_zero - at_pi) * (half_sum - half_difference);
+        const auto about_k = half_sum + half_difference + (at_zero - at_pi) * (half_sum - half_difference);
+        return {
+            euler::wrap(axes.proper ? about_k : e * about_k),
+            axes.proper ? middle : middle - T(M_PI_2),
+            euler::wrap(about_i),
+        };
+    }
+
+    template<euler_order Order>
+    void from_euler(std::span<const euler_angles> in, std::span<quaternion> out) {
+        euler::check_sizes(in.size(), out.size());
+        for (std::size_t i = 0; i < in.size(); ++i)
+            out[i] = from_euler<Order>(in[i]);
+    }
+
+    template<euler_order Order>
+    void to_euler(std::span<const quaternion> in, std::span<euler_angles> out) {
+        euler::check_sizes(in.size(), out.size());
+        for (std::size_t i = 0; i < in.size(); ++i)
+            out[i] = to_euler<Order>(in[i]);
+    }
+}
+
+#endif //QUATERNIONS_EULER_H
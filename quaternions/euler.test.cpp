@@ -0,0 +1,110 @@
+#include <catch2/catch_test_macros.hpp>
+#include <catch2/catch_template_test_macros.hpp>
+#include <catch2/matchers/catch_matchers_floating_point.hpp>
+#include "euler.h"
+#include "quaternion.h"
+#include <cmath>
+#include <stdexcept>
+#include <type_traits>
+#include <vector>
+#include "../test/helpers.h"
+
+namespace q = quaternions;
+using Catch::Matchers::WithinAbs;
+
+namespace {
+    template<q::euler_order Order>
+    using order = std::integral_constant<q::euler_order, Order>;
+
+    q::quaternion about_axis(int axis, double angle) {
+        auto v = q::xyz{0, 0, 0};
+        (axis == 0 ? v.x : axis == 1 ? v.y : v.z) = 1;
+        return q::quaternion::from_rotation({v, angle});
+    }
+
+    // q and -q are the same rotation
+    q::quaternion same_sign(const q::quaternion& q, const q::quaternion& reference) {
+        return q.dot(reference) < 0 ? -q : q;
+    }
+}
+
+TEMPLATE_TEST_CASE("Euler angles are intrinsic rotations about the axes of their order", "",
+                   order<q::euler_order::xyz>, order<q::euler_order::xzy>, order<q::euler_order::yxz>,
+                   order<q::euler_order::yzx>, order<q::euler_order::zxy>, order<q::euler_order::zyx>,
+                   order<q::euler_order::xyx>, order<q::euler_order::xzx>, order<q::euler_order::yxy>,
+                   order<q::euler_order::yzy>, order<q::euler_order::zxz>, order<q::euler_order::zyz>)
+{
+    constexpr auto o = TestType::value;
+    constexpr auto axes = q::euler::axes_of(o);
+    const auto angles = q::euler_angles{0.3, -1.1, 2.5};
+    const auto expected = about_axis(axes.first, angles.first) * about_axis(axes.second, angles.second)
+        * about_axis(axes.third, angles.third);
+    CHECK_THAT(q::from_euler<o>(angles), WithinAbs(expected));
+
+    const auto lower = axes.proper ? 0.0 : -M_PI_2;
+    for (const auto& r : random_unit_quaternions(1000, 1)) {
+        const auto e = q::to_euler<o>(r);
+        CHECK(std::abs(e.first) <= M_PI);
+        CHECK(std::abs(e.third) <= M_PI);
+        CHECK(e.second >= lower);
+        CHECK(e.second <= lower + M_PI);
+        CHECK_THAT(same_sign(q::from_euler<o>(e), r), WithinAbs(r));
+    }
+
+    // angles within their ranges come back unchanged
+    const auto middle = axes.proper ? 1.2 : -0.4;
+    const auto back = q::to_euler<o>(q::from_euler<o>(q::euler_angles{-2.9, middle, 1.7}));
+    CHECK_THAT(back.first, WithinAbs(-2.9, 1E-12));
+    CHECK_THAT(back.second, WithinAbs(middle, 1E-12));
+    CHECK_THAT(back.third, WithinAbs(1.7, 1E-12));
+}
+
+TEST_CASE("yaw, pitch and roll are the zyx order")
+{
+    const auto r = about_axis(2, 0.3) * about_axis(1, 0.2) * about_axis(0, 0.1);
+    const auto e = q::to_euler<q::euler_order::zyx>(r);
+    CHECK_THAT(e.first, WithinAbs(0.3, 1E-12));
+    CHECK_THAT(e.second, WithinAbs(0.2, 1E-12));
+    CHECK_THAT(e.third, WithinAbs(0.1, 1E-12));
+}
+
+TEST_CASE("in gimbal lock the third angle is zero and the first one takes the rotation")
+{
+    for (const auto pitch : {M_PI_2, -M_PI_2}) {
+        const auto r = q::from_euler<q::euler_order::zyx>(q::euler_angles{0.5, pitch, 0.2});
+        const auto e = q::to_euler<q::euler_order::zyx>(r);
+        CHECK(e.third == 0);
+        CHECK_THAT(e.second, WithinAbs(pitch, 1E-7));
+        CHECK_THAT(same_sign(q::from_euler<q::euler_order::zyx>(e), r), WithinAbs(r));
+    }
+    for (const auto nutation : {0.0, M_PI}) {
+        const auto r = q::from_euler<q::euler_order::zxz>(q::euler_angles{0.5, nutation, 0.2});
+        const auto e = q::to_euler<q::euler_order::zxz>(r);
+        CHECK(e.third == 0);
+        CHECK_THAT(e.second, WithinAbs(nutation, 1E-12));
+        CHECK_THAT(same_sign(q::from_euler<q::euler_order::zxz>(e), r), WithinAbs(r));
+    }
+    CHECK(q::to_euler<q::euler_order::xyz>(q::quaternion{1, 0, 0, 0}).first == 0);
+}
+
+TEST_CASE("batch Euler conversions match single ones for every order")
+{
+    const auto n = std::size_t{300};
+    const auto quaternions = random_unit_quaternions(n, 2);
+    auto angles = std::vector<q::euler_angles>(n);
+    auto exact = std::vector<q::quaternion>(n);
+    auto fast = std::vector<q::quaternion>(n);
+    for (const auto o : q::euler_orders) {
+        q::to_euler(o, quaternions, angles);
+        q::from_euler(o, angles, exact);
+        q::fast::from_euler(o, angles, fast);
+        for (std::size_t i = 0; i < n; ++i) {
+            CHECK_THAT(same_sign(exact[i], quaternions[i]), WithinAbs(quaternions[i]));
+            CHECK_THAT(fast[i], WithinAbs(exact[i], 4E-9));
+        }
+    }
+    CHECK(angles[7].first == q::to_euler<q::euler_order::zyz>(quaternions[7]).first);
+    auto too_short = std::vector<q::quaternion>(n - 1);
+    CHECK_THROWS_AS(q::from_euler(q::euler_order::xyz, angles, too_short), std::domain_error);
+    CHECK_THROWS_AS(q::fast::from_euler(q::euler_order::xyz, angles, too_short), std::domain_error);
+}
@@ -0,0 +1,48 @@
+#ifndef QUATERNIONS_EXECUTION_H
+#define QUATERNIONS_EXECUTION_H
+
+#include <cstddef>
+#include <functional>
+
+/**
+ * Execution policies for batch operations, in the spirit of std::execution
+ */
+namespace quaternions::execution {
+    /**
+     * Where parallel batch operations run their chunks, thread_pool::shared() unless a policy names
+     * another one
+     */
+    class executor {
+    public:
+        virtual ~executor() = default;
+
+        /**
+         * Number of chunks that may run at the same time
+         */
+        virtual std::size_t concurrency() const = 0;
+
+        /**
+         * Calls body(chunk) once for every chunk in [0, chunks) and returns when all of them are done.
+         * The first exception thrown by body is rethrown then.
+         */
+        virtual void bulk(std::size_t chunks, const std::function<void(std::size_t chunk)>& body) = 0;
+    };
+
+    struct sequenced_policy {};
+
+    struct parallel_policy {
+        executor* target = nullptr;
+
+        /**
+         * The same policy running on e, e.g. execution::par.on(pool)
+         */
+        constexpr parallel_policy on(executor& e) const {
+            return parallel_policy{&e};
+        }
+    };
+
+    inline constexpr sequenced_policy seq{};
+    inline constexpr parallel_policy par{};
+}
+
+#endif //QUATERNIONS_EXECUTION_H
@@ -0,0 +1,30 @@
+#include <catch2/catch_test_macros.hpp>
+#include <catch2/benchmark/catch_benchmark.hpp>
+#include "exponential.h"
+#include <vector>
+#include "../test/helpers.h"
+
+namespace q = quaternions;
+
+TEST_CASE("exponentials and logarithms")
+{
+    const auto quaternions = random_unit_quaternions(1000, 1);
+    BENCHMARK("exp x1000") {
+        auto sum = q::quaternion{0, 0, 0, 0};
+        for (const auto& v : quaternions)
+            sum = sum + q::exp(v);
+        return sum;
+    };
+    BENCHMARK("log x1000") {
+        auto sum = q::quaternion{0, 0, 0, 0};
+        for (const auto& v : quaternions)
+            sum = sum + q::log(v);
+        return sum;
+    };
+    BENCHMARK("pow x1000") {
+        auto sum = q::quaternion{0, 0, 0, 0};
+        for (const auto& v : quaternions)
+            sum = sum + q::pow(v, 0.3);
+        return sum;
+    };
+}
@@ -0,0 +1,74 @@
+#ifndef QUATERNIONS_EXPONENTIAL_H
+#define QUATERNIONS_EXPONENTIAL_H
+
+#include <cmath>
+#include <type_traits>
+#include "quaternion.h"
+
+namespace quaternions {
+    /**
+     * exp(w + v) = e^w (cos|v| + sin|v| v / |v|). For a pure quaternion (0, θ/2 axis) this is the
+     * unit quaternion rotating by θ around the unit axis.
+     */
+    template<typename T>
+    basic_quaternion<T> exp(const basic_quaternion<T>& q);
+
+    /**
+     * Principal logarithm ln|q| + angle v / |v| with angle in [0, π], the inverse of exp.
+     * Negative real quaternions have no unique logarithm, their vector part is taken along x.
+     */
+    template<typename T>
+    basic_quaternion<T> log(const basic_quaternion<T>& q);
+
+    /**
+     * q^t = exp(t log(q)), for unit quaternions the rotation scaled by t
+     */
+    template<typename T>
+    basic_quaternion<T> pow(const basic_quaternion<T>& q, std::type_identity_t<T> t);
+
+    namespace exponential {
+        // below this angle the series of sin(θ)/θ and θ/tan(θ) are used, their first
+        // omitted terms are far below the rounding error
+        inline constexpr double small_angle = 1E-3;
+        // Taylor polynomials of sin(θ) / θ and cos(θ) in θ², highest power first: their remainders
+        // stay below the rounding error for |θ| <= max_angle, the bound of the batch kernel
+        inline constexpr double max_angle = M_PI_4;
+        inline constexpr double sin[] = {-1.0 / 1307674368000, 1.0 / 6227020800, -1.0 / 39916800, 1.0 / 362880,
+                                         -1.0 / 5040, 1.0 / 120, -1.0 / 6, 1};
+        inline constexpr double cos[] = {1.0 / 20922789888000, -1.0 / 87178291200, 1.0 / 479001600,
+                                         -1.0 / 3628800, 1.0 / 40320, -1.0 / 720, 1.0 / 24, -0.5, 1};
+    }
+
+    template<typename T>
+    basic_quaternion<T> exp(const basic_quaternion<T>& q) {
+        const auto angle = q.vector().length();
+        const auto angle_squared = angle * angle;
+        // sin(θ)/θ = 1 - θ²/6 + θ⁴/120 - ...
+        const auto sinc = angle < T(exponential::small_angle)
+            ? 1 - angle_squared / 6 * (1 - angle_squared / 20)
+            : std::sin(angle) / angle;
+        const auto scale = std::exp(q.w);
+        return basic_quaternion<T>{scale * std::cos(angle), scale * sinc * q.x, scale * sinc * q.y, scale * sinc * q.z};
+    }
+
+    template<typename T>
+    basic_quaternion<T> log(const basic_quaternion<T>& q) {
+        const auto vector_length = q.vector().length();
+        const auto real = std::log(q.length());
+        if (vector_length == 0)
+            return basic_quaternion<T>{real, q.w < 0 ? T(M_PI) : T(0), 0, 0};
+        // atan2(s, w) / s = (1 - u²/3 + u⁴/5 - ...) / w with u = s / w
+        const auto u = vector_length / q.w;
+        const auto scale = q.w > 0 && u < T(exponential::small_angle)
+            ? (1 - u * u / 3 * (1 - u * u * 3 / 5)) / q.w
+            : std::atan2(vector_length, q.w) / vector_length;
+        return basic_quaternion<T>{real, scale * q.x, scale * q.y, scale * q.z};
+    }
+
+    template<typename T>
+    basic_quaternion<T> pow(const basic_quaternion<T>& q, std::type_identity_t<T> t) {
+        return exp(t * log(q));
+    }
+}
+
+#endif //QUATERNIONS_EXPONENTIAL_H
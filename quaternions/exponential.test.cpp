@@ -0,0 +1,76 @@
+#include <catch2/catch_test_macros.hpp>
+#include <catch2/catch_template_test_macros.hpp>
+#include <catch2/matchers/catch_matchers_floating_point.hpp>
+#include "exponential.h"
+#include "interpolation.h"
+#include <cmath>
+#include "../test/helpers.h"
+
+namespace q = quaternions;
+using Catch::Matchers::WithinAbs;
+
+TEST_CASE("exp of a pure quaternion is the rotation by twice its length")
+{
+    const auto axis = q::xyz{1, 2, -2}.normalized();
+    const auto r = q::exp(q::quaternion{0, 0.6 * axis.x, 0.6 * axis.y, 0.6 * axis.z});
+    CHECK_THAT(r, WithinAbs(q::quaternion::from_rotation({axis, 1.2})));
+    CHECK(q::exp(q::quaternion{0, 0, 0, 0}) == q::quaternion{1, 0, 0, 0});
+    CHECK_THAT(q::exp(q::quaternion{2, 0, 0, 0}), WithinAbs(q::quaternion{std::exp(2.0), 0, 0, 0}));
+}
+
+TEST_CASE("log inverts exp")
+{
+    for (const auto& v : random_quaternions(1000, 3))
+        CHECK_THAT(q::exp(q::log(v)), WithinAbs(v, 1E-12));
+    for (const auto& v : random_quaternions(1000, 4)) {
+        const auto p = q::quaternion{v.w / 10, v.x, v.y, v.z};
+        CHECK_THAT(q::log(q::exp(p)), WithinAbs(p, 1E-12));
+    }
+}
+
+TEST_CASE("exp and log keep full precision for small angles")
+{
+    for (const auto angle : {1E-5, 1E-8, 1E-12, 1E-150}) {
+        const auto v = q::quaternion{0, angle, -angle / 2, angle / 4};
+        const auto e = q::exp(v);
+        // sin(θ)/θ and cos(θ) to second order
+        const auto theta2 = angle * angle * (1 + 0.25 + 0.0625);
+        CHECK_THAT(e.w, WithinAbs(1 - theta2 / 2, 1E-16));
+        CHECK_THAT(e.x / angle, WithinAbs(1 - theta2 / 6, 1E-15));
+        CHECK_THAT(q::log(e).w, WithinAbs(0, 1E-15));
+        CHECK_THAT(q::log(e).x / angle, WithinAbs(1, 1E-15));
+        CHECK_THAT(q::log(e).z / angle, WithinAbs(0.25, 1E-15));
+    }
+}
+
+TEST_CASE("log of real quaternions")
+{
+    CHECK(q::log(q::quaternion{1, 0, 0, 0}) == q::quaternion{0, 0, 0, 0});
+    CHECK_THAT(q::log(q::quaternion{-2, 0, 0, 0}), WithinAbs(q::quaternion{std::log(2.0), M_PI, 0, 0}));
+    // rotations by almost a full turn stay accurate near w = -1
+    const auto r = q::quaternion::from_rotation({{0, 0, 1}, 2 * M_PI - 1E-6});
+    CHECK_THAT(q::log(r), WithinAbs(q::quaternion{0, 0, 0, M_PI - 5E-7}, 1E-15));
+}
+
+TEST_CASE("pow of unit quaternions scales the rotation")
+{
+    for (const auto& r : random_unit_quaternions(1000, 5)) {
+        const auto positive = r.w < 0 ? -1.0 * r : r;
+        CHECK_THAT(q::pow(positive, 0.3), WithinAbs(q::slerp(q::quaternion{1, 0, 0, 0}, positive, 0.3), 1E-12));
+        const auto root = q::pow(r, 0.5);
+        CHECK_THAT(root * root, WithinAbs(r, 1E-12));
+    }
+    const auto r = q::quaternion{1, 2, 3, 4};
+    CHECK_THAT(q::pow(r, 1), WithinAbs(r, 1E-12));
+    CHECK_THAT(q::pow(r, 2), WithinAbs(r * r, 1E-12));
+    CHECK_THAT(q::pow(r, 0), WithinAbs(q::quaternion{1, 0, 0, 0}));
+}
+
+TEMPLATE_TEST_CASE("exponentials for every scalar type", "", float, double, long double)
+{
+    const auto v = q::basic_quaternion<TestType>{TestType(0.5), TestType(0.1), TestType(-0.2), TestType(0.3)};
+    const auto back = q::exp(q::log(v));
+    CHECK(std::abs(back.w - v.w) < TestType(1E-6));
+    CHECK(std::abs(back.z - v.z) < TestType(1E-6));
+    CHECK(std::abs(q::pow(v, TestType(2)).w - (v * v).w) < TestType(1E-6));
+}
@@ -0,0 +1,47 @@
+#include <catch2/catch_test_macros.hpp>
+#include <catch2/benchmark/catch_benchmark.hpp>
+#include "expression.h"
+#include "quaternion.h"
+#include "xyz.h"
+#include <iterator>
+#include "../test/benchmarks.h"
+#include "../test/helpers.h"
+
+namespace q = quaternions;
+namespace lazy = quaternions::lazy;
+
+namespace {
+    const auto n_max = benchmark_batch_sizes[std::size(benchmark_batch_sizes) - 1];
+    const auto operands = random_quaternions(n_max, 1);
+    const auto rotations = random_unit_quaternions(n_max, 2);
+    const auto vectors = random_vectors(n_max, 3);
+}
+
+TEST_CASE("eager and lazy chained products")
+{
+    const auto& b = operands[1];
+    const auto& c = operands[2];
+    const auto& d = operands[3];
+    benchmark_batches("eager a * b * c * d", operands, [&](const q::quaternion& a) { return a * b * c * d; });
+    benchmark_batches("lazy a * b * c * d", operands, [&](const q::quaternion& a) {
+        return lazy::evaluate(lazy::ref(a) * b * c * d);
+    });
+    benchmark_batches("eager 2a + b / 2 - c", operands, [&](const q::quaternion& a) { return 2.0 * a + b * 0.5 - c; });
+    benchmark_batches("lazy 2a + b / 2 - c", operands, [&](const q::quaternion& a) {
+        return lazy::evaluate(2.0 * lazy::ref(a) + lazy::ref(b) * 0.5 - c);
+    });
+}
+
+TEST_CASE("eager and lazy sandwich products")
+{
+    const auto& v = vectors[0];
+    benchmark_batches("eager r * v * conjugated(r)", rotations, [&](const q::quaternion& r) {
+        return r * q::quaternion::from_vector(v) * r.conjugated();
+    });
+    benchmark_batches("lazy r * v * conjugated(r)", rotations, [&](const q::quaternion& r) {
+        return lazy::evaluate(lazy::ref(r) * lazy::pure(v) * lazy::conjugated(r));
+    });
+    benchmark_batches("sandwich", rotations, [&](const q::quaternion& r) {
+        return q::sandwich(r, q::quaternion::from_vector(v));
+    });
+}
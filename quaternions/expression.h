@@ -0,0 +1,240 @@
+#ifndef QUATERNIONS_EXPRESSION_H
+#define QUATERNIONS_EXPRESSION_H
+
+#include <concepts>
+#include <type_traits>
+#include "quaternion.h"
+#include "xyz.h"
+
+/**
+ * Opt-in lazy quaternion arithmetic: products, sums, differences, scalings and conjugations of
+ * expressions only record their operands until the expression is converted to a quaternion. The
+ * only rewrite is for sandwiches r * q * conjugated(r) of the same r, which are evaluated by
+ * sandwich(), with the real part skipped for pure q. All other expressions evaluate operand by
+ * operand into intermediate quaternions, just like the eager operators, and cost the same.
+ *
+ * Expressions hold references to their quaternion and vector operands, so they are meant to be
+ * converted within the full expression that builds them, not stored:
+ *
+ *     const quaternion rotated = lazy::ref(r) * lazy::pure(v) * lazy::conjugated(r);
+ */
+namespace quaternions::lazy {
+    template<typename E>
+    concept expression = requires(const E& e) {
+        typename E::value_type;
+        { E::pure } -> std::convertible_to<bool>;
+        { e.evaluate() } -> std::same_as<basic_quaternion<typename E::value_type>>;
+    };
+
+    template<typename A, typename B>
+    concept compatible = expression<A> && expression<B>
+        && std::same_as<typename A::value_type, typename B::value_type>;
+
+    /**
+     * Conversion to basic_quaternion shared by all expressions
+     */
+    template<typename E, typename T>
+    struct evaluates_to {
+        constexpr operator basic_quaternion<T>() const {
+            return static_cast<const E&>(*this).evaluate();
+        }
+    };
+
+    template<typename T>
+    struct reference : evaluates_to<reference<T>, T> {
+        using value_type = T;
+        static constexpr bool pure = false;
+        const basic_quaternion<T>& value;
+
+        explicit constexpr reference(const basic_quaternion<T>& q) : value(q) {}
+        constexpr basic_quaternion<T> evaluate() const { return value; }
+    };
+
+    /**
+     * The pure quaternion (0, v)
+     */
+    template<typename T>
+    struct vector : evaluates_to<vector<T>, T> {
+        using value_type = T;
+        static constexpr bool pure = true;
+        const basic_xyz<T>& value;
+
+        explicit constexpr vector(const basic_xyz<T>& v) : value(v) {}
+        constexpr basic_quaternion<T> evaluate() const { return basic_quaternion<T>::from_vector(value); }
+    };
+
+    template<expression E>
+    struct conjugate : evaluates_to<conjugate<E>, typename E::value_type> {
+        using value_type = typename E::value_type;
+        static constexpr bool pure = E::pure;
+        E operand;
+
+        explicit constexpr conjugate(E e) : operand(e) {}
+        constexpr basic_quaternion<value_type> evaluate() const { return operand.evaluate().conjugated(); }
+    };
+
+    template<expression E>
+    struct scaled : evaluates_to<scaled<E>, typename E::value_type> {
+        using value_type = typename E::value_type;
+        static constexpr bool pure = E::pure;
+        E operand;
+        value_type factor;
+
+        constexpr scaled(E e, value_type s) : operand(e), factor(s) {}
+        constexpr basic_quaternion<value_type> evaluate() const { return operand.evaluate() * factor; }
+    };
+
+    template<expression A, expression B> requires compatible<A, B>
+    struct sum : evaluates_to<sum<A, B>, typename A::value_type> {
+        using value_type = typename A::value_type;
+        static constexpr bool pure = A::pure && B::pure;
+        A left;
+        B right;
+
+        constexpr sum(A a, B b) : left(a), right(b) {}
+        constexpr basic_quaternion<value_type> evaluate() const { return left.evaluate() + right.evaluate(); }
+    };
+
+    template<expression A, expression B> requires compatible<A, B>
+    struct difference : evaluates_to<difference<A, B>, typename A::value_type> {
+        using value_type = typename A::value_type;
+        static constexpr bool pure = A::pure && B::pure;
+        A left;
+        B right;
+
+        constexpr difference(A a, B b) : left(a), right(b) {}
+        constexpr basic_quaternion<value_type> evaluate() const { return left.evaluate() - right.evaluate(); }
+    };
+
+    template<expression A, expression B> requires compatible<A, B>
+    struct product;
+
+    template<typename E>
+    inline constexpr bool is_reference = false;
+    template<typename T>
+    inline constexpr bool is_reference<reference<T>> = true;
+
+    /**
+     * Whether product<A, B> has the shape (r * q) * conjugate(r') with r and r' references
+     */
+    template<typename A, typename B>
+    inline constexpr bool is_sandwich = false;
+    template<typename R, typename M, typename R2>
+    inline constexpr bool is_sandwich<product<R, M>, conjugate<R2>> = is_reference<R> && is_reference<R2>;
+
+    template<expression A, expression B> requires compatible<A, B>
+    struct product : evaluates_to<product<A, B>, typename A::value_type> {
+        using value_type = typename A::value_type;
+        static constexpr bool pure = false;
+        A left;
+        B right;
+
+        constexpr product(A a, B b) : left(a), right(b) {}
+
+        constexpr basic_quaternion<value_type> evaluate() const {
+            if constexpr (is_sandwich<A, B>) {
+                const auto& r = left.left.value;
+                if (r == right.operand.value) {
+                    const auto q = left.right.evaluate();
+                    if constexpr (decltype(A::right)::pure) {
+                        const auto v = sandwich(r, basic_quaternion<value_type>{0, q.x, q.y, q.z});
+                        return basic_quaternion<value_type>{0, v.x, v.y, v.z};
+                    }
+                    return sandwich(r, q);
+                }
+            }
+            return left.evaluate() * right.evaluate();
+        }
+    };
+
+    template<typename T>
+    constexpr reference<T> ref(const basic_quaternion<T>& q) {
+        return reference<T>(q);
+    }
+
+    template<typename T>
+    constexpr vector<T> pure(const basic_xyz<T>& v) {
+        return vector<T>(v);
+    }
+
+    template<typename T>
+    constexpr conjugate<reference<T>> conjugated(const basic_quaternion<T>& q) {
+        return conjugate<reference<T>>(reference<T>(q));
+    }
+
+    template<expression E>
+    constexpr conjugate<E> conjugated(E e) {
+        return conjugate<E>(e);
+    }
+
+    template<expression A, expression B> requires compatible<A, B>
+    constexpr product<A, B> operator*(A a, B b) {
+        return {a, b};
+    }
+
+    template<expression A>
+    constexpr product<A, reference<typename A::value_type>>
+    operator*(A a, const basic_quaternion<typename A::value_type>& b) {
+        return {a, reference(b)};
+    }
+
+    template<expression B>
+    constexpr product<reference<typename B::value_type>, B>
+    operator*(const basic_quaternion<typename B::value_type>& a, B b) {
+        return {reference(a), b};
+    }
+
+    template<expression E>
+    constexpr scaled<E> operator*(E e, typename E::value_type s) {
+        return {e, s};
+    }
+
+    template<expression E>
+    constexpr scaled<E> operator*(typename E::value_type s, E e) {
+        return {e, s};
+    }
+
+    template<expression A, expression B> requires compatible<A, B>
+    constexpr sum<A, B> operator+(A a, B b) {
+        return {a, b};
+    }
+
+    template<expression A>
+    constexpr sum<A, reference<typename A::value_type>>
+    operator+(A a, const basic_quaternion<typename A::value_type>& b) {
+        return {a, reference(b)};
+    }
+
+    template<expression B>
+    constexpr sum<reference<typename B::value_type>, B>
+    operator+(const basic_quaternion<typename B::value_type>& a, B b) {
+        return {reference(a), b};
+    }
+
+    template<expression A, expression B> requires compatible<A, B>
+    constexpr difference<A, B> operator-(A a, B b) {
+        return {a, b};
+    }
+
+    template<expression A>
+    constexpr difference<A, reference<typename A::value_type>>
+    operator-(A a, const basic_quaternion<typename A::value_type>& b) {
+        return {a, reference(b)};
+    }
+
+    template<expression B>
+    constexpr difference<reference<typename B::value_type>, B>
+    operator-(const basic_quaternion<typename B::value_type>& a, B b) {
+        return {reference(a), b};
+    }
+
+    /**
+     * The quaternion an expression stands for, e.g. to pass it where a conversion is not implied
+     */
+    template<expression E>
+    constexpr basic_quaternion<typename E::value_type> evaluate(const E& e) {
+        return e.evaluate();
+    }
+}
+
+#endif //QUATERNIONS_EXPRESSION_H
@@ -0,0 +1,78 @@
+#include <catch2/catch_test_macros.hpp>
+#include "expression.h"
+#include "quaternion.h"
+#include <tuple>
+#include <type_traits>
+#include "../test/helpers.h"
+
+namespace q = quaternions;
+namespace lazy = quaternions::lazy;
+
+static_assert(lazy::expression<lazy::reference<double>>);
+static_assert(!lazy::expression<q::quaternion>);
+static_assert(lazy::is_sandwich<lazy::product<lazy::reference<double>, lazy::vector<double>>,
+                                 lazy::conjugate<lazy::reference<double>>>);
+static_assert(!lazy::is_sandwich<lazy::product<lazy::reference<double>, lazy::vector<double>>,
+                                  lazy::reference<double>>);
+static_assert(std::is_same_v<decltype(lazy::ref(q::quaternion{}) * q::quaternion{} * q::quaternion{}),
+                             lazy::product<lazy::product<lazy::reference<double>, lazy::reference<double>>,
+                                           lazy::reference<double>>>);
+
+TEST_CASE("lazy products match chained eager products")
+{
+    const auto operands = random_quaternions(400, 1);
+    for (std::size_t i = 0; i + 3 < operands.size(); i += 4) {
+        const auto& [a, b, c, d] = std::tie(operands[i], operands[i + 1], operands[i + 2], operands[i + 3]);
+        const q::quaternion lazy_product = lazy::ref(a) * b * c * d;
+        CHECK_THAT(lazy_product, WithinAbs(a * b * c * d, 1E-12));
+        const q::quaternion grouped = lazy::ref(a) * (lazy::ref(b) * c) * lazy::conjugated(d);
+        CHECK_THAT(grouped, WithinAbs(a * (b * c) * d.conjugated(), 1E-12));
+    }
+}
+
+TEST_CASE("lazy sums, differences and scalings match eager arithmetic")
+{
+    const auto operands = random_quaternions(300, 2);
+    for (std::size_t i = 0; i + 2 < operands.size(); i += 3) {
+        const auto& [a, b, c] = std::tie(operands[i], operands[i + 1], operands[i + 2]);
+        const q::quaternion combination = 2.0 * lazy::ref(a) + lazy::ref(b) * 0.5 - c;
+        CHECK_THAT(combination, WithinAbs(2.0 * a + b * 0.5 - c, 1E-12));
+        const q::quaternion mixed = a - (lazy::ref(b) * c + a) * 3.0;
+        CHECK_THAT(mixed, WithinAbs(a - (b * c + a) * 3.0, 1E-12));
+        CHECK_THAT(lazy::evaluate(lazy::conjugated(lazy::ref(a) - b)), WithinAbs((a - b).conjugated()));
+    }
+}
+
+TEST_CASE("lazy sandwiches are evaluated as rotations")
+{
+    const auto rotations = random_unit_quaternions(100, 3);
+    const auto operands = random_quaternions(100, 4);
+    const auto vectors = random_vectors(100, 5);
+    for (std::size_t i = 0; i < rotations.size(); ++i) {
+        const auto& r = rotations[i];
+        const auto& v = vectors[i];
+        const q::quaternion rotated = lazy::ref(r) * lazy::pure(v) * lazy::conjugated(r);
+        CHECK(rotated.w == 0);
+        CHECK_THAT(rotated, WithinAbs(r * q::quaternion::from_vector(v) * r.conjugated(), 1E-12));
+
+        // any quaternion and rotations which are not unit are allowed in the middle
+        const auto s = operands[i] * 3.0;
+        const q::quaternion general = lazy::ref(s) * operands[i] * lazy::conjugated(s);
+        CHECK_THAT(general, WithinAbs(s * operands[i] * s.conjugated(), 1E-10));
+
+        // different outer quaternions are plain products
+        const auto& t = rotations[(i + 1) % rotations.size()];
+        const q::quaternion unmatched = lazy::ref(r) * lazy::pure(v) * lazy::conjugated(t);
+        CHECK_THAT(unmatched, WithinAbs(r * q::quaternion::from_vector(v) * t.conjugated(), 1E-12));
+    }
+}
+
+TEST_CASE("lazy expressions are usable in constant expressions")
+{
+    constexpr auto a = q::quaternion{1, 2, 3, 4};
+    constexpr auto b = q::quaternion{0.5, -1, 0, 2};
+    constexpr q::quaternion product = lazy::ref(a) * b * lazy::conjugated(a);
+    static_assert(product == q::sandwich(a, b));
+    constexpr q::quaternion combination = lazy::ref(a) * 2.0 - b;
+    static_assert(combination == q::quaternion{1.5, 5, 6, 6});
+}
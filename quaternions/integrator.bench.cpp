@@ -0,0 +1,36 @@
+#include <catch2/catch_test_macros.hpp>
+#include <catch2/benchmark/catch_benchmark.hpp>
+#include "integrator.h"
+#include "exponential.h"
+#include <string>
+#include <vector>
+#include "../test/helpers.h"
+
+namespace q = quaternions;
+
+TEST_CASE("integrating angular velocities")
+{
+    // blocks of 10 ms of gyroscope samples at 10 kHz
+    constexpr std::size_t samples = 100;
+    constexpr double dt = 1E-4;
+    for (const std::size_t sensors : {16, 256}) {
+        const auto label = std::to_string(sensors) + " sensors x" + std::to_string(samples) + " samples";
+        const auto rates = random_vectors(sensors * samples, 1);
+
+        auto integrator = q::angular_velocity_integrator(sensors, dt);
+        BENCHMARK("integrator " + label) {
+            integrator.integrate(rates);
+            return integrator.orientations().w[0];
+        };
+
+        auto orientations = std::vector<q::quaternion>(sensors, q::quaternion{1, 0, 0, 0});
+        BENCHMARK("scalar exp and product " + label) {
+            for (std::size_t k = 0; k < rates.size(); k += sensors)
+                for (std::size_t i = 0; i < sensors; ++i) {
+                    const auto& w = rates[k + i];
+                    orientations[i] = orientations[i] * q::exp(q::quaternion{0, w.x, w.y, w.z} * (dt / 2));
+                }
+            return orientations[0];
+        };
+    }
+}
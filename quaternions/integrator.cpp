@@ -0,0 +1,91 @@
+#include "integrator.h"
+#include "dispatch.h"
+#include "exponential.h"
+#include <algorithm>
+#include <cmath>
+#include <stdexcept>
+#include <string>
+#include <utility>
+
+namespace q = quaternions;
+namespace k = quaternions::kernels;
+
+namespace {
+    // some 50000 rad per sample, far beyond any gyroscope; bounds the work one sample can cause
+    constexpr std::size_t max_substeps = 65536;
+}
+
+q::angular_velocity_integrator::angular_velocity_integrator(std::size_t sensors, double sample_period,
+                                                            std::size_t renormalize_every)
+    : angular_velocity_integrator(quaternion_batch(sensors), sample_period, renormalize_every) {
+    std::fill(q.w.begin(), q.w.end(), 1.0);
+}
+
+q::angular_velocity_integrator::angular_velocity_integrator(quaternion_batch initial, double sample_period,
+                                                            std::size_t renormalize_every)
+    : q(std::move(initial)), half_period(sample_period / 2), renormalize_every(renormalize_every) {
+    if (q.empty())
+        throw std::domain_error("an integrator needs at least one sensor!");
+    if (!(sample_period > 0))
+        throw std::domain_error("the sample period must be positive!");
+}
+
+std::size_t q::angular_velocity_integrator::sensors() const {
+    return q.size();
+}
+
+double q::angular_velocity_integrator::sample_period() const {
+    return 2 * half_period;
+}
+
+const q::quaternion_batch& q::angular_velocity_integrator::orientations() const {
+    return q;
+}
+
+void q::angular_velocity_integrator::integrate(std::span<const xyz> rates) {
+    if (rates.size() % sensors() != 0)
+        throw std::domain_error("angular velocities must come in whole samples of all sensors!");
+    for (std::size_t i = 0; i < rates.size(); i += sensors())
+        step(rates.data() + i);
+}
+
+void q::angular_velocity_integrator::integrate(std::span<const xyz> rates, std::span<quaternion> trajectory) {
+    if (rates.size() % sensors() != 0)
+        throw std::domain_error("angular velocities must come in whole samples of all sensors!");
+    if (trajectory.size() != rates.size())
+        throw std::domain_error("the trajectory needs one orientation per angular velocity!");
+    for (std::size_t i = 0; i < rates.size(); i += sensors()) {
+        step(rates.data() + i);
+        for (std::size_t j = 0; j < sensors(); ++j)
+            trajectory[i + j] = quaternion{q.w[j], q.x[j], q.y[j], q.z[j]};
+    }
+}
+
+void q::angular_velocity_integrator::step(const xyz* rates) {
+    static_assert(sizeof(xyz) == 3 * sizeof(double));
+    const auto n = sensors();
+    auto fastest = 0.0;
+    for (std::size_t i = 0; i < n; ++i) {
+        const auto squared = rates[i].x * rates[i].x + rates[i].y * rates[i].y + rates[i].z * rates[i].z;
+        if (!std::isfinite(squared))
+            throw std::domain_error("angular velocities must be finite!");
+        fastest = std::max(fastest, squared);
+    }
+    // the kernel is exact up to exponential::max_angle per step; faster rotations are split into
+    // equal substeps, which is exact too since the rate is constant over the sample
+    const auto steps = std::ceil(std::sqrt(fastest) * half_period / exponential::max_angle);
+    if (steps > static_cast<double>(max_substeps))
+        throw std::domain_error("angular velocities turn by more than " + std::to_string(max_substeps) +
+                                " steps of pi / 4 per sample!");
+    const auto substeps = std::max<std::size_t>(1, static_cast<std::size_t>(steps));
+    const auto& kernels = k::active();
+    const auto out = k::soa_out{q.w.data(), q.x.data(), q.y.data(), q.z.data()};
+    const auto substep = half_period / static_cast<double>(substeps);
+    for (std::size_t s = 0; s < substeps; ++s)
+        kernels.integrate(out, reinterpret_cast<const double*>(rates), substep, n);
+
+    if (renormalize_every != 0 && ++since_renormalization == renormalize_every) {
+        kernels.normalize(k::soa_in{q.w.data(), q.x.data(), q.y.data(), q.z.data()}, out, n);
+        since_renormalization = 0;
+    }
+}
@@ -0,0 +1,57 @@
+#ifndef QUATERNIONS_INTEGRATOR_H
+#define QUATERNIONS_INTEGRATOR_H
+
+#include <cstddef>
+#include <span>
+#include "quaternion.h"
+#include "quaternion_batch.h"
+#include "xyz.h"
+
+namespace quaternions {
+    /**
+     * Integrates body-frame angular velocities of many sensors sampled at a fixed rate, e.g. the
+     * gyroscopes of an IMU array, into orientations. Each sample advances every orientation by
+     * q = q * exp(dt/2 (0, ω)), which is exact for rates that are constant over a sample. All
+     * sensors are advanced together by one batch kernel, so the cost per sensor and sample is a
+     * handful of nanoseconds.
+     *
+     * Rounding makes the orientations drift away from unit length by about 1E-16 per sample,
+     * so they are renormalized after every renormalize_every samples.
+     */
+    class angular_velocity_integrator {
+    public:
+        /**
+         * Starts every sensor at the identity, renormalize_every = 0 never renormalizes.
+         * Throws std::domain_error for no sensors or a sample period that is not positive.
+         */
+        angular_velocity_integrator(std::size_t sensors, double sample_period, std::size_t renormalize_every = 1024);
+        angular_velocity_integrator(quaternion_batch initial, double sample_period, std::size_t renormalize_every = 1024);
+
+        std::size_t sensors() const;
+        double sample_period() const;
+        const quaternion_batch& orientations() const;
+
+        /**
+         * Integrates rates.size() / sensors() samples in rad/s, sample-major: rates[k * sensors() + i]
+         * is sample k of sensor i. Throws std::domain_error if rates is not made of whole samples,
+         * or on reaching a sample with a rate that is not finite or turns by more than some 50000 rad
+         * per sample; the samples before it stay integrated.
+         */
+        void integrate(std::span<const xyz> rates);
+        /**
+         * Same, additionally writing the orientations after every sample to trajectory, which is
+         * laid out like rates and must have the same size
+         */
+        void integrate(std::span<const xyz> rates, std::span<quaternion> trajectory);
+
+    private:
+        void step(const xyz* rates);
+
+        quaternion_batch q;
+        double half_period;
+        std::size_t renormalize_every;
+        std::size_t since_renormalization = 0;
+    };
+}
+
+#endif //QUATERNIONS_INTEGRATOR_H
@@ -0,0 +1,86 @@
+#include <catch2/catch_test_macros.hpp>
+#include <catch2/matchers/catch_matchers_floating_point.hpp>
+#include "integrator.h"
+#include "exponential.h"
+#include <cmath>
+#include <limits>
+#include <stdexcept>
+#include <vector>
+#include "../test/helpers.h"
+
+namespace q = quaternions;
+using Catch::Matchers::WithinAbs;
+
+TEST_CASE("integrating a constant rate gives the rotation by rate times time")
+{
+    // 37 sensors exercise full vector registers and the scalar tail
+    constexpr std::size_t sensors = 37;
+    constexpr std::size_t samples = 10000;
+    constexpr double dt = 1E-4;
+    const auto axes = random_vectors(sensors, 6);
+    auto rates = std::vector<q::xyz>{};
+    for (std::size_t k = 0; k < samples; ++k)
+        for (const auto& a : axes)
+            rates.push_back(20 * a);
+
+    // the last sample renormalizes
+    auto integrator = q::angular_velocity_integrator(sensors, dt, 1000);
+    integrator.integrate(std::span(rates).first(rates.size() / 2));
+    integrator.integrate(std::span(rates).last(rates.size() / 2));
+    for (std::size_t i = 0; i < sensors; ++i) {
+        const auto expected = q::exp(q::quaternion{0, axes[i].x, axes[i].y, axes[i].z} * (20 * samples * dt / 2));
+        CHECK_THAT(integrator.orientations()[i], WithinAbs(expected, 1E-11));
+        CHECK_THAT(integrator.orientations()[i].length(), WithinAbs(1, 1E-15));
+    }
+}
+
+TEST_CASE("integrating varying rates matches the product of exponentials")
+{
+    constexpr std::size_t sensors = 5;
+    constexpr double dt = 1E-3;
+    const auto initial = random_unit_quaternions(sensors, 7);
+    const auto rates = random_vectors(sensors * 200, 8);
+    auto trajectory = std::vector<q::quaternion>(rates.size());
+    auto integrator = q::angular_velocity_integrator(q::quaternion_batch::from(initial), dt, 16);
+    integrator.integrate(rates, trajectory);
+
+    auto expected = initial;
+    for (std::size_t k = 0; k < rates.size(); k += sensors)
+        for (std::size_t i = 0; i < sensors; ++i) {
+            const auto& w = rates[k + i];
+            expected[i] = expected[i] * q::exp(q::quaternion{0, w.x, w.y, w.z} * (dt / 2));
+            CHECK_THAT(trajectory[k + i], WithinAbs(expected[i], 1E-13));
+        }
+    CHECK(integrator.orientations()[sensors - 1] == trajectory.back());
+}
+
+TEST_CASE("fast rotations are integrated in substeps")
+{
+    // 2000 rad/s over 1 ms turns by 2 rad per sample, beyond the range of a single kernel step
+    const auto rates = std::vector<q::xyz>{{0, 0, 2000}, {0, 0, 0.5}};
+    auto integrator = q::angular_velocity_integrator(2, 1E-3);
+    integrator.integrate(rates);
+    CHECK_THAT(integrator.orientations()[0], WithinAbs(q::quaternion::from_rotation({{0, 0, 1}, 2}), 1E-14));
+    CHECK_THAT(integrator.orientations()[1], WithinAbs(q::quaternion::from_rotation({{0, 0, 1}, 5E-4}), 1E-15));
+}
+
+TEST_CASE("the integrator checks its arguments")
+{
+    CHECK_THROWS_AS(q::angular_velocity_integrator(0, 1E-3), std::domain_error);
+    CHECK_THROWS_AS(q::angular_velocity_integrator(2, 0), std::domain_error);
+    auto integrator = q::angular_velocity_integrator(2, 1E-3);
+    CHECK(integrator.sensors() == 2);
+    CHECK(integrator.sample_period() == 1E-3);
+    const auto rates = std::vector<q::xyz>(3);
+    CHECK_THROWS_AS(integrator.integrate(rates), std::domain_error);
+    auto trajectory = std::vector<q::quaternion>(3);
+    CHECK_THROWS_AS(integrator.integrate(std::span(rates).first(2), trajectory), std::domain_error);
+
+    // rates which would take endless substeps
+    const auto before = integrator.orientations().to_vector();
+    for (const auto rate : {std::numeric_limits<double>::infinity(), std::numeric_limits<double>::quiet_NaN(), 1E16}) {
+        const auto bad = std::vector<q::xyz>{{0, 0, 1}, {0, rate, 0}};
+        CHECK_THROWS_AS(integrator.integrate(bad), std::domain_error);
+    }
+    CHECK(integrator.orientations().to_vector() == before);
+}
@@ -0,0 +1,57 @@
+#include <catch2/catch_test_macros.hpp>
+#include <catch2/benchmark/catch_benchmark.hpp>
+#include "interpolation.h"
+#include <vector>
+#include "../test/benchmarks.h"
+#include "../test/helpers.h"
+
+namespace q = quaternions;
+
+TEST_CASE("slerp")
+{
+    const auto keys = random_unit_quaternions(2, 1);
+    BENCHMARK("slerp") { return q::slerp(keys[0], keys[1], 0.3); };
+    BENCHMARK("nlerp") { return q::nlerp(keys[0], keys[1], 0.3); };
+}
+
+TEST_CASE("track sampling")
+{
+    const auto keys = random_unit_quaternions(64, 2);
+    auto key_times = std::vector<double>{};
+    for (std::size_t i = 0; i < keys.size(); ++i)
+        key_times.push_back(static_cast<double>(i));
+    const auto track = q::track(key_times, keys);
+
+    for (const auto n : benchmark_batch_sizes) {
+        auto times = std::vector<double>(n);
+        for (std::size_t i = 0; i < n; ++i)
+            times[i] = 63.0 * static_cast<double>(i) / static_cast<double>(n);
+        auto out = std::vector<q::quaternion>(n);
+        BENCHMARK("track sample x" + batch_label(n)) {
+            track.sample(times, out);
+            return out[0];
+        };
+        BENCHMARK("slerp by hand x" + batch_label(n)) {
+            for (std::size_t i = 0; i < n; ++i) {
+                const auto key = static_cast<std::size_t>(times[i]);
+                out[i] = q::slerp(keys[key], keys[key + 1], times[i] - static_cast<double>(key));
+            }
+            return out[0];
+        };
+    }
+}
+
+TEST_CASE("sampling many tracks at once")
+{
+    const auto n_tracks = benchmark_batch_sizes[0];
+    const auto keys = random_unit_quaternions(8 * n_tracks, 3);
+    auto tracks = std::vector<q::track>{};
+    for (std::size_t i = 0; i < n_tracks; ++i)
+        tracks.emplace_back(std::vector<double>{0, 1, 2, 3, 4, 5, 6, 7},
+                            std::vector<q::quaternion>(keys.begin() + 8 * i, keys.begin() + 8 * i + 8));
+    auto out = std::vector<q::quaternion>(n_tracks);
+    BENCHMARK("sample tracks x" + batch_label(n_tracks)) {
+        q::sample(tracks, 3.3, out);
+        return out[0];
+    };
+}
@@ -0,0 +1,130 @@
+#include "interpolation.h"
+#include "dispatch.h"
+#include <algorithm>
+#include <cmath>
+#include <stdexcept>
+
+namespace q = quaternions;
+namespace k = quaternions::kernels;
+
+namespace {
+    constexpr std::size_t block_size = 128;
+
+    struct neighbours {
+        const q::quaternion& a;
+        const q::quaternion& b;
+        double t;
+        double angle;
+    };
+
+    /**
+     * Gathers the neighbouring keys and segment positions of block_size samples at a time into
+     * structure of arrays, computes their slerp weights together and blends them with the
+     * vectorized kernels
+     */
+    template<typename Gather>
+    void blend_blocks(std::size_t n, std::span<q::quaternion> out, Gather gather) {
+        double aw[block_size], ax[block_size], ay[block_size], az[block_size];
+        double bw[block_size], bx[block_size], by[block_size], bz[block_size];
+        double t[block_size], angle[block_size], wa[block_size], wb[block_size];
+        double ow[block_size], ox[block_size], oy[block_size], oz[block_size];
+        const auto& kernels = k::active();
+        for (std::size_t begin = 0; begin < n; begin += block_size) {
+            const auto count = std::min(block_size, n - begin);
+            for (std::size_t j = 0; j < count; ++j) {
+                const auto sample = gather(begin + j);
+                aw[j] = sample.a.w;
+                ax[j] = sample.a.x;
+                ay[j] = sample.a.y;
+                az[j] = sample.a.z;
+                bw[j] = sample.b.w;
+                bx[j] = sample.b.x;
+                by[j] = sample.b.y;
+                bz[j] = sample.b.z;
+                t[j] = sample.t;
+                angle[j] = sample.angle;
+            }
+            kernels.slerp_weights(t, angle, wa, wb, count);
+            kernels.blend({aw, ax, ay, az}, {bw, bx, by, bz}, wa, wb, {ow, ox, oy, oz}, count);
+            for (std::size_t j = 0; j < count; ++j)
+                out[begin + j] = q::quaternion{ow[j], ox[j], oy[j], oz[j]};
+        }
+    }
+}
+
+q::track::track(std::vector<double> times, std::vector<quaternion> keys)
+    : key_times(std::move(times)), key_values(std::move(keys)) {
+    if (key_times.empty() || key_times.size() != key_values.size())
+        throw std::domain_error("a track needs one key per key time and at least one key!");
+    for (std::size_t i = 1; i < key_times.size(); ++i)
+        if (!(key_times[i - 1] < key_times[i]))
+            throw std::domain_error("key times of a track must be strictly increasing!");
+
+    key_values[0] = key_values[0].normalized();
+    angles.reserve(key_values.size() - 1);
+    for (std::size_t i = 1; i < key_values.size(); ++i) {
+        auto& key = key_values[i];
+        key = key.normalized();
+        if (key_values[i - 1].dot(key) < 0)
+            key = -key;
+        // accurate for nearly parallel keys, unlike acos of the dot product
+        angles.push_back(2 * std::atan2((key - key_values[i - 1]).length(), (key + key_values[i - 1]).length()));
+    }
+}
+
+std::size_t q::track::size() const {
+    return key_values.size();
+}
+
+std::span<const double> q::track::times() const {
+    return key_times;
+}
+
+std::span<const q::quaternion> q::track::keys() const {
+    return key_values;
+}
+
+q::track::position q::track::position_at(double time) const {
+    // written so that NaN, which compares false either way, takes the first key too
+    if (size() == 1 || !(time > key_times.front()))
+        return {0, 0, size() == 1 ? 0 : angles.front()};
+    if (time >= key_times.back())
+        return {size() - 2, 1, angles.back()};
+
+    const auto key = static_cast<std::size_t>(
+        std::upper_bound(key_times.begin(), key_times.end(), time) - key_times.begin() - 1);
+    return {key, (time - key_times[key]) / (key_times[key + 1] - key_times[key]), angles[key]};
+}
+
+q::track::weights q::track::weights_at(double time) const {
+    const auto [key, t, angle] = position_at(time);
+    auto weights = track::weights{key, 0, 0};
+    k::active().slerp_weights(&t, &angle, &weights.a, &weights.b, 1);
+    return weights;
+}
+
+q::quaternion q::track::sample(double time) const {
+    const auto weights = weights_at(time);
+    const auto& a = key_values[weights.key];
+    const auto& b = key_values[std::min(weights.key + 1, size() - 1)];
+    return (weights.a * a + weights.b * b).normalized();
+}
+
+void q::track::sample(std::span<const double> times, std::span<quaternion> out) const {
+    if (times.size() != out.size())
+        throw std::domain_error("sampling a track needs one output per time!");
+    blend_blocks(times.size(), out, [&](std::size_t i) {
+        const auto [key, t, angle] = position_at(times[i]);
+        return neighbours{key_values[key], key_values[std::min(key + 1, size() - 1)], t, angle};
+    });
+}
+
+void q::sample(std::span<const track> tracks, double time, std::span<quaternion> out) {
+    if (tracks.size() != out.size())
+        throw std::domain_error("sampling tracks needs one output per track!");
+    blend_blocks(tracks.size(), out, [&](std::size_t i) {
+        const auto& track = tracks[i];
+        const auto [key, t, angle] = track.position_at(time);
+        return neighbours{track.key_values[key], track.key_values[std::min(key + 1, track.size() - 1)], t, angle};
+    });
+}
@@ -0,0 +1,100 @@
+#ifndef QUATERNIONS_INTERPOLATION_H
+#define QUATERNIONS_INTERPOLATION_H
+#include <cmath>
+#include <cstddef>
+#include <span>
+#include <type_traits>
+#include <vector>
+#include "quaternion.h"
+
+namespace quaternions {
+    /**
+     * Spherical linear interpolation between two unit quaternions along the shortest path,
+     * t = 0 gives a and t = 1 gives b (or -b)
+     */
+    template<typename T>
+    basic_quaternion<T> slerp(const basic_quaternion<T>& a, const basic_quaternion<T>& b, std::type_identity_t<T> t);
+
+    /**
+     * Normalized linear interpolation along the shortest path: cheaper than slerp, but does not
+     * move with constant angular velocity
+     */
+    template<typename T>
+    basic_quaternion<T> nlerp(const basic_quaternion<T>& a, const basic_quaternion<T>& b, std::type_identity_t<T> t);
+
+    /**
+     * Unit quaternion keyframes at strictly increasing times, sampled with slerp between
+     * neighbouring keys and clamped to the first and last key outside of them. A NaN time
+     * samples the first key.
+     * The angle of each segment is computed once on construction, the slerp weights of all
+     * samples by the vectorized slerp_weights kernel, a block of samples at a time.
+     */
+    class track {
+    public:
+        track(std::vector<double> times, std::vector<quaternion> keys);
+
+        std::size_t size() const;
+        std::span<const double> times() const;
+        /**
+         * Keys with their signs flipped where necessary so that neighbouring keys have a
+         * non-negative dot product
+         */
+        std::span<const quaternion> keys() const;
+
+        quaternion sample(double time) const;
+        void sample(std::span<const double> times, std::span<quaternion> out) const;
+
+        /**
+         * Neighbouring keys and their slerp weights at the given time
+         */
+        struct weights {
+            std::size_t key;
+            double a;
+            double b;
+        };
+        weights weights_at(double time) const;
+
+    private:
+        /**
+         * Segment of the given time and the fraction t of it that has passed
+         */
+        struct position {
+            std::size_t key;
+            double t;
+            double angle;
+        };
+        position position_at(double time) const;
+
+        friend void sample(std::span<const track> tracks, double time, std::span<quaternion> out);
+
+        std::vector<double> key_times;
+        std::vector<quaternion> key_values;
+        std::vector<double> angles;
+    };
+
+    /**
+     * Samples every track at the same time
+     */
+    void sample(std::span<const track> tracks, double time, std::span<quaternion> out);
+
+    template<typename T>
+    basic_quaternion<T> slerp(const basic_quaternion<T>& a, const basic_quaternion<T>& b, std::type_identity_t<T> t) {
+        const auto d = a.dot(b);
+        const auto sign = d < 0 ? T(-1) : T(1);
+        const auto cos_angle = sign * d;
+        if (cos_angle > T(1) - default_eps<T>)
+            return nlerp(a, b, t);
+        const auto angle = std::acos(cos_angle);
+        const auto inverse_sin_angle = 1 / std::sin(angle);
+        return std::sin((1 - t) * angle) * inverse_sin_angle * a +
+               sign * std::sin(t * angle) * inverse_sin_angle * b;
+    }
+
+    template<typename T>
+    basic_quaternion<T> nlerp(const basic_quaternion<T>& a, const basic_quaternion<T>& b, std::type_identity_t<T> t) {
+        const auto sign = a.dot(b) < 0 ? T(-1) : T(1);
+        return ((1 - t) * a + sign * t * b).normalized();
+    }
+}
+
+#endif //QUATERNIONS_INTERPOLATION_H
@@ -0,0 +1,104 @@
+#include <catch2/catch_test_macros.hpp>
+#include <catch2/matchers/catch_matchers_floating_point.hpp>
+#include "interpolation.h"
+#include "quaternion.h"
+#include <cmath>
+#include <limits>
+#include <vector>
+#include "../test/helpers.h"
+
+namespace q = quaternions;
+using Catch::Matchers::WithinAbs;
+
+namespace {
+    q::quaternion about_z(double angle) {
+        return q::quaternion::from_rotation({{0, 0, 1}, angle});
+    }
+}
+
+TEST_CASE("slerp moves with constant angular velocity")
+{
+    const auto a = about_z(0);
+    const auto b = about_z(M_PI_2);
+    CHECK_THAT(q::slerp(a, b, 0.0), WithinAbs(a));
+    CHECK_THAT(q::slerp(a, b, 1.0), WithinAbs(b));
+    CHECK_THAT(q::slerp(a, b, 0.25), WithinAbs(about_z(M_PI_2 * 0.25)));
+    CHECK_THAT(q::slerp(a, b, 0.7), WithinAbs(about_z(M_PI_2 * 0.7)));
+}
+
+TEST_CASE("slerp and nlerp take the shortest path")
+{
+    const auto a = about_z(0.1);
+    const auto b = -about_z(0.5);
+    CHECK_THAT(q::slerp(a, b, 0.5), WithinAbs(about_z(0.3)));
+    CHECK_THAT(q::nlerp(a, b, 0.5), WithinAbs(about_z(0.3)));
+}
+
+TEST_CASE("track samples match slerp between neighbouring keys")
+{
+    const auto keys = random_unit_quaternions(6, 1);
+    const auto times = std::vector<double>{0, 0.5, 1.5, 2, 4, 4.25};
+    const auto track = q::track(times, keys);
+    for (std::size_t i = 0; i + 1 < times.size(); ++i) {
+        for (const auto t : {0.0, 0.3, 0.5, 0.9}) {
+            const auto time = times[i] + t * (times[i + 1] - times[i]);
+            const auto expected = q::slerp(keys[i], keys[i + 1], t);
+            const auto sampled = track.sample(time);
+            // q and -q are the same rotation
+            CHECK_THAT(std::abs(sampled.dot(expected)), WithinAbs(1, 1E-12));
+        }
+    }
+}
+
+TEST_CASE("track clamps outside of its keys")
+{
+    const auto track = q::track({1, 2}, {about_z(0.2), about_z(0.4)});
+    CHECK_THAT(track.sample(0), WithinAbs(about_z(0.2)));
+    CHECK_THAT(track.sample(3), WithinAbs(about_z(0.4)));
+    CHECK_THAT(q::track({1}, {about_z(0.2)}).sample(5), WithinAbs(about_z(0.2)));
+
+    const auto nan = std::numeric_limits<double>::quiet_NaN();
+    const auto weights = track.weights_at(nan);
+    CHECK(weights.key == 0);
+    CHECK(weights.a == 1);
+    CHECK_THAT(track.sample(nan), WithinAbs(about_z(0.2)));
+    const auto times = std::vector<double>{nan, 1.5};
+    auto out = std::vector<q::quaternion>(2);
+    track.sample(times, out);
+    CHECK_THAT(out[0], WithinAbs(about_z(0.2)));
+}
+
+TEST_CASE("track with nearly parallel keys")
+{
+    const auto track = q::track({0, 1}, {about_z(1), about_z(1 + 1E-5)});
+    CHECK_THAT(track.sample(0.5), WithinAbs(about_z(1 + 0.5E-5), 1E-15));
+    CHECK_THAT(track.sample(0.1), WithinAbs(about_z(1 + 0.1E-5), 1E-15));
+}
+
+TEST_CASE("batch sampling matches single samples")
+{
+    const auto track_keys = random_unit_quaternions(4 * 300, 2);
+    auto tracks = std::vector<q::track>{};
+    for (std::size_t i = 0; i < 300; ++i)
+        tracks.emplace_back(std::vector<double>{0, 1, 2, 3 + i * 0.01},
+                            std::vector<q::quaternion>(track_keys.begin() + 4 * i, track_keys.begin() + 4 * i + 4));
+    auto out = std::vector<q::quaternion>(tracks.size());
+    q::sample(tracks, 2.7, out);
+    for (std::size_t i = 0; i < tracks.size(); ++i)
+        CHECK_THAT(out[i], WithinAbs(tracks[i].sample(2.7)));
+
+    auto times = std::vector<double>{};
+    for (std::size_t i = 0; i < 500; ++i)
+        times.push_back(-0.5 + i * 0.01);
+    auto samples = std::vector<q::quaternion>(times.size());
+    tracks[0].sample(times, samples);
+    for (std::size_t i = 0; i < times.size(); ++i)
+        CHECK_THAT(samples[i], WithinAbs(tracks[0].sample(times[i])));
+}
+
+TEST_CASE("track keys and times must match")
+{
+    CHECK_THROWS(q::track({}, {}));
+    CHECK_THROWS(q::track({0, 1}, {about_z(0)}));
+    CHECK_THROWS(q::track({1, 1}, {about_z(0), about_z(1)}));
+}
@@ -0,0 +1,13 @@
+// Compiled with the compiler flags for this instruction set level, see CMakeLists.txt
+#include "batch_kernels.h"
+
+namespace q = quaternions;
+
+const q::kernels::table* q::kernels::avx2_table() {
+#if defined(__AVX2__) && defined(__FMA__)
+    static constexpr auto kernels = make_table<simd::avx2>(isa::avx2);
+    return &kernels;
+#else
+    return nullptr;
+#endif
+}
@@ -0,0 +1,13 @@
+// Compiled with the compiler flags for this instruction set level, see CMakeLists.txt
+#include "batch_kernels.h"
+
+namespace q = quaternions;
+
+const q::kernels::table* q::kernels::avx512_table() {
+#if defined(__AVX512F__)
+    static constexpr auto kernels = make_table<simd::avx512>(isa::avx512);
+    return &kernels;
+#else
+    return nullptr;
+#endif
+}
@@ -0,0 +1,8 @@
+#include "batch_kernels.h"
+
+namespace q = quaternions;
+
+const q::kernels::table* q::kernels::scalar_table() {
+    static constexpr auto kernels = make_table<simd::scalar>(isa::scalar);
+    return &kernels;
+}
@@ -0,0 +1,13 @@
+// Compiled with the compiler flags for this instruction set level, see CMakeLists.txt
+#include "batch_kernels.h"
+
+namespace q = quaternions;
+
+const q::kernels::table* q::kernels::sse2_table() {
+#if defined(__SSE2__)
+    static constexpr auto kernels = make_table<simd::sse2>(isa::sse2);
+    return &kernels;
+#else
+    return nullptr;
+#endif
+}
@@ -0,0 +1,127 @@
+#include <catch2/catch_test_macros.hpp>
+#include <catch2/benchmark/catch_benchmark.hpp>
+#include "lock_free.h"
+#include "quaternion.h"
+#include <atomic>
+#include <deque>
+#include <mutex>
+#include <optional>
+#include <string>
+#include <thread>
+
+namespace q = quaternions;
+
+namespace {
+    /**
+     * The baseline: the latest pose and a history guarded by one mutex each
+     */
+    class locked_pose {
+    public:
+        void store(const q::pose& p) {
+            const auto lock = std::lock_guard{mutex};
+            value = p;
+        }
+
+        q::pose load() {
+            const auto lock = std::lock_guard{mutex};
+            return value;
+        }
+
+    private:
+        std::mutex mutex;
+        q::pose value{};
+    };
+
+    class locked_ring {
+    public:
+        bool try_push(const q::pose& p) {
+            const auto lock = std::lock_guard{mutex};
+            if (values.size() == 1024)
+                return false;
+            values.push_back(p);
+            return true;
+        }
+
+        std::optional<q::pose> try_pop() {
+            const auto lock = std::lock_guard{mutex};
+            if (values.empty())
+                return std::nullopt;
+            const auto p = values.front();
+            values.pop_front();
+            return p;
+        }
+
+    private:
+        std::mutex mutex;
+        std::deque<q::pose> values;
+    };
+
+    q::pose pose_of(double i) {
+        return q::pose{q::quaternion{i, 0, 0, 0}, q::xyz{i, 0, 0}};
+    }
+
+    /**
+     * Times 1000 reads of the latest pose while another thread keeps storing new ones
+     */
+    template<typename Latest, typename Load>
+    void benchmark_reads(const std::string& name, Latest& latest, Load load) {
+        auto done = std::atomic<bool>{false};
+        auto writer = std::thread([&] {
+            for (double i = 0; !done.load(std::memory_order_relaxed); ++i)
+                latest.store(pose_of(i));
+        });
+        BENCHMARK(name + " reads x1000 during writes") {
+            auto sum = 0.0;
+            for (int i = 0; i < 1000; ++i)
+                sum += load().orientation.w;
+            return sum;
+        };
+        done = true;
+        writer.join();
+    }
+
+    /**
+     * Times passing 1000 poses from another thread through the ring
+     */
+    template<typename Ring>
+    void benchmark_ring(const std::string& name, Ring& ring) {
+        BENCHMARK(name + " x1000 between threads") {
+            auto producer = std::thread([&] {
+                for (int i = 0; i < 1000; ++i)
+                    while (!ring.try_push(pose_of(i)))
+                        std::this_thread::yield();
+            });
+            auto sum = 0.0;
+            for (int received = 0; received < 1000;) {
+                if (const auto p = ring.try_pop()) {
+                    sum += p->orientation.w;
+                    ++received;
+                } else {
+                    std::this_thread::yield();
+                }
+            }
+            producer.join();
+            return sum;
+        };
+    }
+}
+
+TEST_CASE("publishing the latest pose under contention")
+{
+    auto locked = locked_pose{};
+    benchmark_reads("mutex", locked, [&] { return locked.load(); });
+    auto sequenced = q::seqlock<q::pose>{};
+    benchmark_reads("seqlock", sequenced, [&] { return sequenced.load(); });
+    auto triple = q::triple_buffer<q::pose>{};
+    benchmark_reads("triple_buffer", triple, [&] { return triple.load(); });
+}
+
+TEST_CASE("pose history rings under contention")
+{
+    auto locked = locked_ring{};
+    benchmark_ring("mutex deque", locked);
+    auto spsc = q::spsc_ring<q::pose>(1024);
+    benchmark_ring("spsc_ring", spsc);
+    auto mpsc = q::mpsc_ring<q::pose>(1024);
+    benchmark_ring("mpsc_ring", mpsc);
+}
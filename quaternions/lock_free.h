@@ -0,0 +1,279 @@
+#ifndef QUATERNIONS_LOCK_FREE_H
+#define QUATERNIONS_LOCK_FREE_H
+
+#include <algorithm>
+#include <atomic>
+#include <bit>
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <memory>
+#include <optional>
+#include <stdexcept>
+#include <thread>
+#include <type_traits>
+#include "quaternion.h"
+#include "xyz.h"
+
+/**
+ * Lock-free hand-over of orientations between threads, e.g. from a sensor thread to render and
+ * control threads: seqlock and triple_buffer publish the latest value, spsc_ring and mpsc_ring
+ * keep a bounded history. All of them copy trivially copyable values and never allocate after
+ * construction.
+ */
+namespace quaternions {
+    /**
+     * Orientation and position sampled together
+     */
+    struct pose {
+        quaternion orientation;
+        xyz position;
+    };
+
+    namespace lock_free {
+        // members written by different threads are kept this far apart to avoid false sharing
+        inline constexpr std::size_t cache_line = 64;
+    }
+
+    /**
+     * Latest value of one writer thread for any number of reader threads. store is wait-free,
+     * load retries only while a store overlaps it and always returns a value written by a single
+     * store, never a mix of two.
+     */
+    template<typename T>
+    class seqlock {
+        static_assert(std::is_trivially_copyable_v<T>);
+
+    public:
+        explicit seqlock(const T& initial = T{}) {
+            write(initial);
+        }
+
+        /**
+         * Must only be called by one thread at a time
+         */
+        void store(const T& value) {
+            const auto s = sequence.load(std::memory_order_relaxed);
+            sequence.store(s + 1, std::memory_order_relaxed);
+            std::atomic_thread_fence(std::memory_order_release);
+            write(value);
+            sequence.store(s + 2, std::memory_order_release);
+        }
+
+        T load() const {
+            std::uint64_t buffer[word_count];
+            while (true) {
+                const auto s = sequence.load(std::memory_order_acquire);
+                if (s & 1) {
+                    std::this_thread::yield();
+                    continue;
+                }
+                for (std::size_t i = 0; i < word_count; ++i)
+                    buffer[i] = words[i].load(std::memory_order_relaxed);
+                std::atomic_thread_fence(std::memory_order_acquire);
+                if (sequence.load(std::memory_order_relaxed) == s)
+                    break;
+            }
+            auto value = T{};
+            std::memcpy(&value, buffer, sizeof(T));
+            return value;
+        }
+
+        /**
+         * Number of stores so far
+         */
+        std::uint64_t version() const {
+            return sequence.load(std::memory_order_acquire) / 2;
+        }
+
+    private:
+        static constexpr std::size_t word_count = (sizeof(T) + 7) / 8;
+
+        void write(const T& value) {
+            std::uint64_t buffer[word_count] = {};
+            std::memcpy(buffer, &value, sizeof(T));
+            for (std::size_t i = 0; i < word_count; ++i)
+                words[i].store(buffer[i], std::memory_order_relaxed);
+        }
+
+        alignas(lock_free::cache_line) std::atomic<std::uint64_t> sequence = 0;
+        // atomic words, so that a load overlapping a store is a retry rather than a data race
+        std::atomic<std::uint64_t> words[word_count];
+    };
+
+    /**
+     * Latest value of one writer thread for one reader thread, both wait-free: the writer fills a
+     * back slot and swaps it with the middle one, the reader swaps its front slot with the middle
+     * one if that holds something newer. Neither ever waits for the other.
+     */
+    template<typename T>
+    class triple_buffer {
+        static_assert(std::is_trivially_copyable_v<T>);
+
+    public:
+        explicit triple_buffer(const T& initial = T{}) : slots{initial, initial, initial} {}
+
+        /**
+         * Must only be called by the writer thread
+         */
+        void store(const T& value) {
+            slots[back] = value;
+            back = middle.exchange(back | fresh, std::memory_order_acq_rel) & index;
+        }
+
+        /**
+         * Must only be called by the reader thread, the reference stays valid until its next load
+         */
+        const T& load() {
+            if (middle.load(std::memory_order_relaxed) & fresh)
+                front = middle.exchange(front, std::memory_order_acq_rel) & index;
+            return slots[front];
+        }
+
+    private:
+        static constexpr std::uint8_t index = 3;
+        static constexpr std::uint8_t fresh = 4;
+
+        T slots[3];
+        alignas(lock_free::cache_line) std::atomic<std::uint8_t> middle = 1;
+        alignas(lock_free::cache_line) std::uint8_t back = 2;
+        alignas(lock_free::cache_line) std::uint8_t front = 0;
+    };
+
+    namespace lock_free {
+        inline std::size_t ring_capacity(std::size_t requested) {
+            if (requested == 0)
+                throw std::domain_error("a ring needs a capacity of at least one!");
+            return std::bit_ceil(std::max<std::size_t>(requested, 2));
+        }
+    }
+
+    /**
+     * Bounded first-in first-out queue between one producer and one consumer thread, both
+     * wait-free. The capacity is rounded up to a power of two.
+     */
+    template<typename T>
+    class spsc_ring {
+        static_assert(std::is_trivially_copyable_v<T>);
+
+    public:
+        explicit spsc_ring(std::size_t capacity)
+            : mask(lock_free::ring_capacity(capacity) - 1), slots(std::make_unique<T[]>(mask + 1)) {}
+
+        std::size_t capacity() const {
+            return mask + 1;
+        }
+
+        /**
+         * false if the ring is full
+         */
+        bool try_push(const T& value) {
+            const auto t = tail.load(std::memory_order_relaxed);
+            if (t - cached_head > mask) {
+                cached_head = head.load(std::memory_order_acquire);
+                if (t - cached_head > mask)
+                    return false;
+            }
+            slots[t & mask] = value;
+            tail.store(t + 1, std::memory_order_release);
+            return true;
+        }
+
+        /**
+         * Oldest value, or nullopt if the ring is empty
+         */
+        std::optional<T> try_pop() {
+            const auto h = head.load(std::memory_order_relaxed);
+            if (h == cached_tail) {
+                cached_tail = tail.load(std::memory_order_acquire);
+                if (h == cached_tail)
+                    return std::nullopt;
+            }
+            const auto value = slots[h & mask];
+            head.store(h + 1, std::memory_order_release);
+            return value;
+        }
+
+    private:
+        const std::size_t mask;
+        const std::unique_ptr<T[]> slots;
+        // the consumer's position and its last sight of the producer's, and the other way round
+        alignas(lock_free::cache_line) std::atomic<std::size_t> head = 0;
+        std::size_t cached_tail = 0;
+        alignas(lock_free::cache_line) std::atomic<std::size_t> tail = 0;
+        std::size_t cached_head = 0;
+    };
+
+    /**
+     * Bounded first-in first-out queue from any number of producer threads to one consumer
+     * thread. Every slot carries a sequence number telling whose turn it is (Vyukov's bounded
+     * queue), so producers only contend on claiming a position. Values of one producer keep
+     * their order. The capacity is rounded up to a power of two.
+     */
+    template<typename T>
+    class mpsc_ring {
+        static_assert(std::is_trivially_copyable_v<T>);
+
+    public:
+        explicit mpsc_ring(std::size_t capacity)
+            : mask(lock_free::ring_capacity(capacity) - 1), cells(std::make_unique<cell[]>(mask + 1)) {
+            for (std::size_t i = 0; i <= mask; ++i)
+                cells[i].sequence.store(i, std::memory_order_relaxed);
+        }
+
+        std::size_t capacity() const {
+            return mask + 1;
+        }
+
+        /**
+         * false if the ring is full
+         */
+        bool try_push(const T& value) {
+            auto position = tail.load(std::memory_order_relaxed);
+            while (true) {
+                auto& c = cells[position & mask];
+                const auto sequence = c.sequence.load(std::memory_order_acquire);
+                const auto lag = static_cast<std::ptrdiff_t>(sequence - position);
+                if (lag == 0) {
+                    if (tail.compare_exchange_weak(position, position + 1, std::memory_order_relaxed))
+                        break;
+                } else if (lag < 0) {
+                    return false;
+                } else {
+                    position = tail.load(std::memory_order_relaxed);
+                }
+            }
+            auto& c = cells[position & mask];
+            c.value = value;
+            c.sequence.store(position + 1, std::memory_order_release);
+            return true;
+        }
+
+        /**
+         * Oldest value, or nullopt if the ring is empty or its oldest value is still being written
+         */
+        std::optional<T> try_pop() {
+            auto& c = cells[head & mask];
+            if (c.sequence.load(std::memory_order_acquire) != head + 1)
+                return std::nullopt;
+            const auto value = c.value;
+            c.sequence.store(head + mask + 1, std::memory_order_release);
+            ++head;
+            return value;
+        }
+
+    private:
+        struct cell {
+            std::atomic<std::size_t> sequence;
+            T value;
+        };
+
+        const std::size_t mask;
+        const std::unique_ptr<cell[]> cells;
+        alignas(lock_free::cache_line) std::atomic<std::size_t> tail = 0;
+        // only touched by the consumer
+        alignas(lock_free::cache_line) std::size_t head = 0;
+    };
+}
+
+#endif //QUATERNIONS_LOCK_FREE_H
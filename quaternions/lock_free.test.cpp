@@ -0,0 +1,166 @@
+#include <catch2/catch_test_macros.hpp>
+#include "lock_free.h"
+#include "quaternion.h"
+#include <atomic>
+#include <cstddef>
+#include <stdexcept>
+#include <thread>
+#include <vector>
+
+namespace q = quaternions;
+
+namespace {
+    // every component of the i-th pose is i, so that a mix of two poses is easy to spot
+    q::pose pose_of(double i) {
+        return q::pose{q::quaternion{i, i, i, i}, q::xyz{i, i, i}};
+    }
+
+    bool consistent(const q::pose& p) {
+        const auto i = p.orientation.w;
+        return p.orientation == q::quaternion{i, i, i, i} && p.position.x == i && p.position.y == i
+            && p.position.z == i;
+    }
+}
+
+TEST_CASE("a seqlock returns the latest stored value")
+{
+    auto latest = q::seqlock<q::quaternion>(q::quaternion{1, 0, 0, 0});
+    CHECK(latest.load() == q::quaternion{1, 0, 0, 0});
+    CHECK(latest.version() == 0);
+    latest.store(q::quaternion{0, 1, 2, 3});
+    CHECK(latest.load() == q::quaternion{0, 1, 2, 3});
+    CHECK(latest.version() == 1);
+}
+
+TEST_CASE("seqlock readers never see a mix of two poses")
+{
+    auto latest = q::seqlock<q::pose>(pose_of(0));
+    auto done = std::atomic<bool>{false};
+    auto torn = std::atomic<int>{0};
+    auto readers = std::vector<std::thread>{};
+    for (int r = 0; r < 3; ++r)
+        readers.emplace_back([&] {
+            auto previous = 0.0;
+            while (!done) {
+                const auto p = latest.load();
+                if (!consistent(p) || p.orientation.w < previous)
+                    ++torn;
+                previous = p.orientation.w;
+            }
+        });
+    for (int i = 1; i <= 200'000; ++i)
+        latest.store(pose_of(i));
+    done = true;
+    for (auto& reader : readers)
+        reader.join();
+    CHECK(torn == 0);
+    CHECK(latest.load().orientation.w == 200'000);
+}
+
+TEST_CASE("a triple buffer hands the newest value to its reader")
+{
+    auto buffer = q::triple_buffer<q::xyz>(q::xyz{1, 2, 3});
+    CHECK(buffer.load().x == 1);
+    buffer.store(q::xyz{4, 5, 6});
+    buffer.store(q::xyz{7, 8, 9});
+    CHECK(buffer.load().x == 7);
+    CHECK(buffer.load().z == 9);
+}
+
+TEST_CASE("triple buffer reads are consistent and never go back in time")
+{
+    auto buffer = q::triple_buffer<q::pose>(pose_of(0));
+    auto done = std::atomic<bool>{false};
+    auto torn = 0;
+    auto reader = std::thread([&] {
+        auto previous = 0.0;
+        while (!done) {
+            const auto& p = buffer.load();
+            if (!consistent(p) || p.orientation.w < previous)
+                ++torn;
+            previous = p.orientation.w;
+        }
+    });
+    for (int i = 1; i <= 200'000; ++i)
+        buffer.store(pose_of(i));
+    done = true;
+    reader.join();
+    CHECK(torn == 0);
+    CHECK(buffer.load().orientation.w == 200'000);
+}
+
+TEST_CASE("rings round their capacity up to a power of two and report full and empty")
+{
+    CHECK(q::spsc_ring<q::quaternion>(5).capacity() == 8);
+    CHECK(q::mpsc_ring<q::quaternion>(1).capacity() == 2);
+    CHECK_THROWS_AS(q::spsc_ring<q::quaternion>(0), std::domain_error);
+
+    auto spsc = q::spsc_ring<int>(4);
+    auto mpsc = q::mpsc_ring<int>(4);
+    for (int i = 0; i < 4; ++i) {
+        CHECK(spsc.try_push(i));
+        CHECK(mpsc.try_push(i));
+    }
+    CHECK(!spsc.try_push(4));
+    CHECK(!mpsc.try_push(4));
+    for (int i = 0; i < 4; ++i) {
+        CHECK(spsc.try_pop() == i);
+        CHECK(mpsc.try_pop() == i);
+    }
+    CHECK(spsc.try_pop() == std::nullopt);
+    CHECK(mpsc.try_pop() == std::nullopt);
+}
+
+TEST_CASE("an spsc ring passes every pose in order")
+{
+    const auto n = 100'000;
+    auto ring = q::spsc_ring<q::pose>(64);
+    auto producer = std::thread([&] {
+        for (int i = 0; i < n; ++i)
+            while (!ring.try_push(pose_of(i)))
+                std::this_thread::yield();
+    });
+    auto in_order = true;
+    for (int i = 0; i < n;) {
+        if (const auto p = ring.try_pop()) {
+            in_order &= consistent(*p) && p->orientation.w == i;
+            ++i;
+        } else {
+            std::this_thread::yield();
+        }
+    }
+    producer.join();
+    CHECK(in_order);
+}
+
+TEST_CASE("an mpsc ring passes the poses of every producer in their order")
+{
+    const auto producers = 4;
+    const auto per_producer = 25'000;
+    auto ring = q::mpsc_ring<q::pose>(64);
+    auto threads = std::vector<std::thread>{};
+    for (int id = 0; id < producers; ++id)
+        threads.emplace_back([&, id] {
+            for (int i = 0; i < per_producer; ++i) {
+                auto p = pose_of(i);
+                p.position.x = id;
+                while (!ring.try_push(p))
+                    std::this_thread::yield();
+            }
+        });
+    auto next = std::vector<int>(producers);
+    auto in_order = true;
+    for (int received = 0; received < producers * per_producer;) {
+        if (const auto p = ring.try_pop()) {
+            const auto id = static_cast<std::size_t>(p->position.x);
+            in_order &= p->orientation.w == next[id]++;
+            ++received;
+        } else {
+            std::this_thread::yield();
+        }
+    }
+    for (auto& thread : threads)
+        thread.join();
+    CHECK(in_order);
+    CHECK(next == std::vector<int>(producers, per_producer));
+}
@@ -0,0 +1,45 @@
+#include <catch2/catch_test_macros.hpp>
+#include <catch2/benchmark/catch_benchmark.hpp>
+#include "orientation_filter.h"
+#include <string>
+#include <vector>
+#include "../test/helpers.h"
+
+namespace q = quaternions;
+
+TEST_CASE("orientation filters")
+{
+    // one second of noisy readings at 1 kHz
+    constexpr std::size_t samples = 1000;
+    constexpr double dt = 1E-3;
+    for (const std::size_t sensors : {16, 256}) {
+        const auto label = std::to_string(sensors) + " sensors x" + std::to_string(samples) + " samples";
+        const auto recording = synthetic_imu(sensors, samples, dt, 0.01);
+        const auto imu = q::imu_samples{recording.gyroscope, recording.accelerometer, {}};
+        const auto marg = q::imu_samples{recording.gyroscope, recording.accelerometer, recording.magnetometer};
+
+        auto madgwick = q::madgwick_filter(sensors, dt);
+        BENCHMARK("Madgwick without magnetometers " + label) {
+            madgwick.update(imu);
+            return madgwick.orientations().w[0];
+        };
+        BENCHMARK("Madgwick with magnetometers " + label) {
+            madgwick.update(marg);
+            return madgwick.orientations().w[0];
+        };
+        auto mahony = q::mahony_filter(sensors, dt, 1, 0.1);
+        BENCHMARK("Mahony without magnetometers " + label) {
+            mahony.update(imu);
+            return mahony.orientations().w[0];
+        };
+        BENCHMARK("Mahony with magnetometers " + label) {
+            mahony.update(marg);
+            return mahony.orientations().w[0];
+        };
+        auto estimates = std::vector<q::quaternion>(recording.truth.size());
+        BENCHMARK("Mahony with magnetometers and estimates " + label) {
+            mahony.update(marg, estimates);
+            return estimates.back();
+        };
+    }
+}
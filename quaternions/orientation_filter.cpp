@@ -0,0 +1,138 @@
+#include "orientation_filter.h"
+#include "dispatch.h"
+#include <algorithm>
+#include <stdexcept>
+#include <utility>
+
+namespace q = quaternions;
+namespace k = quaternions::kernels;
+
+namespace {
+    q::quaternion_batch identities(std::size_t n) {
+        auto result = q::quaternion_batch(n);
+        std::fill(result.w.begin(), result.w.end(), 1.0);
+        return result;
+    }
+
+    void check_settings(const q::quaternion_batch& initial, double sample_period) {
+        if (initial.empty())
+            throw std::domain_error("an orientation filter needs at least one sensor!");
+        if (!(sample_period > 0))
+            throw std::domain_error("the sample period must be positive!");
+    }
+
+    void check_samples(const q::imu_samples& samples, std::size_t sensors) {
+        const auto n = samples.gyroscope.size();
+        if (n % sensors != 0)
+            throw std::domain_error("readings must come in whole samples of all sensors!");
+        if (samples.accelerometer.size() != n || !(samples.magnetometer.empty() || samples.magnetometer.size() == n))
+            throw std::domain_error("every kind of sensor needs the same number of readings!");
+    }
+
+    void check_estimates(const q::imu_samples& samples, std::span<q::quaternion> estimates) {
+        if (estimates.size() != samples.gyroscope.size())
+            throw std::domain_error("the estimates need one orientation per reading!");
+    }
+
+    /**
+     * Calls step(readings) for every sample
+     */
+    template<typename Step>
+    void for_each_sample(const q::imu_samples& samples, std::size_t sensors, Step step) {
+        static_assert(sizeof(q::xyz) == 3 * sizeof(double));
+        const auto pointer = [](std::span<const q::xyz> s, std::size_t i) {
+            return s.empty() ? nullptr : reinterpret_cast<const double*>(s.data() + i);
+        };
+        for (std::size_t i = 0; i < samples.gyroscope.size(); i += sensors)
+            step(k::imu_readings{
+                pointer(samples.gyroscope, i),
+                pointer(samples.accelerometer, i),
+                pointer(samples.magnetometer, i),
+            }, i);
+    }
+
+    void copy_estimates(const q::quaternion_batch& q, std::span<q::quaternion> estimates, std::size_t i) {
+        for (std::size_t j = 0; j < q.size(); ++j)
+            estimates[i + j] = q::quaternion{q.w[j], q.x[j], q.y[j], q.z[j]};
+    }
+
+    k::soa_out view(q::quaternion_batch& b) {
+        return {b.w.data(), b.x.data(), b.y.data(), b.z.data()};
+    }
+}
+
+q::madgwick_filter::madgwick_filter(std::size_t sensors, double sample_period, double beta)
+    : madgwick_filter(identities(sensors), sample_period, beta) {}
+
+q::madgwick_filter::madgwick_filter(quaternion_batch initial, double sample_period, double beta)
+    : q(std::move(initial)), sample_period(sample_period), beta(beta) {
+    check_settings(q, sample_period);
+}
+
+std::size_t q::madgwick_filter::sensors() const {
+    return q.size();
+}
+
+const q::quaternion_batch& q::madgwick_filter::orientations() const {
+    return q;
+}
+
+void q::madgwick_filter::update(const imu_samples& samples) {
+    check_samples(samples, sensors());
+    const auto& kernels = k::active();
+    for_each_sample(samples, sensors(), [&](const k::imu_readings& readings, std::size_t) {
+        kernels.madgwick(view(q), readings, sample_period, beta, sensors());
+    });
+}
+
+void q::madgwick_filter::update(const imu_samples& samples, std::span<quaternion> estimates) {
+    check_samples(samples, sensors());
+    check_estimates(samples, estimates);
+    const auto& kernels = k::active();
+    for_each_sample(samples, sensors(), [&](const k::imu_readings& readings, std::size_t i) {
+        kernels.madgwick(view(q), readings, sample_period, beta, sensors());
+        copy_estimates(q, estimates, i);
+    });
+}
+
+q::mahony_filter::mahony_filter(std::size_t sensors, double sample_period, double kp, double ki)
+    : mahony_filter(identities(sensors), sample_period, kp, ki) {}
+
+q::mahony_filter::mahony_filter(quaternion_batch initial, double sample_period, double kp, double ki)
+    : q(std::move(initial)),
+      integral_x(q.size()),
+      integral_y(q.size()),
+      integral_z(q.size()),
+      sample_period(sample_period),
+      kp(kp),
+      ki(ki) {
+    check_settings(q, sample_period);
+}
+
+std::size_t q::mahony_filter::sensors() const {
+    return q.size();
+}
+
+const q::quaternion_batch& q::mahony_filter::orientations() const {
+    return q;
+}
+
+void q::mahony_filter::update(const imu_samples& samples) {
+    check_samples(samples, sensors());
+    const auto& kernels = k::active();
+    const auto integral = k::soa_vectors{integral_x.data(), integral_y.data(), integral_z.data()};
+    for_each_sample(samples, sensors(), [&](const k::imu_readings& readings, std::size_t) {
+        kernels.mahony(view(q), integral, readings, sample_period, kp, ki, sensors());
+    });
+}
+
+void q::mahony_filter::update(const imu_samples& samples, std::span<quaternion> estimates) {
+    check_samples(samples, sensors());
+    check_estimates(samples, estimates);
+    const auto& kernels = k::active();
+    const auto integral = k::soa_vectors{integral_x.data(), integral_y.data(), integral_z.data()};
+    for_each_sample(samples, sensors(), [&](const k::imu_readings& readings, std::size_t i) {
+        kernels.mahony(view(q), integral, readings, sample_period, kp, ki, sensors());
+        copy_estimates(q, estimates, i);
+    });
+}
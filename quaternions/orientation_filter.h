@@ -0,0 +1,87 @@
+#ifndef QUATERNIONS_ORIENTATION_FILTER_H
+#define QUATERNIONS_ORIENTATION_FILTER_H
+
+#include <cstddef>
+#include <span>
+#include "quaternion.h"
+#include "quaternion_batch.h"
+#include "xyz.h"
+
+namespace quaternions {
+    /**
+     * Readings of many sensors, sample-major: gyroscope[k * sensors + i] is sample k of sensor i.
+     * Rates are in rad/s. Accelerometers and magnetometers only contribute directions, so their
+     * units do not matter, and a zero reading is skipped. magnetometer is empty without one.
+     */
+    struct imu_samples {
+        std::span<const xyz> gyroscope;
+        std::span<const xyz> accelerometer;
+        std::span<const xyz> magnetometer;
+    };
+
+    /**
+     * Madgwick's gradient descent orientation filter, run for many independent sensors at once.
+     * Estimates turn sensor into earth coordinates, with z pointing up and, given magnetometers,
+     * x pointing to magnetic north. beta is the correction rate in rad/s: higher values converge
+     * faster and trust the gyroscopes less.
+     */
+    class madgwick_filter {
+    public:
+        /**
+         * Starts every sensor at the identity. Throws std::domain_error for no sensors or a sample
+         * period that is not positive.
+         */
+        madgwick_filter(std::size_t sensors, double sample_period, double beta = 0.1);
+        madgwick_filter(quaternion_batch initial, double sample_period, double beta = 0.1);
+
+        std::size_t sensors() const;
+        const quaternion_batch& orientations() const;
+
+        /**
+         * Runs all samples through the filter. Throws std::domain_error unless the readings are
+         * whole samples of all sensors, of the same count for every kind of sensor.
+         */
+        void update(const imu_samples& samples);
+        /**
+         * Same, additionally writing the estimates after every sample to estimates, which is laid
+         * out like the readings and must have the same size
+         */
+        void update(const imu_samples& samples, std::span<quaternion> estimates);
+
+    private:
+        quaternion_batch q;
+        double sample_period;
+        double beta;
+    };
+
+    /**
+     * Mahony's complementary orientation filter, run for many independent sensors at once, with the
+     * same conventions as madgwick_filter. The rates are corrected by kp times the error between
+     * the measured and predicted directions plus ki times its integral, which cancels gyroscope
+     * bias. The error is the full cross product of the directions, so kp and ki are half the
+     * reference implementation's twoKp and twoKi; the defaults match its 2Kp = 1, 2Ki = 0.
+     */
+    class mahony_filter {
+    public:
+        mahony_filter(std::size_t sensors, double sample_period, double kp = 0.5, double ki = 0);
+        mahony_filter(quaternion_batch initial, double sample_period, double kp = 0.5, double ki = 0);
+
+        std::size_t sensors() const;
+        const quaternion_batch& orientations() const;
+
+        void update(const imu_samples& samples);
+        void update(const imu_samples& samples, std::span<quaternion> estimates);
+
+    private:
+        quaternion_batch q;
+        // integral feedback per sensor, as structure of arrays
+        quaternion_batch::storage integral_x;
+        quaternion_batch::storage integral_y;
+        quaternion_batch::storage integral_z;
+        double sample_period;
+        double kp;
+        double ki;
+    };
+}
+
+#endif //QUATERNIONS_ORIENTATION_FILTER_H
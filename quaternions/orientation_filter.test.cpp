@@ -0,0 +1,198 @@
+#include <catch2/catch_test_macros.hpp>
+#include <catch2/matchers/catch_matchers_floating_point.hpp>
+#include "orientation_filter.h"
+#include "integrator.h"
+#include <algorithm>
+#include <cmath>
+#include <stdexcept>
+#include <vector>
+#include "../test/helpers.h"
+
+namespace q = quaternions;
+using Catch::Matchers::WithinAbs;
+
+namespace {
+    double angle_between(const q::quaternion& a, const q::quaternion& b) {
+        return 2 * std::acos(std::min(1.0, std::abs(a.dot(b))));
+    }
+
+    /**
+     * Largest angle between estimates and truth over the sensors of the last sample
+     */
+    double final_error(const std::vector<q::quaternion>& estimates, const std::vector<q::quaternion>& truth,
+                       std::size_t sensors) {
+        auto worst = 0.0;
+        for (std::size_t i = truth.size() - sensors; i < truth.size(); ++i)
+            worst = std::max(worst, angle_between(estimates[i], truth[i]));
+        return worst;
+    }
+
+    /**
+     * The recording with every sensor held still in its first orientation
+     */
+    imu_recording stationary(imu_recording recording, std::size_t sensors) {
+        for (std::size_t k = 0; k < recording.truth.size(); ++k) {
+            recording.truth[k] = recording.truth[k % sensors];
+            recording.gyroscope[k] = q::xyz{0, 0, 0};
+            recording.accelerometer[k] = recording.accelerometer[k % sensors];
+            recording.magnetometer[k] = recording.magnetometer[k % sensors];
+        }
+        return recording;
+    }
+}
+
+TEST_CASE("Madgwick's filter converges to moving sensors")
+{
+    // 37 sensors exercise full vector registers and the scalar tail
+    constexpr std::size_t sensors = 37;
+    constexpr double dt = 0.01;
+    const auto recording = synthetic_imu(sensors, 3000, dt);
+    auto estimates = std::vector<q::quaternion>(recording.truth.size());
+
+    auto filter = q::madgwick_filter(sensors, dt, 1);
+    filter.update({recording.gyroscope, recording.accelerometer, recording.magnetometer}, estimates);
+    // both filters correct the previous estimate with the current readings, which puts them about
+    // one sample ahead: |w| dt <= 0.017 here
+    CHECK(final_error(estimates, recording.truth, sensors) < 0.05);
+    CHECK(filter.orientations()[sensors - 1] == estimates.back());
+
+    // without magnetometers only the direction of gravity is observable
+    auto tilt = q::madgwick_filter(sensors, dt, 1);
+    tilt.update({recording.gyroscope, recording.accelerometer, {}});
+    for (std::size_t i = 0; i < sensors; ++i) {
+        const auto measured = recording.accelerometer[recording.accelerometer.size() - sensors + i];
+        const auto up = tilt.orientations()[i] * q::quaternion::from_vector(measured) * tilt.orientations()[i].conjugated();
+        CHECK_THAT(up.vector(), WithinAbs(q::xyz{0, 0, 1}, 0.05));
+    }
+
+    // still sensors are only off by the normalized gradient step of beta dt
+    const auto still = stationary(recording, sensors);
+    auto settled = q::madgwick_filter(sensors, dt, 1);
+    settled.update({still.gyroscope, still.accelerometer, still.magnetometer}, estimates);
+    CHECK(final_error(estimates, still.truth, sensors) < 0.02);
+}
+
+TEST_CASE("Mahony's filter converges to moving sensors")
+{
+    constexpr std::size_t sensors = 37;
+    constexpr double dt = 0.01;
+    const auto recording = synthetic_imu(sensors, 3000, dt, 0, 2);
+    auto estimates = std::vector<q::quaternion>(recording.truth.size());
+    auto filter = q::mahony_filter(sensors, dt, 5);
+    filter.update({recording.gyroscope, recording.accelerometer, recording.magnetometer}, estimates);
+    CHECK(final_error(estimates, recording.truth, sensors) < 0.03);
+
+    // and exactly on still sensors
+    const auto still = stationary(recording, sensors);
+    auto settled = q::mahony_filter(sensors, dt, 5);
+    settled.update({still.gyroscope, still.accelerometer, still.magnetometer}, estimates);
+    CHECK(final_error(estimates, still.truth, sensors) < 1E-5);
+}
+
+TEST_CASE("Mahony's integral feedback cancels gyroscope bias")
+{
+    constexpr std::size_t sensors = 8;
+    constexpr double dt = 0.01;
+    auto recording = stationary(synthetic_imu(sensors, 3000, dt, 0, 3), sensors);
+    for (auto& w : recording.gyroscope)
+        w = w + q::xyz{0.02, -0.03, 0.01};
+    const auto samples = q::imu_samples{recording.gyroscope, recording.accelerometer, recording.magnetometer};
+    auto estimates = std::vector<q::quaternion>(recording.truth.size());
+
+    auto proportional = q::mahony_filter(sensors, dt, 5);
+    proportional.update(samples, estimates);
+    // off by about |bias| / kp
+    CHECK(final_error(estimates, recording.truth, sensors) > 3E-3);
+
+    auto integral = q::mahony_filter(sensors, dt, 5, 1);
+    integral.update(samples, estimates);
+    CHECK(final_error(estimates, recording.truth, sensors) < 1E-3);
+}
+
+TEST_CASE("a Mahony step matches the reference implementation")
+{
+    // MahonyAHRSupdateIMU with twoKp = 1 and twoKi = 1, starting from a zero integral
+    constexpr double dt = 0.01;
+    const auto initial = q::quaternion{0.9, 0.1, -0.3, 0.2}.normalized();
+    const auto gyroscope = q::xyz{0.3, -0.2, 0.5};
+    const auto accelerometer = q::xyz{0.2, 0.4, 9.7};
+    const auto q0 = initial.w, q1 = initial.x, q2 = initial.y, q3 = initial.z;
+    const auto a = accelerometer.normalized();
+    const auto half_v = q::xyz{q1 * q3 - q0 * q2, q0 * q1 + q2 * q3, q0 * q0 - 0.5 + q3 * q3};
+    const auto half_e = q::xyz{a.y * half_v.z - a.z * half_v.y, a.z * half_v.x - a.x * half_v.z,
+                               a.x * half_v.y - a.y * half_v.x};
+    const auto reference = [&](double two_ki) {
+        const auto g = (gyroscope + half_e * (two_ki * dt) + half_e) * (0.5 * dt);
+        return q::quaternion{q0 - q1 * g.x - q2 * g.y - q3 * g.z, q1 + q0 * g.x + q2 * g.z - q3 * g.y,
+                             q2 + q0 * g.y - q1 * g.z + q3 * g.x, q3 + q0 * g.z + q1 * g.y - q2 * g.x}.normalized();
+    };
+
+    // 5 sensors run both vector registers and the scalar tail
+    constexpr std::size_t sensors = 5;
+    auto initials = q::quaternion_batch();
+    for (std::size_t i = 0; i < sensors; ++i)
+        initials.push_back(initial);
+    const auto gyroscopes = std::vector<q::xyz>(sensors, gyroscope);
+    const auto accelerometers = std::vector<q::xyz>(sensors, accelerometer);
+    const auto samples = q::imu_samples{gyroscopes, accelerometers, {}};
+
+    auto defaults = q::mahony_filter(initials, dt);
+    defaults.update(samples);
+    auto integral = q::mahony_filter(initials, dt, 0.5, 0.5);
+    integral.update(samples);
+    for (std::size_t i = 0; i < sensors; ++i) {
+        CHECK_THAT(defaults.orientations()[i], WithinAbs(reference(0), 1E-12));
+        CHECK_THAT(integral.orientations()[i], WithinAbs(reference(1), 1E-12));
+    }
+}
+
+TEST_CASE("without accelerometer readings both filters integrate the rates")
+{
+    constexpr std::size_t sensors = 5;
+    constexpr double dt = 1E-3;
+    const auto recording = synthetic_imu(sensors, 1000, dt, 0, 4);
+    const auto still = std::vector<q::xyz>(recording.gyroscope.size());
+    const auto samples = q::imu_samples{recording.gyroscope, still, {}};
+
+    auto integrator = q::angular_velocity_integrator(sensors, dt);
+    integrator.integrate(recording.gyroscope);
+    auto madgwick = q::madgwick_filter(sensors, dt);
+    madgwick.update(samples);
+    auto mahony = q::mahony_filter(sensors, dt, 1, 1);
+    mahony.update(samples);
+    for (std::size_t i = 0; i < sensors; ++i) {
+        CHECK_THAT(madgwick.orientations()[i], WithinAbs(integrator.orientations()[i], 1E-6));
+        CHECK_THAT(mahony.orientations()[i], WithinAbs(integrator.orientations()[i], 1E-6));
+    }
+}
+
+TEST_CASE("the filters track noisy readings")
+{
+    constexpr std::size_t sensors = 16;
+    constexpr double dt = 0.01;
+    const auto recording = synthetic_imu(sensors, 3000, dt, 0.01, 5);
+    const auto samples = q::imu_samples{recording.gyroscope, recording.accelerometer, recording.magnetometer};
+    auto estimates = std::vector<q::quaternion>(recording.truth.size());
+    q::madgwick_filter(sensors, dt, 0.5).update(samples, estimates);
+    CHECK(final_error(estimates, recording.truth, sensors) < 0.05);
+    q::mahony_filter(sensors, dt, 5, 0.1).update(samples, estimates);
+    CHECK(final_error(estimates, recording.truth, sensors) < 0.05);
+}
+
+TEST_CASE("the filters check their arguments")
+{
+    CHECK_THROWS_AS(q::madgwick_filter(0, 0.01), std::domain_error);
+    CHECK_THROWS_AS(q::mahony_filter(2, -0.01), std::domain_error);
+
+    auto filter = q::madgwick_filter(2, 0.01);
+    CHECK(filter.sensors() == 2);
+    const auto three = std::vector<q::xyz>(3);
+    const auto four = std::vector<q::xyz>(4);
+    const auto two = std::vector<q::xyz>(2);
+    CHECK_THROWS_AS(filter.update({three, three, {}}), std::domain_error);
+    CHECK_THROWS_AS(filter.update({four, two, {}}), std::domain_error);
+    CHECK_THROWS_AS(filter.update({four, four, two}), std::domain_error);
+    auto estimates = std::vector<q::quaternion>(2);
+    CHECK_THROWS_AS(filter.update({four, four, {}}, estimates), std::domain_error);
+    CHECK_NOTHROW(filter.update({two, two, two}, estimates));
+}
@@ -0,0 +1,51 @@
+#include <catch2/catch_test_macros.hpp>
+#include <catch2/benchmark/catch_benchmark.hpp>
+#include "orientation_index.h"
+#include <cmath>
+#include <vector>
+#include "../test/benchmarks.h"
+#include "../test/helpers.h"
+
+namespace q = quaternions;
+
+TEST_CASE("nearest orientation lookup")
+{
+    const auto queries = random_unit_quaternions(1000, 2);
+    for (const auto n : benchmark_batch_sizes) {
+        const auto library = random_unit_quaternions(n, 1);
+        BENCHMARK("build index x" + batch_label(n)) {
+            return q::orientation_index(library).size();
+        };
+
+        const auto index = q::orientation_index(library);
+        auto matches = std::vector<q::orientation_match>(queries.size() * 10);
+        BENCHMARK("1000 nearest in index of x" + batch_label(n)) {
+            index.nearest(queries, std::span(matches).first(queries.size()));
+            return matches[0];
+        };
+        BENCHMARK("1000 10 nearest in index of x" + batch_label(n)) {
+            index.nearest(queries, 10, matches);
+            return matches[0];
+        };
+        BENCHMARK("1000 nearest in index of x" + batch_label(n) + " on all cores") {
+            index.nearest(q::execution::par, queries, std::span(matches).first(queries.size()));
+            return matches[0];
+        };
+        // a tenth of the queries, which takes long enough already
+        BENCHMARK("100 nearest by linear scan of x" + batch_label(n)) {
+            for (std::size_t i = 0; i < queries.size() / 10; ++i) {
+                auto best = std::size_t{0};
+                auto best_dot = -1.0;
+                for (std::size_t j = 0; j < library.size(); ++j) {
+                    const auto dot = std::abs(queries[i].dot(library[j]));
+                    if (dot > best_dot) {
+                        best_dot = dot;
+                        best = j;
+                    }
+                }
+                matches[i] = {best, 2 * std::acos(std::min(1.0, best_dot))};
+            }
+            return matches[0];
+        };
+    }
+}
@@ -0,0 +1,218 @@
+#include "orientation_index.h"
+#include "parallel.h"
+#include <algorithm>
+#include <cmath>
+#include <limits>
+#include <numeric>
+#include <stdexcept>
+
+namespace q = quaternions;
+
+namespace {
+    constexpr std::size_t min_chunk = 256;
+
+    double chord(const q::quaternion& a, const q::quaternion& b) {
+        // from the differences, as sqrt(2 - 2 |a . b|) cancels to 0 for rotations closer than 3E-8
+        return std::sqrt(std::min((a - b).norm(), (a + b).norm()));
+    }
+
+    double angle_of_chord(double chord) {
+        // the chord spans half the rotation angle on the unit sphere of quaternions
+        return 4 * std::asin(std::min(1.0, chord / 2));
+    }
+
+    double chord_of_angle(double angle) {
+        return 2 * std::sin(std::clamp(angle, 0.0, M_PI) / 4);
+    }
+
+    bool nearer(const q::orientation_match& a, const q::orientation_match& b) {
+        return a.angle < b.angle;
+    }
+
+    /**
+     * The k nearest candidates seen so far as a max-heap in a caller-provided buffer, holding tree
+     * positions in index and chords in angle until finish()
+     */
+    struct k_nearest {
+        std::span<q::orientation_match> heap;
+        std::size_t count = 0;
+
+        double bound() const {
+            return count < heap.size() ? std::numeric_limits<double>::infinity() : heap.front().angle;
+        }
+
+        void offer(double chord, std::size_t position) {
+            if (count < heap.size()) {
+                heap[count++] = {position, chord};
+                std::push_heap(heap.begin(), heap.begin() + count, nearer);
+            } else if (chord < heap.front().angle) {
+                std::pop_heap(heap.begin(), heap.end(), nearer);
+                heap.back() = {position, chord};
+                std::push_heap(heap.begin(), heap.end(), nearer);
+            }
+        }
+    };
+
+    struct within_radius {
+        double radius;
+        std::vector<q::orientation_match> found;
+
+        double bound() const {
+            return radius;
+        }
+
+        void offer(double chord, std::size_t position) {
+            if (chord <= radius)
+                found.push_back({position, chord});
+        }
+    };
+
+    /**
+     * Middle of a subtree of more than one rotation: the vantage point at begin is followed by the
+     * inner subtree [begin + 1, middle) and the outer subtree [middle, end)
+     */
+    std::size_t middle(std::size_t begin, std::size_t end) {
+        return begin + 1 + (end - begin - 1) / 2;
+    }
+}
+
+q::orientation_index::orientation_index(std::span<const quaternion> library, std::size_t leaf_size)
+    : leaf_size(std::max<std::size_t>(leaf_size, 1)), radii(library.size()) {
+    if (library.size() > std::numeric_limits<std::uint32_t>::max())
+        throw std::domain_error("an orientation index holds at most 2^32 - 1 rotations!");
+    points.reserve(library.size());
+    for (const auto& r : library)
+        points.push_back(r.normalized());
+    indices.resize(library.size());
+    std::iota(indices.begin(), indices.end(), std::uint32_t{0});
+
+    // splits ranges from a work list instead of recursing, on an order that is applied at the end
+    auto order = std::vector<std::size_t>(library.size());
+    std::iota(order.begin(), order.end(), std::size_t{0});
+    auto distances = std::vector<double>(library.size());
+    auto ranges = std::vector<std::pair<std::size_t, std::size_t>>{{0, library.size()}};
+    while (!ranges.empty()) {
+        const auto [begin, end] = ranges.back();
+        ranges.pop_back();
+        if (end - begin <= this->leaf_size)
+            continue;
+        // the rotation in the middle of the range, arbitrary but deterministic
+        std::swap(order[begin], order[begin + (end - begin) / 2]);
+        const auto& vantage = points[order[begin]];
+        for (auto i = begin + 1; i < end; ++i)
+            distances[order[i]] = chord(vantage, points[order[i]]);
+        const auto mid = middle(begin, end);
+        std::nth_element(order.begin() + static_cast<std::ptrdiff_t>(begin + 1),
+                         order.begin() + static_cast<std::ptrdiff_t>(mid),
+                         order.begin() + static_cast<std::ptrdiff_t>(end),
+                         [&](std::size_t a, std::size_t b) { return distances[a] < distances[b]; });
+        radii[begin] = distances[order[mid]];
+        ranges.emplace_back(begin + 1, mid);
+        ranges.emplace_back(mid, end);
+    }
+
+    auto ordered = std::vector<quaternion>(library.size());
+    for (std::size_t i = 0; i < order.size(); ++i) {
+        ordered[i] = points[order[i]];
+        indices[i] = static_cast<std::uint32_t>(order[i]);
+    }
+    points = std::move(ordered);
+}
+
+std::size_t q::orientation_index::size() const {
+    return points.size();
+}
+
+bool q::orientation_index::empty() const {
+    return points.empty();
+}
+
+template<typename Collector>
+void q::orientation_index::search(const quaternion& q, std::size_t begin, std::size_t end, Collector& collector) const {
+    if (end - begin <= leaf_size) {
+        for (auto i = begin; i < end; ++i)
+            collector.offer(chord(q, points[i]), i);
+        return;
+    }
+    const auto d = chord(q, points[begin]);
+    collector.offer(d, begin);
+    const auto mid = middle(begin, end);
+    const auto radius = radii[begin];
+    // the inner subtree lies within the radius of the vantage point, the outer one beyond it;
+    // the side of the query goes first, as it most likely tightens the bound
+    if (d < radius) {
+        search(q, begin + 1, mid, collector);
+        if (d + collector.bound() >= radius)
+            search(q, mid, end, collector);
+    } else {
+        search(q, mid, end, collector);
+        if (d - collector.bound() <= radius)
+            search(q, begin + 1, mid, collector);
+    }
+}
+
+void q::orientation_index::collect_nearest(const quaternion& q, std::span<orientation_match> out) const {
+    // k = 0 asks for nothing, and the heap has no front to compare against
+    if (out.empty())
+        return;
+    auto collector = k_nearest{out};
+    search(q.normalized(), 0, size(), collector);
+    std::sort_heap(out.begin(), out.end(), nearer);
+    for (auto& match : out)
+        match = {indices[match.index], angle_of_chord(match.angle)};
+}
+
+std::optional<q::orientation_match> q::orientation_index::nearest(const quaternion& q) const {
+    if (empty())
+        return std::nullopt;
+    auto match = orientation_match{};
+    collect_nearest(q, std::span(&match, 1));
+    return match;
+}
+
+std::vector<q::orientation_match> q::orientation_index::nearest(const quaternion& q, std::size_t k) const {
+    auto result = std::vector<orientation_match>(std::min(k, size()));
+    collect_nearest(q, result);
+    return result;
+}
+
+std::vector<q::orientation_match> q::orientation_index::within(const quaternion& q, double angle) const {
+    auto collector = within_radius{chord_of_angle(angle), {}};
+    if (!(angle < 0))
+        search(q.normalized(), 0, size(), collector);
+    std::sort(collector.found.begin(), collector.found.end(), nearer);
+    for (auto& match : collector.found)
+        match = {indices[match.index], angle_of_chord(match.angle)};
+    return collector.found;
+}
+
+void q::orientation_index::nearest(std::span<const quaternion> queries, std::span<orientation_match> out) const {
+    nearest(queries, 1, out);
+}
+
+void q::orientation_index::nearest(std::span<const quaternion> queries, std::size_t k,
+                                   std::span<orientation_match> out) const {
+    if (k > size())
+        throw std::domain_error("the index holds fewer rotations than requested!");
+    if (out.size() != queries.size() * k)
+        throw std::domain_error("batch queries need k outputs per query!");
+    for (std::size_t i = 0; i < queries.size(); ++i)
+        collect_nearest(queries[i], out.subspan(i * k, k));
+}
+
+void q::orientation_index::nearest(execution::parallel_policy policy, std::span<const quaternion> queries,
+                                   std::span<orientation_match> out) const {
+    nearest(policy, queries, 1, out);
+}
+
+void q::orientation_index::nearest(execution::parallel_policy policy, std::span<const quaternion> queries, std::size_t k,
+                                   std::span<orientation_match> out) const {
+    if (k > size())
+        throw std::domain_error("the index holds fewer rotations than requested!");
+    if (out.size() != queries.size() * k)
+        throw std::domain_error("batch queries need k outputs per query!");
+    parallel_for(policy, queries.size(), min_chunk, [&](std::size_t begin, std::size_t end) {
+        for (auto i = begin; i < end; ++i)
+            collect_nearest(queries[i], out.subspan(i * k, k));
+    });
+}
@@ -0,0 +1,80 @@
+#ifndef QUATERNIONS_ORIENTATION_INDEX_H
+#define QUATERNIONS_ORIENTATION_INDEX_H
+
+#include <cstddef>
+#include <cstdint>
+#include <optional>
+#include <span>
+#include <vector>
+#include "execution.h"
+#include "quaternion.h"
+
+namespace quaternions {
+    /**
+     * A library orientation found by a query: its index in the library and the angle of the
+     * rotation between it and the query in radians, in [0, π]
+     */
+    struct orientation_match {
+        std::size_t index;
+        double angle;
+    };
+
+    /**
+     * Nearest neighbour index over a library of rotations, treating q and -q as the same rotation.
+     *
+     * A vantage point tree under the chordal distance min(|a - b|, |a + b|), a metric on rotations
+     * that orders them like the rotation angle between them. It is computed as such rather than as
+     * the equal sqrt(2 - 2 |a . b|), which cancels for close rotations. The tree is implicit: the
+     * library is reordered so that every subtree is a contiguous range starting
+     * with its vantage point, and only one radius per point is stored besides. Ranges of up to
+     * leaf_size rotations are scanned linearly.
+     */
+    class orientation_index {
+    public:
+        /**
+         * Indexes the normalized library. Throws std::domain_error for more than 2^32 - 1 rotations.
+         */
+        explicit orientation_index(std::span<const quaternion> library, std::size_t leaf_size = 8);
+
+        std::size_t size() const;
+        bool empty() const;
+
+        /**
+         * Nearest library rotation, or nothing for an empty index
+         */
+        std::optional<orientation_match> nearest(const quaternion& q) const;
+        /**
+         * The k nearest library rotations, or all if there are fewer, nearest first
+         */
+        std::vector<orientation_match> nearest(const quaternion& q, std::size_t k) const;
+        /**
+         * All library rotations within the given angle in radians, nearest first
+         */
+        std::vector<orientation_match> within(const quaternion& q, double angle) const;
+
+        /**
+         * Batch queries: out[i] is the nearest match of queries[i], respectively out[i * k + j] the
+         * j-th nearest. out must have that size, and the index must hold at least k rotations.
+         */
+        void nearest(std::span<const quaternion> queries, std::span<orientation_match> out) const;
+        void nearest(std::span<const quaternion> queries, std::size_t k, std::span<orientation_match> out) const;
+        void nearest(execution::parallel_policy, std::span<const quaternion> queries,
+                     std::span<orientation_match> out) const;
+        void nearest(execution::parallel_policy, std::span<const quaternion> queries, std::size_t k,
+                     std::span<orientation_match> out) const;
+
+    private:
+        template<typename Collector>
+        void search(const quaternion& q, std::size_t begin, std::size_t end, Collector& collector) const;
+        void collect_nearest(const quaternion& q, std::span<orientation_match> out) const;
+
+        std::size_t leaf_size;
+        // library rotations in tree order, with their library indices and, for vantage points,
+        // the median distance splitting their subtree
+        std::vector<quaternion> points;
+        std::vector<std::uint32_t> indices;
+        std::vector<double> radii;
+    };
+}
+
+#endif //QUATERNIONS_ORIENTATION_INDEX_H
@@ -0,0 +1,135 @@
+#include <catch2/catch_test_macros.hpp>
+#include <catch2/generators/catch_generators.hpp>
+#include <catch2/matchers/catch_matchers_floating_point.hpp>
+#include "orientation_index.h"
+#include <algorithm>
+#include <cmath>
+#include <stdexcept>
+#include <vector>
+#include "../test/helpers.h"
+
+namespace q = quaternions;
+using Catch::Matchers::WithinAbs;
+
+namespace {
+    double angle_between(const q::quaternion& a, const q::quaternion& b) {
+        return 2 * std::acos(std::min(1.0, std::abs(a.normalized().dot(b.normalized()))));
+    }
+
+    std::vector<q::orientation_match> brute_force(std::span<const q::quaternion> library, const q::quaternion& query) {
+        auto result = std::vector<q::orientation_match>{};
+        for (std::size_t i = 0; i < library.size(); ++i)
+            result.push_back({i, angle_between(library[i], query)});
+        std::stable_sort(result.begin(), result.end(), [](const auto& a, const auto& b) { return a.angle < b.angle; });
+        return result;
+    }
+}
+
+TEST_CASE("nearest rotations match a linear scan")
+{
+    const auto leaf_size = GENERATE(std::size_t{1}, 8, 64);
+    const auto library = random_quaternions(5000, 1);
+    const auto index = q::orientation_index(library, leaf_size);
+    REQUIRE(index.size() == library.size());
+    for (const auto& query : random_quaternions(50, 2)) {
+        const auto expected = brute_force(library, query);
+        const auto nearest = index.nearest(query).value();
+        CHECK(nearest.index == expected[0].index);
+        CHECK_THAT(nearest.angle, WithinAbs(expected[0].angle, 1E-7));
+
+        const auto ten = index.nearest(query, 10);
+        REQUIRE(ten.size() == 10);
+        for (std::size_t j = 0; j < ten.size(); ++j) {
+            CHECK(ten[j].index == expected[j].index);
+            CHECK_THAT(ten[j].angle, WithinAbs(expected[j].angle, 1E-7));
+        }
+
+        const auto radius = expected[25].angle;
+        const auto found = index.within(query, radius);
+        CHECK(found.size() >= 25);
+        CHECK(found.size() <= 27);
+        for (std::size_t j = 0; j < found.size(); ++j) {
+            CHECK(found[j].index == expected[j].index);
+            CHECK(found[j].angle <= radius + 1E-7);
+        }
+    }
+}
+
+TEST_CASE("near-duplicate rotations keep their order")
+{
+    const auto about_z = [](double angle) { return q::quaternion::from_rotation({{0, 0, 1}, angle}); };
+    const auto library = std::vector<q::quaternion>{about_z(2E-8), about_z(-1E-8), about_z(3E-8), about_z(1)};
+    const auto index = q::orientation_index(library, 1);
+    const auto nearest = index.nearest(about_z(0), 3);
+    REQUIRE(nearest.size() == 3);
+    CHECK(nearest[0].index == 1);
+    CHECK(nearest[1].index == 0);
+    CHECK(nearest[2].index == 2);
+    CHECK_THAT(nearest[0].angle, WithinAbs(1E-8, 1E-14));
+    CHECK_THAT(nearest[2].angle, WithinAbs(3E-8, 1E-14));
+    // and across the double cover
+    const auto flipped = index.nearest(-1.0 * about_z(1E-7)).value();
+    CHECK(flipped.index == 2);
+    CHECK_THAT(flipped.angle, WithinAbs(7E-8, 1E-14));
+}
+
+TEST_CASE("q and -q are the same rotation to the index")
+{
+    const auto library = random_unit_quaternions(1000, 3);
+    const auto index = q::orientation_index(library);
+    for (std::size_t i = 0; i < library.size(); i += 97) {
+        const auto found = index.nearest(-1.0 * library[i]).value();
+        CHECK(found.index == i);
+        CHECK_THAT(found.angle, WithinAbs(0, 1E-7));
+    }
+    // a rotation by 179 degrees is 1 degree away from the identity going the other way
+    const auto around = std::vector<q::quaternion>{q::quaternion::from_rotation({{0, 0, 1}, 179 * M_PI / 180})};
+    const auto single = q::orientation_index(around);
+    CHECK_THAT(single.nearest(q::quaternion::from_rotation({{0, 0, 1}, -179 * M_PI / 180}))->angle,
+               WithinAbs(2 * M_PI / 180, 1E-7));
+}
+
+TEST_CASE("batch queries match single queries")
+{
+    const auto library = random_unit_quaternions(20000, 4);
+    const auto index = q::orientation_index(library);
+    const auto queries = random_unit_quaternions(1000, 5);
+    auto sequential = std::vector<q::orientation_match>(queries.size() * 3);
+    auto parallel = std::vector<q::orientation_match>(queries.size() * 3);
+    index.nearest(queries, 3, sequential);
+    index.nearest(q::execution::par, queries, 3, parallel);
+    auto single = std::vector<q::orientation_match>(queries.size());
+    index.nearest(q::execution::par, queries, single);
+    for (std::size_t i = 0; i < queries.size(); ++i) {
+        const auto expected = index.nearest(queries[i], 3);
+        for (std::size_t j = 0; j < 3; ++j) {
+            CHECK(sequential[3 * i + j].index == expected[j].index);
+            CHECK(parallel[3 * i + j].index == expected[j].index);
+        }
+        CHECK(single[i].index == expected[0].index);
+    }
+}
+
+TEST_CASE("small and empty indices")
+{
+    const auto empty = q::orientation_index(std::vector<q::quaternion>{});
+    CHECK(empty.empty());
+    CHECK(empty.nearest(q::quaternion{1, 0, 0, 0}) == std::nullopt);
+    CHECK(empty.nearest(q::quaternion{1, 0, 0, 0}, 3).empty());
+    CHECK(empty.within(q::quaternion{1, 0, 0, 0}, M_PI).empty());
+
+    const auto library = random_unit_quaternions(5, 6);
+    const auto index = q::orientation_index(library);
+    CHECK(index.nearest(q::quaternion{1, 0, 0, 0}, 10).size() == 5);
+    CHECK(index.nearest(q::quaternion{1, 0, 0, 0}, 0).empty());
+    CHECK(index.within(q::quaternion{1, 0, 0, 0}, M_PI).size() == 5);
+    CHECK(index.within(q::quaternion{1, 0, 0, 0}, -1).empty());
+
+    const auto queries = random_unit_quaternions(2, 7);
+    auto out = std::vector<q::orientation_match>(12);
+    index.nearest(queries, 0, std::span(out).first(0));
+    index.nearest(q::execution::par, queries, 0, std::span(out).first(0));
+    CHECK_THROWS_AS(index.nearest(queries, 6, out), std::domain_error);
+    CHECK_THROWS_AS(index.nearest(queries, 5, out), std::domain_error);
+    CHECK_THROWS_AS(empty.nearest(queries, std::span(out).first(2)), std::domain_error);
+}
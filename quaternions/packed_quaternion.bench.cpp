@@ -0,0 +1,35 @@
+#include <catch2/catch_test_macros.hpp>
+#include <catch2/benchmark/catch_benchmark.hpp>
+#include "packed_quaternion.h"
+#include <vector>
+#include "../test/benchmarks.h"
+#include "../test/helpers.h"
+
+namespace q = quaternions;
+
+namespace {
+    template<std::size_t Bits>
+    void benchmark_codec() {
+        const auto name = std::to_string(Bits) + " bit";
+        for (const auto n : benchmark_batch_sizes) {
+            const auto rotations = random_unit_quaternions(n, 1);
+            auto packed = std::vector<q::packed_quaternion<Bits>>(n);
+            auto unpacked = std::vector<q::quaternion>(n);
+            BENCHMARK("pack " + name + " x" + batch_label(n)) {
+                q::pack<Bits>(rotations, packed);
+                return packed[0];
+            };
+            BENCHMARK("unpack " + name + " x" + batch_label(n)) {
+                q::unpack<Bits>(packed, unpacked);
+                return unpacked[0];
+            };
+        }
+    }
+}
+
+TEST_CASE("packed quaternions")
+{
+    benchmark_codec<32>();
+    benchmark_codec<48>();
+    benchmark_codec<64>();
+}
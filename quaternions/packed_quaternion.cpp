@@ -0,0 +1,27 @@
+#include "packed_quaternion.h"
+#include <stdexcept>
+
+namespace q = quaternions;
+
+template<std::size_t Bits>
+void q::pack(std::span<const quaternion> in, std::span<packed_quaternion<Bits>> out) {
+    if (in.size() != out.size())
+        throw std::domain_error("packing quaternions needs one output per input!");
+    for (std::size_t i = 0; i < in.size(); ++i)
+        out[i] = packed_quaternion<Bits>::pack(in[i]);
+}
+
+template<std::size_t Bits>
+void q::unpack(std::span<const packed_quaternion<Bits>> in, std::span<quaternion> out) {
+    if (in.size() != out.size())
+        throw std::domain_error("unpacking quaternions needs one output per input!");
+    for (std::size_t i = 0; i < in.size(); ++i)
+        out[i] = in[i].unpack();
+}
+
+template void q::pack<32>(std::span<const quaternion>, std::span<packed_quaternion<32>>);
+template void q::pack<48>(std::span<const quaternion>, std::span<packed_quaternion<48>>);
+template void q::pack<64>(std::span<const quaternion>, std::span<packed_quaternion<64>>);
+template void q::unpack<32>(std::span<const packed_quaternion<32>>, std::span<quaternion>);
+template void q::unpack<48>(std::span<const packed_quaternion<48>>, std::span<quaternion>);
+template void q::unpack<64>(std::span<const packed_quaternion<64>>, std::span<quaternion>);
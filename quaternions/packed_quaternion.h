@@ -0,0 +1,124 @@
+#ifndef QUATERNIONS_PACKED_QUATERNION_H
+#define QUATERNIONS_PACKED_QUATERNION_H
+
+#include <algorithm>
+#include <array>
+#include <cmath>
+#include <cstddef>
+#include <cstdint>
+#include <span>
+#include "quaternion.h"
+
+namespace quaternions {
+    /**
+     * Unit quaternion packed into 32, 48 or 64 bits in "smallest three" form: the index of the
+     * component with the largest magnitude (2 bits) and the other three components, each quantized
+     * to component_bits bits over [-1/√2, 1/√2]. The largest component is made positive, which
+     * keeps the rotation, and recomputed from the other three when unpacking.
+     *
+     * The bits are stored as little-endian bytes, so packed quaternions can be sent over the
+     * network or archived as they are.
+     */
+    template<std::size_t Bits>
+    class packed_quaternion {
+    public:
+        static_assert(Bits == 32 || Bits == 48 || Bits == 64);
+
+        static constexpr std::size_t component_bits = (Bits - 2) / 3;
+        static constexpr std::uint64_t component_max = (std::uint64_t{1} << component_bits) - 1;
+        /**
+         * Upper bound of the angle in radians between the rotations of a unit quaternion and of
+         * its unpacked form: 2√6 / component_max, from the quantization error of at most
+         * 1 / (√2 component_max) per component. About 0.28° for 32 bits, 0.0086° for 48 bits and
+         * 0.00027° for 64 bits.
+         */
+        static constexpr double max_angle_error = 4.898979485566356 / component_max;
+
+        std::array<std::uint8_t, Bits / 8> bytes;
+
+        /**
+         * Packs the normalized q, -q gives the same result. Quaternions without a rotation, i.e.
+         * zero, infinite or NaN ones, or ones whose length overflows, pack as the identity.
+         */
+        packed_quaternion static pack(const quaternion& q);
+        quaternion unpack() const;
+    };
+
+    using packed_quaternion_32 = packed_quaternion<32>;
+    using packed_quaternion_48 = packed_quaternion<48>;
+    using packed_quaternion_64 = packed_quaternion<64>;
+
+    template<std::size_t Bits>
+    bool operator==(const packed_quaternion<Bits>& a, const packed_quaternion<Bits>& b) {
+        return a.bytes == b.bytes;
+    }
+
+    /**
+     * Packs and unpacks many quaternions, in and out must have the same size. Like
+     * packed_quaternion::pack, quaternions without a rotation pack as the identity.
+     */
+    template<std::size_t Bits>
+    void pack(std::span<const quaternion> in, std::span<packed_quaternion<Bits>> out);
+    template<std::size_t Bits>
+    void unpack(std::span<const packed_quaternion<Bits>> in, std::span<quaternion> out);
+
+    namespace packing {
+        // indices of the three components stored for each index of the largest one
+        inline constexpr std::size_t others[4][3] = {{1, 2, 3}, {0, 2, 3}, {0, 1, 3}, {0, 1, 2}};
+    }
+
+    template<std::size_t Bits>
+    packed_quaternion<Bits> packed_quaternion<Bits>::pack(const quaternion& q) {
+        const double components[4] = {q.w, q.x, q.y, q.z};
+        // written without branches on the data, so that packing many quaternions pipelines well
+        std::size_t largest = 0;
+        auto largest_magnitude = std::abs(q.w);
+        for (std::size_t i = 1; i < 4; ++i) {
+            const auto magnitude = std::abs(components[i]);
+            largest = magnitude > largest_magnitude ? i : largest;
+            largest_magnitude = std::max(magnitude, largest_magnitude);
+        }
+        // dividing by the length normalizes, the sign makes the largest component positive
+        const auto scale = std::copysign(M_SQRT2 / q.length(), components[largest]);
+        // zero and non-finite quaternions, which have no rotation, pack as the identity instead
+        // of casting NaN to an integer below
+        const auto valid = std::isfinite(scale) && scale != 0;
+
+        auto bits = std::uint64_t{valid ? largest : 0};
+        for (std::size_t j = 0; j < 3; ++j) {
+            // [-1/√2, 1/√2] to [0, component_max], rounded to nearest
+            const auto unit = valid ? (components[packing::others[largest][j]] * scale + 1) * (0.5 * component_max)
+                                    : 0.5 * component_max;
+            // through int32_t, which converts from double in one instruction unlike uint64_t
+            const auto quantized = static_cast<std::int32_t>(std::clamp(unit + 0.5, 0.0, double(component_max)));
+            bits |= static_cast<std::uint64_t>(quantized) << (2 + j * component_bits);
+        }
+
+        auto result = packed_quaternion{};
+        for (std::size_t i = 0; i < result.bytes.size(); ++i)
+            result.bytes[i] = static_cast<std::uint8_t>(bits >> (8 * i));
+        return result;
+    }
+
+    template<std::size_t Bits>
+    quaternion packed_quaternion<Bits>::unpack() const {
+        auto bits = std::uint64_t{0};
+        for (std::size_t i = 0; i < bytes.size(); ++i)
+            bits |= std::uint64_t{bytes[i]} << (8 * i);
+
+        const auto largest = static_cast<std::size_t>(bits & 3);
+        double components[4];
+        auto sum = 0.0;
+        for (std::size_t j = 0; j < 3; ++j) {
+            const auto quantized = static_cast<double>(
+                static_cast<std::int32_t>((bits >> (2 + j * component_bits)) & component_max));
+            const auto component = (quantized * (2.0 / component_max) - 1) * M_SQRT1_2;
+            components[packing::others[largest][j]] = component;
+            sum += component * component;
+        }
+        components[largest] = std::sqrt(std::max(0.0, 1 - sum));
+        return quaternion{components[0], components[1], components[2], components[3]};
+    }
+}
+
+#endif //QUATERNIONS_PACKED_QUATERNION_H
@@ -0,0 +1,78 @@
+#include <catch2/catch_test_macros.hpp>
+#include <catch2/catch_template_test_macros.hpp>
+#include <catch2/matchers/catch_matchers_floating_point.hpp>
+#include "packed_quaternion.h"
+#include <algorithm>
+#include <cmath>
+#include <limits>
+#include <vector>
+#include "../test/helpers.h"
+
+namespace q = quaternions;
+using Catch::Matchers::WithinAbs;
+
+namespace {
+    double angle_between(const q::quaternion& a, const q::quaternion& b) {
+        return 2 * std::acos(std::min(1.0, std::abs(a.dot(b))));
+    }
+}
+
+TEMPLATE_TEST_CASE_SIG("packed quaternions stay within their error bound", "", ((std::size_t Bits), Bits), 32, 48, 64)
+{
+    using packed = q::packed_quaternion<Bits>;
+    STATIC_REQUIRE(sizeof(packed) == Bits / 8);
+
+    auto rotations = random_unit_quaternions(10'000, 1);
+    // ties between the largest components and components at the ends of the quantized range
+    const auto h = 0.5;
+    const auto s = M_SQRT1_2;
+    rotations.insert(rotations.end(), {
+        {1, 0, 0, 0}, {0, 0, 0, -1}, {h, h, h, h}, {-h, h, -h, h}, {s, s, 0, 0}, {0, -s, 0, s}, {s, 0, -s, 0},
+    });
+    auto worst = 0.0;
+    for (const auto& r : rotations) {
+        const auto unpacked = packed::pack(r).unpack();
+        CHECK_THAT(unpacked.length(), WithinAbs(1.0, 1E-12));
+        worst = std::max(worst, angle_between(r, unpacked));
+    }
+    CHECK(worst <= packed::max_angle_error);
+    // the bound is not far off, i.e. all bits are used
+    CHECK(worst > packed::max_angle_error / 20);
+}
+
+TEMPLATE_TEST_CASE_SIG("packing many quaternions", "", ((std::size_t Bits), Bits), 32, 48, 64)
+{
+    const auto rotations = random_unit_quaternions(1000, 2);
+    auto packed = std::vector<q::packed_quaternion<Bits>>(rotations.size());
+    auto unpacked = std::vector<q::quaternion>(rotations.size());
+    q::pack<Bits>(rotations, packed);
+    q::unpack<Bits>(packed, unpacked);
+    for (std::size_t i = 0; i < rotations.size(); ++i) {
+        CHECK(packed[i] == q::packed_quaternion<Bits>::pack(rotations[i]));
+        CHECK(unpacked[i] == packed[i].unpack());
+    }
+    CHECK_THROWS(q::unpack<Bits>(packed, std::span(unpacked).subspan(1)));
+}
+
+TEST_CASE("packed quaternions ignore sign and length")
+{
+    const auto r = q::quaternion{1, 2, -3, 0.5};
+    CHECK(q::packed_quaternion_48::pack(r) == q::packed_quaternion_48::pack(-r));
+    CHECK(q::packed_quaternion_48::pack(r) == q::packed_quaternion_48::pack(r.normalized()));
+    CHECK(q::packed_quaternion_48::pack(r).unpack().y > 0);
+}
+
+TEST_CASE("quaternions without a rotation pack as the identity")
+{
+    const auto identity = q::packed_quaternion_32::pack({1, 0, 0, 0});
+    const auto nan = std::numeric_limits<double>::quiet_NaN();
+    const auto inf = std::numeric_limits<double>::infinity();
+    CHECK(q::packed_quaternion_32::pack({0, 0, 0, 0}) == identity);
+    CHECK(q::packed_quaternion_32::pack({nan, 0, 0, 1}) == identity);
+    CHECK(q::packed_quaternion_32::pack({0, -inf, 0, 0}) == identity);
+    const auto in = std::vector<q::quaternion>{{0, nan, 0, 0}, {1, 0, 0, 0}};
+    auto out = std::vector<q::packed_quaternion_64>(2);
+    q::pack<64>(in, out);
+    CHECK(out[0] == out[1]);
+    CHECK_THAT(out[0].unpack(), WithinAbs(q::quaternion{1, 0, 0, 0}, 1E-6));
+}
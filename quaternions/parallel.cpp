@@ -0,0 +1,39 @@
+#include "parallel.h"
+#include "thread_pool.h"
+#include <algorithm>
+#include <thread>
+
+namespace q = quaternions;
+
+std::size_t q::hardware_threads() {
+    static const auto threads = std::max<std::size_t>(1, std::thread::hardware_concurrency());
+    return threads;
+}
+
+q::execution::executor& q::executor_of(execution::parallel_policy policy) {
+    return policy.target ? *policy.target : thread_pool::shared();
+}
+
+void q::parallel_for(execution::parallel_policy policy, std::size_t n, std::size_t min_chunk,
+                     const std::function<void(std::size_t, std::size_t)>& body) {
+    const auto max_chunks = n / std::max<std::size_t>(min_chunk, 1);
+    if (max_chunks <= 1) {
+        if (n > 0)
+            body(0, n);
+        return;
+    }
+    auto& executor = executor_of(policy);
+    const auto chunks = std::min(max_chunks, 4 * executor.concurrency());
+    if (executor.concurrency() == 1) {
+        body(0, n);
+        return;
+    }
+    executor.bulk(chunks, [&](std::size_t chunk) {
+        body(chunk * n / chunks, (chunk + 1) * n / chunks);
+    });
+}
+
+void q::parallel_for(std::size_t n, std::size_t min_chunk,
+                     const std::function<void(std::size_t, std::size_t)>& body) {
+    parallel_for(execution::par, n, min_chunk, body);
+}
@@ -0,0 +1,31 @@
+#ifndef QUATERNIONS_PARALLEL_H
+#define QUATERNIONS_PARALLEL_H
+
+#include <cstddef>
+#include <functional>
+#include "execution.h"
+
+namespace quaternions {
+    /**
+     * Number of threads parallel_for spreads work across by default
+     */
+    std::size_t hardware_threads();
+
+    /**
+     * The executor a parallel policy runs on, thread_pool::shared() unless it names another one
+     */
+    execution::executor& executor_of(execution::parallel_policy policy);
+
+    /**
+     * Splits [0, n) into contiguous chunks of at least min_chunk elements and calls body(begin, end)
+     * for each of them on the executor of policy. Up to four chunks per thread are made, so that
+     * idle threads can take over the chunks of busy ones. Small ranges stay on the calling thread.
+     * The first exception thrown by body is rethrown after all chunks are done.
+     */
+    void parallel_for(execution::parallel_policy policy, std::size_t n, std::size_t min_chunk,
+                      const std::function<void(std::size_t begin, std::size_t end)>& body);
+    void parallel_for(std::size_t n, std::size_t min_chunk,
+                      const std::function<void(std::size_t begin, std::size_t end)>& body);
+}
+
+#endif //QUATERNIONS_PARALLEL_H
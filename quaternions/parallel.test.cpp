@@ -0,0 +1,28 @@
+#include <catch2/catch_test_macros.hpp>
+#include <catch2/generators/catch_generators.hpp>
+#include "parallel.h"
+#include <algorithm>
+#include <atomic>
+#include <stdexcept>
+#include <vector>
+
+namespace q = quaternions;
+
+TEST_CASE("parallel_for visits every index exactly once")
+{
+    const auto n = GENERATE(std::size_t{0}, 1, 100, 100'003);
+    auto visits = std::vector<std::atomic<int>>(n);
+    q::parallel_for(n, 64, [&](std::size_t begin, std::size_t end) {
+        for (auto i = begin; i < end; ++i)
+            ++visits[i];
+    });
+    CHECK(std::all_of(visits.begin(), visits.end(), [](const auto& v) { return v == 1; }));
+}
+
+TEST_CASE("parallel_for rethrows exceptions of its chunks")
+{
+    CHECK_THROWS_AS(q::parallel_for(1'000'000, 1, [](std::size_t begin, std::size_t end) {
+        if (begin <= 500'000 && 500'000 < end)
+            throw std::domain_error("chunk failed");
+    }), std::domain_error);
+}
@@ -0,0 +1,36 @@
+#include <catch2/catch_test_macros.hpp>
+#include <catch2/benchmark/catch_benchmark.hpp>
+#include "pose_stream.h"
+#include "scan.h"
+#include <filesystem>
+#include <vector>
+#include "../test/benchmarks.h"
+#include "../test/helpers.h"
+
+namespace q = quaternions;
+
+TEST_CASE("pose stream")
+{
+    const auto path = (std::filesystem::temp_directory_path() / "quaternions_benchmark.qpose").string();
+    for (const auto n : benchmark_batch_sizes) {
+        auto times = std::vector<double>(n);
+        for (std::size_t i = 0; i < n; ++i)
+            times[i] = 0.001 * static_cast<double>(i);
+        const auto orientations = random_unit_quaternions(n, 1);
+        const auto positions = random_vectors(n, 2);
+
+        BENCHMARK("write with positions x" + batch_label(n)) {
+            auto writer = q::pose_writer(path, true);
+            writer.append(times, orientations, positions);
+            writer.flush();
+        };
+        BENCHMARK("map and reduce x" + batch_label(n)) {
+            const auto reader = q::pose_reader(path);
+            auto product = q::quaternion{1, 0, 0, 0};
+            for (const auto& chunk : reader.chunks())
+                product = product * q::reduce(chunk.orientations);
+            return product;
+        };
+    }
+    std::filesystem::remove(path);
+}
@@ -0,0 +1,280 @@
+#include "pose_stream.h"
+#include <algorithm>
+#include <array>
+#include <bit>
+#include <cerrno>
+#include <cstring>
+#include <limits>
+#include <stdexcept>
+#include <utility>
+#if defined(__unix__) || defined(__APPLE__)
+#define QUATERNIONS_HAS_MMAP
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
+
+namespace q = quaternions;
+
+namespace {
+    constexpr std::size_t alignment = 64;
+    constexpr std::array<char, 8> file_magic = {'Q', 'P', 'O', 'S', 'E', '\r', '\n', '\x1a'};
+    constexpr std::array<char, 4> chunk_magic = {'Q', 'C', 'H', 'K'};
+
+    static_assert(sizeof(q::quaternion) == 4 * sizeof(double));
+    static_assert(sizeof(q::xyz) == 3 * sizeof(double));
+
+    struct file_header {
+        std::array<char, 8> magic;
+        std::uint32_t version;
+        std::uint32_t flags;
+        std::byte reserved[48];
+    };
+
+    struct chunk_header {
+        std::array<char, 4> magic;
+        std::uint32_t count;
+        std::byte reserved[56];
+    };
+
+    static_assert(sizeof(file_header) == alignment && sizeof(chunk_header) == alignment);
+
+    std::size_t padded(std::size_t bytes) {
+        return (bytes + alignment - 1) / alignment * alignment;
+    }
+
+    void check_little_endian() {
+        if constexpr (std::endian::native != std::endian::little)
+            throw std::domain_error("pose streams are little-endian and mapped without conversion!");
+    }
+
+    /**
+     * The chunk size of a new writer, checked before the file is opened so that a rejected
+     * writer leaves an existing file alone
+     */
+    std::size_t checked_chunk_size(std::size_t chunk_size) {
+        check_little_endian();
+        // chunk headers store their record count in 32 bits
+        if (chunk_size > std::numeric_limits<std::uint32_t>::max())
+            throw std::domain_error("pose stream chunks hold at most 2^32 - 1 records!");
+        return std::max<std::size_t>(chunk_size, 1);
+    }
+
+    template<typename T>
+    void write_column(std::ofstream& file, std::span<const T> column) {
+        static const char zeros[alignment] = {};
+        const auto bytes = column.size_bytes();
+        file.write(reinterpret_cast<const char*>(column.data()), static_cast<std::streamsize>(bytes));
+        file.write(zeros, static_cast<std::streamsize>(padded(bytes) - bytes));
+    }
+}
+
+q::pose_reader::pose_reader(const std::string& path) {
+    check_little_endian();
+#if defined(QUATERNIONS_HAS_MMAP)
+    const auto fd = ::open(path.c_str(), O_RDONLY);
+    if (fd < 0)
+        throw std::runtime_error("cannot open pose stream " + path + ": " + std::strerror(errno));
+    struct stat status {};
+    if (::fstat(fd, &status) != 0) {
+        ::close(fd);
+        throw std::runtime_error("cannot read pose stream " + path + ": " + std::strerror(errno));
+    }
+    length = static_cast<std::size_t>(status.st_size);
+    if (length > 0) {
+        const auto mapping = ::mmap(nullptr, length, PROT_READ, MAP_PRIVATE, fd, 0);
+        if (mapping == MAP_FAILED) {
+            ::close(fd);
+            throw std::runtime_error("cannot map pose stream " + path + ": " + std::strerror(errno));
+        }
+        ::madvise(mapping, length, MADV_SEQUENTIAL);
+        data = static_cast<const std::byte*>(mapping);
+    }
+    ::close(fd);
+#else
+    auto file = std::ifstream(path, std::ios::binary | std::ios::ate);
+    if (!file)
+        throw std::runtime_error("cannot open pose stream " + path);
+    length = static_cast<std::size_t>(file.tellg());
+    // one spare alignment so that the columns can be 64 byte aligned like in a mapping
+    buffer.resize(length + alignment);
+    const auto misalignment = reinterpret_cast<std::uintptr_t>(buffer.data()) % alignment;
+    const auto start = buffer.data() + (misalignment == 0 ? 0 : alignment - misalignment);
+    file.seekg(0);
+    file.read(reinterpret_cast<char*>(start), static_cast<std::streamsize>(length));
+    data = start;
+#endif
+
+    try {
+        auto header = file_header{};
+        if (length < sizeof header)
+            throw std::domain_error(path + " is too short for a pose stream!");
+        std::memcpy(&header, data, sizeof header);
+        if (header.magic != file_magic)
+            throw std::domain_error(path + " is no pose stream!");
+        if (header.version != pose_stream::version)
+            throw std::domain_error(path + " has unsupported pose stream version " +
+                                    std::to_string(header.version) + "!");
+        with_positions = (header.flags & pose_stream::has_positions) != 0;
+
+        auto offset = sizeof(file_header);
+        while (offset + sizeof(chunk_header) <= length) {
+            auto chunk = chunk_header{};
+            std::memcpy(&chunk, data + offset, sizeof chunk);
+            if (chunk.magic != chunk_magic)
+                throw std::domain_error(path + " has a broken chunk at byte " + std::to_string(offset) + "!");
+            const auto count = std::size_t{chunk.count};
+            const auto times_bytes = padded(count * sizeof(double));
+            const auto orientations_bytes = padded(count * sizeof(quaternion));
+            const auto positions_bytes = with_positions ? padded(count * sizeof(xyz)) : 0;
+            const auto end = offset + sizeof(chunk_header) + times_bytes + orientations_bytes + positions_bytes;
+            if (end > length)
+                break;
+
+            const auto times = data + offset + sizeof(chunk_header);
+            const auto orientations = times + times_bytes;
+            const auto positions = orientations + orientations_bytes;
+            chunk_views.push_back({
+                {reinterpret_cast<const double*>(times), count},
+                {reinterpret_cast<const quaternion*>(orientations), count},
+                {reinterpret_cast<const xyz*>(positions), with_positions ? count : 0},
+            });
+            records += count;
+            offset = end;
+        }
+    } catch (...) {
+        unmap();
+        throw;
+    }
+}
+
+q::pose_reader::pose_reader(pose_reader&& other) noexcept
+    : data(std::exchange(other.data, nullptr)),
+      length(std::exchange(other.length, 0)),
+      buffer(std::move(other.buffer)),
+      with_positions(other.with_positions),
+      records(std::exchange(other.records, 0)),
+      chunk_views(std::move(other.chunk_views)) {}
+
+q::pose_reader& q::pose_reader::operator=(pose_reader&& other) noexcept {
+    if (this != &other) {
+        unmap();
+        data = std::exchange(other.data, nullptr);
+        length = std::exchange(other.length, 0);
+        buffer = std::move(other.buffer);
+        with_positions = other.with_positions;
+        records = std::exchange(other.records, 0);
+        chunk_views = std::move(other.chunk_views);
+    }
+    return *this;
+}
+
+q::pose_reader::~pose_reader() {
+    unmap();
+}
+
+void q::pose_reader::unmap() {
+#if defined(QUATERNIONS_HAS_MMAP)
+    if (data)
+        ::munmap(const_cast<std::byte*>(data), length);
+#endif
+    data = nullptr;
+    length = 0;
+    buffer.clear();
+    chunk_views.clear();
+}
+
+bool q::pose_reader::has_positions() const {
+    return with_positions;
+}
+
+std::size_t q::pose_reader::size() const {
+    return records;
+}
+
+std::span<const q::pose_chunk> q::pose_reader::chunks() const {
+    return chunk_views;
+}
+
+q::pose_writer::pose_writer(const std::string& path, bool with_positions, std::size_t chunk_size)
+    : with_positions(with_positions), chunk_size(checked_chunk_size(chunk_size)),
+      file(path, std::ios::binary | std::ios::trunc) {
+    if (!file)
+        throw std::runtime_error("cannot create pose stream " + path);
+    auto header = file_header{file_magic, pose_stream::version, with_positions ? pose_stream::has_positions : 0, {}};
+    file.write(reinterpret_cast<const char*>(&header), sizeof header);
+    times.reserve(this->chunk_size);
+    orientations.reserve(this->chunk_size);
+    if (with_positions)
+        positions.reserve(this->chunk_size);
+}
+
+q::pose_writer::~pose_writer() {
+    try {
+        if (file.is_open())
+            flush();
+    } catch (...) {
+        // destructors must not throw, call flush() to see write errors
+    }
+}
+
+void q::pose_writer::append(double time, const quaternion& orientation) {
+    if (with_positions)
+        throw std::domain_error("records of this pose stream need a position!");
+    times.push_back(time);
+    orientations.push_back(orientation);
+    if (times.size() == chunk_size)
+        write_chunk();
+}
+
+void q::pose_writer::append(double time, const quaternion& orientation, const xyz& position) {
+    if (!with_positions)
+        throw std::domain_error("records of this pose stream have no position!");
+    times.push_back(time);
+    orientations.push_back(orientation);
+    positions.push_back(position);
+    if (times.size() == chunk_size)
+        write_chunk();
+}
+
+void q::pose_writer::append(std::span<const double> times, std::span<const quaternion> orientations,
+                            std::span<const xyz> positions) {
+    if (times.size() != orientations.size() || positions.size() != (with_positions ? times.size() : 0))
+        throw std::domain_error("appending poses needs one orientation and, if the stream has them, "
+                                "one position per time!");
+    while (!times.empty()) {
+        const auto count = std::min(times.size(), chunk_size - this->times.size());
+        this->times.insert(this->times.end(), times.begin(), times.begin() + count);
+        this->orientations.insert(this->orientations.end(), orientations.begin(), orientations.begin() + count);
+        if (with_positions)
+            this->positions.insert(this->positions.end(), positions.begin(), positions.begin() + count);
+        times = times.subspan(count);
+        orientations = orientations.subspan(count);
+        positions = positions.subspan(with_positions ? count : 0);
+        if (this->times.size() == chunk_size)
+            write_chunk();
+    }
+}
+
+void q::pose_writer::flush() {
+    if (!times.empty())
+        write_chunk();
+    file.flush();
+    if (!file)
+        throw std::runtime_error("writing pose stream failed!");
+}
+
+void q::pose_writer::write_chunk() {
+    auto header = chunk_header{chunk_magic, static_cast<std::uint32_t>(times.size()), {}};
+    file.write(reinterpret_cast<const char*>(&header), sizeof header);
+    write_column<double>(file, times);
+    write_column<quaternion>(file, orientations);
+    if (with_positions)
+        write_column<xyz>(file, positions);
+    if (!file)
+        throw std::runtime_error("writing pose stream failed!");
+    times.clear();
+    orientations.clear();
+    positions.clear();
+}
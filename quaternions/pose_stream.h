@@ -0,0 +1,108 @@
+#ifndef QUATERNIONS_POSE_STREAM_H
+#define QUATERNIONS_POSE_STREAM_H
+
+#include <cstddef>
+#include <cstdint>
+#include <fstream>
+#include <span>
+#include <string>
+#include <vector>
+#include "quaternion.h"
+#include "xyz.h"
+
+namespace quaternions {
+    /**
+     * Binary files of timestamped orientations and optional positions, version 1, little-endian.
+     *
+     * The file starts with a 64 byte header: the 8 byte magic "QPOSE\r\n\x1a", the version as uint32
+     * and the flags as uint32 (bit 0: records have positions), followed by zeros. Then come chunks
+     * of records, each a 64 byte header (the 4 byte magic "QCHK", the record count as uint32,
+     * zeros) and the columns times (double), orientations (quaternion) and, if present, positions
+     * (xyz), each padded with zeros to a multiple of 64 bytes. Every column is thereby aligned
+     * to 64 bytes and can be used in place.
+     */
+    namespace pose_stream {
+        inline constexpr std::uint32_t version = 1;
+        inline constexpr std::uint32_t has_positions = 1;
+    }
+
+    /**
+     * Records of one chunk, pointing straight into the mapped file
+     */
+    struct pose_chunk {
+        std::span<const double> times;
+        std::span<const quaternion> orientations;
+        // empty if the stream has no positions
+        std::span<const xyz> positions;
+    };
+
+    /**
+     * Memory-maps a pose stream file. A trailing chunk cut short, e.g. by a capture that was
+     * killed while writing, is ignored. Malformed files throw std::domain_error.
+     */
+    class pose_reader {
+    public:
+        explicit pose_reader(const std::string& path);
+        pose_reader(pose_reader&& other) noexcept;
+        pose_reader& operator=(pose_reader&& other) noexcept;
+        pose_reader(const pose_reader&) = delete;
+        pose_reader& operator=(const pose_reader&) = delete;
+        ~pose_reader();
+
+        bool has_positions() const;
+        /**
+         * Number of records in all chunks
+         */
+        std::size_t size() const;
+        std::span<const pose_chunk> chunks() const;
+
+    private:
+        void unmap();
+
+        const std::byte* data = nullptr;
+        std::size_t length = 0;
+        // owns the file contents on platforms without mmap
+        std::vector<std::byte> buffer;
+        bool with_positions = false;
+        std::size_t records = 0;
+        std::vector<pose_chunk> chunk_views;
+    };
+
+    /**
+     * Appends records to a new pose stream file, collecting them in chunks of chunk_size records,
+     * at most 2^32 - 1, or std::domain_error is thrown. A chunk is written once it is full or on
+     * flush(), the destructor flushes the rest.
+     */
+    class pose_writer {
+    public:
+        pose_writer(const std::string& path, bool with_positions, std::size_t chunk_size = 4096);
+        pose_writer(pose_writer&&) = default;
+        pose_writer& operator=(pose_writer&&) = default;
+        ~pose_writer();
+
+        void append(double time, const quaternion& orientation);
+        void append(double time, const quaternion& orientation, const xyz& position);
+        /**
+         * Appends one record per time, positions must be empty exactly if the stream has none
+         */
+        void append(std::span<const double> times, std::span<const quaternion> orientations,
+                    std::span<const xyz> positions = {});
+        /**
+         * Writes the records collected so far as a chunk and flushes the file
+         */
+        void flush();
+
+    private:
+        void write_chunk();
+
+        bool with_positions;
+        std::size_t chunk_size;
+        // opened after chunk_size is checked
+        std::ofstream file;
+        std::vector<double> times;
+        std::vector<quaternion> orientations;
+        std::vector<xyz> positions;
+    };
+}
+
+#endif //QUATERNIONS_POSE_STREAM_H
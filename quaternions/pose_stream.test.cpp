@@ -0,0 +1,142 @@
+#include <catch2/catch_test_macros.hpp>
+#include "pose_stream.h"
+#include "rotator.h"
+#include <cstdint>
+#include <filesystem>
+#include <fstream>
+#include <iterator>
+#include <limits>
+#include <stdexcept>
+#include <string>
+#include <vector>
+#include "../test/helpers.h"
+
+namespace q = quaternions;
+
+namespace {
+    std::string temporary_path(const std::string& name) {
+        return (std::filesystem::temp_directory_path() / ("quaternions_" + name)).string();
+    }
+
+    std::string contents(const std::string& path) {
+        auto file = std::ifstream(path, std::ios::binary);
+        return {std::istreambuf_iterator<char>(file), std::istreambuf_iterator<char>()};
+    }
+
+    std::vector<double> times(std::size_t n) {
+        auto result = std::vector<double>(n);
+        for (std::size_t i = 0; i < n; ++i)
+            result[i] = 0.01 * static_cast<double>(i);
+        return result;
+    }
+}
+
+TEST_CASE("pose stream round trip with positions")
+{
+    const auto path = temporary_path("poses_with_positions.qpose");
+    const auto ts = times(1000);
+    const auto orientations = random_unit_quaternions(1000, 1);
+    const auto positions = random_vectors(1000, 2);
+    {
+        auto writer = q::pose_writer(path, true, 256);
+        writer.append(ts[0], orientations[0], positions[0]);
+        writer.append(std::span(ts).subspan(1), std::span(orientations).subspan(1), std::span(positions).subspan(1));
+    }
+
+    const auto reader = q::pose_reader(path);
+    CHECK(reader.has_positions());
+    CHECK(reader.size() == 1000);
+    REQUIRE(reader.chunks().size() == 4);
+    std::size_t i = 0;
+    for (const auto& chunk : reader.chunks()) {
+        CHECK(reinterpret_cast<std::uintptr_t>(chunk.orientations.data()) % 64 == 0);
+        CHECK(reinterpret_cast<std::uintptr_t>(chunk.positions.data()) % 64 == 0);
+        REQUIRE(chunk.positions.size() == chunk.times.size());
+        for (std::size_t j = 0; j < chunk.times.size(); ++j, ++i) {
+            CHECK(chunk.times[j] == ts[i]);
+            CHECK(chunk.orientations[j] == orientations[i]);
+            CHECK(chunk.positions[j].x == positions[i].x);
+            CHECK(chunk.positions[j].z == positions[i].z);
+        }
+    }
+    CHECK(i == 1000);
+    std::filesystem::remove(path);
+}
+
+TEST_CASE("pose stream spans go straight into batch operations")
+{
+    const auto path = temporary_path("poses_without_positions.qpose");
+    const auto orientations = random_unit_quaternions(10, 3);
+    {
+        auto writer = q::pose_writer(path, false);
+        writer.append(times(10), orientations);
+        CHECK_THROWS(writer.append(1.0, orientations[0], {1, 2, 3}));
+    }
+    const auto reader = q::pose_reader(path);
+    CHECK_FALSE(reader.has_positions());
+    REQUIRE(reader.chunks().size() == 1);
+    const auto& chunk = reader.chunks()[0];
+    CHECK(chunk.positions.empty());
+
+    const auto rotator = q::rotator::from_quaternion(chunk.orientations[0]).value();
+    const auto vectors = random_vectors(10, 4);
+    auto rotated = std::vector<q::xyz>(10);
+    rotator.apply(vectors, rotated);
+    CHECK_THAT(rotated[3], WithinAbs(q::quaternion::from_vector(vectors[3]).rotated(orientations[0])->vector()));
+    std::filesystem::remove(path);
+}
+
+TEST_CASE("pose stream with a cut off last chunk keeps its complete chunks")
+{
+    const auto path = temporary_path("poses_cut_off.qpose");
+    {
+        auto writer = q::pose_writer(path, false, 4);
+        writer.append(times(10), random_unit_quaternions(10, 5));
+    }
+    std::filesystem::resize_file(path, std::filesystem::file_size(path) - 1);
+    const auto reader = q::pose_reader(path);
+    CHECK(reader.chunks().size() == 2);
+    CHECK(reader.size() == 8);
+    std::filesystem::remove(path);
+}
+
+TEST_CASE("reading files which are no pose stream should fail")
+{
+    const auto path = temporary_path("no_poses.qpose");
+    {
+        auto file = std::ofstream(path, std::ios::binary);
+        file << "{ w: 1, x: 0, y: 0, z: 0 }";
+    }
+    CHECK_THROWS_AS(q::pose_reader(path), std::domain_error);
+    {
+        auto writer = q::pose_writer(path, false);
+    }
+    {
+        // bump the version
+        auto file = std::fstream(path, std::ios::binary | std::ios::in | std::ios::out);
+        file.seekp(8);
+        const char version[4] = {2, 0, 0, 0};
+        file.write(version, 4);
+    }
+    CHECK_THROWS_AS(q::pose_reader(path), std::domain_error);
+    std::filesystem::remove(path);
+    CHECK_THROWS(q::pose_reader(path));
+}
+
+TEST_CASE("chunks too large for their record count should fail")
+{
+    if constexpr (sizeof(std::size_t) > sizeof(std::uint32_t)) {
+        const auto path = temporary_path("huge_chunks.qpose");
+        {
+            auto writer = q::pose_writer(path, false);
+            writer.append(times(3), random_unit_quaternions(3, 4));
+        }
+        const auto before = contents(path);
+        const auto too_large = std::size_t{std::numeric_limits<std::uint32_t>::max()} + 1;
+        CHECK_THROWS_AS(q::pose_writer(path, false, too_large), std::domain_error);
+        // the existing stream is left as it was
+        CHECK(contents(path) == before);
+        CHECK(q::pose_reader(path).size() == 3);
+        std::filesystem::remove(path);
+    }
+}
@@ -0,0 +1,49 @@
+#include <catch2/catch_test_macros.hpp>
+#include <catch2/benchmark/catch_benchmark.hpp>
+#include "products.h"
+#include "quaternion_batch.h"
+#include <vector>
+#include "../test/benchmarks.h"
+#include "../test/helpers.h"
+
+namespace q = quaternions;
+
+TEST_CASE("separate and fused products")
+{
+    for (const auto n : benchmark_batch_sizes) {
+        const auto a = random_quaternions(n, 1);
+        const auto b = random_quaternions(n, 2);
+        auto even = std::vector<q::quaternion>(n);
+        auto odd = std::vector<q::quaternion>(n);
+        BENCHMARK("grassmann_even and euclidean_odd in two passes x" + batch_label(n)) {
+            for (std::size_t i = 0; i < n; ++i)
+                even[i] = q::grassmann_even(a[i], b[i]);
+            for (std::size_t i = 0; i < n; ++i)
+                odd[i] = q::euclidean_odd(a[i], b[i]);
+            return odd[0];
+        };
+        BENCHMARK("grassmann_even and euclidean_odd fused x" + batch_label(n)) {
+            for (std::size_t i = 0; i < n; ++i) {
+                const auto all = q::products(a[i], b[i]);
+                even[i] = all.grassmann_even;
+                odd[i] = all.euclidean_odd;
+            }
+            return odd[0];
+        };
+
+        const auto pa = q::quaternion_batch::from(a);
+        const auto pb = q::quaternion_batch::from(b);
+        auto product = q::quaternion_batch(n);
+        auto dots = q::quaternion_batch::storage(n);
+        BENCHMARK("batch multiply then dots x" + batch_label(n)) {
+            q::multiply(pa, pb, product);
+            for (std::size_t i = 0; i < n; ++i)
+                dots[i] = pa.w[i] * pb.w[i] + pa.x[i] * pb.x[i] + pa.y[i] * pb.y[i] + pa.z[i] * pb.z[i];
+            return dots[0];
+        };
+        BENCHMARK("batch products grassmann and euclidean_even x" + batch_label(n)) {
+            q::products(pa, pb, {.grassmann = &product, .euclidean_even = &dots});
+            return dots[0];
+        };
+    }
+}
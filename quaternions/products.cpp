@@ -0,0 +1,41 @@
+#include "products.h"
+#include "dispatch.h"
+#include <stdexcept>
+#include <string>
+
+namespace q = quaternions;
+namespace k = quaternions::kernels;
+
+namespace {
+    /**
+     * out resized to n, or nowhere if there is no out
+     */
+    k::soa_out resized(q::quaternion_batch* out, std::size_t n) {
+        if (!out)
+            return {nullptr, nullptr, nullptr, nullptr};
+        out->resize(n);
+        return {out->w.data(), out->x.data(), out->y.data(), out->z.data()};
+    }
+}
+
+void q::products(const quaternion_batch& p, const quaternion_batch& q, const product_batches& out) {
+    if (p.size() != q.size())
+        throw std::domain_error("batch sizes " + std::to_string(p.size()) +
+                                " and " + std::to_string(q.size()) + " differ!");
+    const auto n = p.size();
+    // an output may be an input, so the inputs are viewed after every output is resized
+    auto targets = k::soa_products{
+        resized(out.grassmann, n),
+        resized(out.grassmann_even, n),
+        resized(out.grassmann_odd, n),
+        resized(out.euclidean, n),
+        nullptr,
+        resized(out.euclidean_odd, n),
+    };
+    if (out.euclidean_even) {
+        out.euclidean_even->resize(n);
+        targets.euclidean_even = out.euclidean_even->data();
+    }
+    k::active().products({p.w.data(), p.x.data(), p.y.data(), p.z.data()},
+                         {q.w.data(), q.x.data(), q.y.data(), q.z.data()}, targets, n);
+}
@@ -0,0 +1,104 @@
+#ifndef QUATERNIONS_PRODUCTS_H
+#define QUATERNIONS_PRODUCTS_H
+
+#include "quaternion.h"
+#include "quaternion_batch.h"
+
+/**
+ * The Grassmann product p * q and the Euclidean product p.conjugated() * q split into their even
+ * (symmetric) and odd (antisymmetric) parts. For p = (a, u) and q = (b, v):
+ *
+ *     Grassmann even  (pq + qp) / 2    = (ab - u·v, a v + b u)
+ *     Grassmann odd   (pq - qp) / 2    = (0, u × v)                 p.cross(q)
+ *     Euclidean even  (p*q + q*p) / 2  = (ab + u·v, 0)              p.dot(q)
+ *     Euclidean odd   (p*q - q*p) / 2  = (0, a v - b u - u × v)
+ *
+ * All of them are built from the same few terms, so products() computes any of them together in
+ * one pass over the operands.
+ */
+namespace quaternions {
+    template<typename T>
+    constexpr basic_quaternion<T> grassmann_even(const basic_quaternion<T>& p, const basic_quaternion<T>& q) {
+        return {p.w * q.w - p.x * q.x - p.y * q.y - p.z * q.z,
+                p.w * q.x + q.w * p.x, p.w * q.y + q.w * p.y, p.w * q.z + q.w * p.z};
+    }
+
+    template<typename T>
+    constexpr basic_quaternion<T> grassmann_odd(const basic_quaternion<T>& p, const basic_quaternion<T>& q) {
+        return p.cross(q);
+    }
+
+    template<typename T>
+    constexpr basic_quaternion<T> euclidean(const basic_quaternion<T>& p, const basic_quaternion<T>& q) {
+        return p.conjugated() * q;
+    }
+
+    template<typename T>
+    constexpr basic_quaternion<T> euclidean_even(const basic_quaternion<T>& p, const basic_quaternion<T>& q) {
+        return {p.dot(q), 0, 0, 0};
+    }
+
+    template<typename T>
+    constexpr basic_quaternion<T> euclidean_odd(const basic_quaternion<T>& p, const basic_quaternion<T>& q) {
+        return {0,
+                p.w * q.x - q.w * p.x - (p.y * q.z - p.z * q.y),
+                p.w * q.y - q.w * p.y - (p.z * q.x - p.x * q.z),
+                p.w * q.z - q.w * p.z - (p.x * q.y - p.y * q.x)};
+    }
+
+    template<typename T>
+    struct basic_product_set {
+        basic_quaternion<T> grassmann;
+        basic_quaternion<T> grassmann_even;
+        basic_quaternion<T> grassmann_odd;
+        basic_quaternion<T> euclidean;
+        basic_quaternion<T> euclidean_even;
+        basic_quaternion<T> euclidean_odd;
+    };
+
+    using product_set = basic_product_set<double>;
+
+    /**
+     * All products of p and q from one set of shared terms. Inlined, the compiler drops the terms
+     * of products that are not used.
+     */
+    template<typename T>
+    constexpr basic_product_set<T> products(const basic_quaternion<T>& p, const basic_quaternion<T>& q) {
+        const auto ab = p.w * q.w;
+        const auto uv = p.x * q.x + p.y * q.y + p.z * q.z;
+        const basic_xyz<T> cross{p.y * q.z - p.z * q.y, p.z * q.x - p.x * q.z, p.x * q.y - p.y * q.x};
+        // a v + b u and a v - b u
+        const basic_xyz<T> sum{p.w * q.x + q.w * p.x, p.w * q.y + q.w * p.y, p.w * q.z + q.w * p.z};
+        const basic_xyz<T> difference{p.w * q.x - q.w * p.x, p.w * q.y - q.w * p.y, p.w * q.z - q.w * p.z};
+        return {
+            {ab - uv, sum.x + cross.x, sum.y + cross.y, sum.z + cross.z},
+            {ab - uv, sum.x, sum.y, sum.z},
+            {0, cross.x, cross.y, cross.z},
+            {ab + uv, difference.x - cross.x, difference.y - cross.y, difference.z - cross.z},
+            {ab + uv, 0, 0, 0},
+            {0, difference.x - cross.x, difference.y - cross.y, difference.z - cross.z},
+        };
+    }
+
+    /**
+     * Where products() of two batches goes, products left nullptr are not computed. Every output
+     * is resized to fit and may be one of the inputs. Only the real parts of the Euclidean even
+     * product are written, its vector parts are always zero.
+     */
+    struct product_batches {
+        quaternion_batch* grassmann = nullptr;
+        quaternion_batch* grassmann_even = nullptr;
+        quaternion_batch* grassmann_odd = nullptr;
+        quaternion_batch* euclidean = nullptr;
+        quaternion_batch::storage* euclidean_even = nullptr;
+        quaternion_batch* euclidean_odd = nullptr;
+    };
+
+    /**
+     * The requested products of every pair p[i], q[i] in one pass of the batch kernels.
+     * Throws std::domain_error if the batch sizes differ.
+     */
+    void products(const quaternion_batch& p, const quaternion_batch& q, const product_batches& out);
+}
+
+#endif //QUATERNIONS_PRODUCTS_H
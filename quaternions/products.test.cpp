@@ -0,0 +1,105 @@
+#include <catch2/catch_test_macros.hpp>
+#include <catch2/matchers/catch_matchers_floating_point.hpp>
+#include "dispatch.h"
+#include "products.h"
+#include "quaternion.h"
+#include "quaternion_batch.h"
+#include <stdexcept>
+#include "../test/helpers.h"
+
+namespace q = quaternions;
+namespace k = quaternions::kernels;
+
+namespace {
+    k::soa_in in(const q::quaternion_batch& b) {
+        return {b.w.data(), b.x.data(), b.y.data(), b.z.data()};
+    }
+
+    k::soa_out out(q::quaternion_batch& b) {
+        return {b.w.data(), b.x.data(), b.y.data(), b.z.data()};
+    }
+}
+
+TEST_CASE("even and odd products are the symmetric and antisymmetric parts")
+{
+    const auto p = q::quaternion{1, 2, 3, 4};
+    const auto r = q::quaternion{-0.5, 0.25, 2, -1};
+    CHECK_THAT(q::grassmann_even(p, r), WithinAbs((p * r + r * p) * 0.5));
+    CHECK_THAT(q::grassmann_odd(p, r), WithinAbs((p * r - r * p) * 0.5));
+    CHECK_THAT(q::grassmann_odd(p, r), WithinAbs(p.cross(r)));
+    CHECK_THAT(q::euclidean(p, r), WithinAbs(p.conjugated() * r));
+    const auto pr = p.conjugated() * r;
+    const auto rp = r.conjugated() * p;
+    CHECK_THAT(q::euclidean_even(p, r), WithinAbs((pr + rp) * 0.5));
+    CHECK(q::euclidean_even(p, r).w == p.dot(r));
+    CHECK_THAT(q::euclidean_odd(p, r), WithinAbs((pr - rp) * 0.5));
+    CHECK_THAT(q::grassmann_even(p, r) + q::grassmann_odd(p, r), WithinAbs(p * r));
+    CHECK_THAT(q::euclidean_even(p, r) + q::euclidean_odd(p, r), WithinAbs(pr));
+}
+
+TEST_CASE("fused products match the single ones")
+{
+    const auto a = random_quaternions(50, 1);
+    const auto b = random_quaternions(50, 2);
+    for (std::size_t i = 0; i < a.size(); ++i) {
+        const auto all = q::products(a[i], b[i]);
+        CHECK_THAT(all.grassmann, WithinAbs(a[i] * b[i]));
+        CHECK_THAT(all.grassmann_even, WithinAbs(q::grassmann_even(a[i], b[i])));
+        CHECK_THAT(all.grassmann_odd, WithinAbs(q::grassmann_odd(a[i], b[i])));
+        CHECK_THAT(all.euclidean, WithinAbs(q::euclidean(a[i], b[i])));
+        CHECK_THAT(all.euclidean_even, WithinAbs(q::euclidean_even(a[i], b[i])));
+        CHECK_THAT(all.euclidean_odd, WithinAbs(q::euclidean_odd(a[i], b[i])));
+    }
+    static_assert(q::products(q::quaternion{1, 0, 0, 0}, q::quaternion{0, 1, 0, 0}).grassmann_even.x == 1);
+}
+
+TEST_CASE("product kernels of every supported level match the fused scalar products")
+{
+    const auto n = std::size_t{37};
+    const auto a = q::quaternion_batch::from(random_quaternions(n, 3));
+    const auto b = q::quaternion_batch::from(random_quaternions(n, 4));
+    for (const auto level : q::supported_isas()) {
+        INFO("instruction set level " << q::to_string(level));
+        auto grassmann = q::quaternion_batch(n), grassmann_even = q::quaternion_batch(n);
+        auto grassmann_odd = q::quaternion_batch(n), euclidean = q::quaternion_batch(n);
+        auto euclidean_odd = q::quaternion_batch(n);
+        auto euclidean_even = q::quaternion_batch::storage(n);
+        k::table_for(level)->products(in(a), in(b), {out(grassmann), out(grassmann_even), out(grassmann_odd),
+                                                     out(euclidean), euclidean_even.data(), out(euclidean_odd)}, n);
+        for (std::size_t i = 0; i < n; ++i) {
+            const auto all = q::products(a[i], b[i]);
+            CHECK_THAT(grassmann[i], WithinAbs(all.grassmann));
+            CHECK_THAT(grassmann_even[i], WithinAbs(all.grassmann_even));
+            CHECK_THAT(grassmann_odd[i], WithinAbs(all.grassmann_odd));
+            CHECK_THAT(euclidean[i], WithinAbs(all.euclidean));
+            CHECK_THAT(euclidean_even[i], Catch::Matchers::WithinAbs(all.euclidean_even.w, 1E-12));
+            CHECK_THAT(euclidean_odd[i], WithinAbs(all.euclidean_odd));
+        }
+    }
+}
+
+TEST_CASE("batch products compute only the requested products")
+{
+    const auto a = q::quaternion_batch::from(random_quaternions(21, 5));
+    const auto b = q::quaternion_batch::from(random_quaternions(21, 6));
+    auto odd = q::quaternion_batch{};
+    auto dots = q::quaternion_batch::storage{};
+    q::products(a, b, {.grassmann_odd = &odd, .euclidean_even = &dots});
+    REQUIRE(odd.size() == a.size());
+    REQUIRE(dots.size() == a.size());
+    for (std::size_t i = 0; i < a.size(); ++i) {
+        CHECK_THAT(odd[i], WithinAbs(a[i].cross(b[i])));
+        CHECK_THAT(dots[i], Catch::Matchers::WithinAbs(a[i].dot(b[i]), 1E-12));
+    }
+
+    // an output may be an input
+    auto p = a;
+    auto even = q::quaternion_batch{};
+    q::products(p, b, {.grassmann = &p, .grassmann_even = &even});
+    for (std::size_t i = 0; i < a.size(); ++i) {
+        CHECK_THAT(p[i], WithinAbs(a[i] * b[i]));
+        CHECK_THAT(even[i], WithinAbs(q::grassmann_even(a[i], b[i])));
+    }
+
+    CHECK_THROWS_AS(q::products(a, q::quaternion_batch(20), {.grassmann = &odd}), std::domain_error);
+}
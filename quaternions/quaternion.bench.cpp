@@ -0,0 +1,109 @@
+#include <catch2/catch_test_macros.hpp>
+#include <catch2/benchmark/catch_benchmark.hpp>
+#include "quaternion.h"
+#include "xyz.h"
+#include <cmath>
+#include <iterator>
+#include <vector>
+#include "../test/benchmarks.h"
+#include "../test/helpers.h"
+
+namespace q = quaternions;
+
+namespace {
+    const auto n_max = benchmark_batch_sizes[std::size(benchmark_batch_sizes) - 1];
+    const auto operands = random_quaternions(n_max, 1);
+    const auto rotations = random_unit_quaternions(n_max, 2);
+    const auto vectors = random_vectors(n_max, 3);
+}
+
+TEST_CASE("product")
+{
+    const auto& a = operands[0];
+    const auto& b = operands[1];
+    BENCHMARK("product") { return a * b; };
+    benchmark_batches("product", operands, [&](const q::quaternion& qa) { return qa * b; });
+}
+
+TEST_CASE("rotated")
+{
+    const auto v = q::quaternion::from_vector(vectors[0]);
+    const auto& r = rotations[0];
+    BENCHMARK("rotated") { return v.rotated(r); };
+    benchmark_batches("rotated", rotations, [&](const q::quaternion& qr) { return v.rotated(qr); });
+}
+
+TEST_CASE("to_matrix")
+{
+    const auto& r = rotations[0];
+    BENCHMARK("to_matrix") { return r.to_matrix(); };
+    benchmark_batches("to_matrix", rotations, [](const q::quaternion& qr) { return qr.to_matrix(); });
+}
+
+TEST_CASE("from_rotation")
+{
+    auto axis_angles = std::vector<q::rotation>(n_max);
+    for (std::size_t i = 0; i < n_max; ++i)
+        axis_angles[i] = q::rotation{vectors[i].normalized(), operands[i].w * M_PI};
+    const auto& r = axis_angles[0];
+    BENCHMARK("from_rotation") { return q::quaternion::from_rotation(r); };
+    benchmark_batches("from_rotation", axis_angles, [](const q::rotation& ri) {
+        return q::quaternion::from_rotation(ri);
+    });
+}
+
+TEST_CASE("rotation")
+{
+    const auto& r = rotations[0];
+    BENCHMARK("rotation") { return r.rotation(); };
+    benchmark_batches("rotation", rotations, [](const q::quaternion& qr) { return qr.rotation(); });
+}
+
+TEST_CASE("normalized")
+{
+    const auto& a = operands[0];
+    BENCHMARK("normalized") { return a.normalized(); };
+    benchmark_batches("normalized", operands, [](const q::quaternion& qa) { return qa.normalized(); });
+}
+
+TEST_CASE("inverted")
+{
+    const auto& a = operands[0];
+    BENCHMARK("inverted") { return a.inverted(); };
+    benchmark_batches("inverted", operands, [](const q::quaternion& qa) { return qa.inverted(); });
+}
+
+TEST_CASE("to_string")
+{
+    const auto& a = operands[0];
+    BENCHMARK("to_string") { return a.to_string(); };
+    benchmark_batches("to_string", operands, [](const q::quaternion& qa) { return qa.to_string(); });
+}
+
+TEST_CASE("to_chars and from_chars")
+{
+    const auto& a = operands[0];
+    char buffer[q::max_chars<q::quaternion>];
+    BENCHMARK("to_chars") { return q::to_chars(std::begin(buffer), std::end(buffer), a).ptr; };
+
+    for (const auto n : benchmark_batch_sizes) {
+        // one quaternion per line, like a pose log
+        auto log = std::vector<char>(n * (q::max_chars<q::quaternion> + 1));
+        auto end = log.data();
+        BENCHMARK("to_chars log x" + batch_label(n)) {
+            end = log.data();
+            for (std::size_t i = 0; i < n; ++i) {
+                end = q::to_chars(end, log.data() + log.size(), operands[i]).ptr;
+                *end++ = '\n';
+            }
+            return end;
+        };
+        auto parsed = std::vector<q::quaternion>(n);
+        BENCHMARK("from_chars log x" + batch_label(n)) {
+            auto p = static_cast<const char*>(log.data());
+            for (std::size_t i = 0; i < n; ++i)
+                p = q::from_chars(p, end, parsed[i]).ptr + 1;
+            return p;
+        };
+    }
+}
@@ -1,52 +1,368 @@
 #ifndef QUATERNIONS_QUATERNION_H
 #define QUATERNIONS_QUATERNION_H
+#include <cmath>
 #include <optional>
 #include <string>
+#include <type_traits>
 #include "xyz.h"
 
 namespace quaternions {
-    struct rotation {
-        xyz axis;
-        double angle;
+    template<typename T>
+    struct basic_rotation {
+        basic_xyz<T> axis;
+        T angle;
     };
 
-    class quaternion {
+    template<typename T>
+    class basic_quaternion {
     public:
-        double w;
-        double x;
-        double y;
-        double z;
-        quaternion static from_vector(const xyz& v);
-        quaternion static from_rotation(rotation r);
+        T w;
+        T x;
+        T y;
+        T z;
+        constexpr basic_quaternion static from_vector(const basic_xyz<T>& v);
+        basic_quaternion static from_rotation(basic_rotation<T> r);
+        /**
+         * Unit quaternion of a rotation matrix (Shepperd's method), its sign is chosen so that
+         * its largest component is positive
+         */
+        basic_quaternion static from_matrix(const basic_matrix_3x3<T>& m);
         std::string to_string() const;
-        xyz vector() const;
-        double scalar() const;
-        rotation rotation() const;
-        quaternion inverted() const;
-        quaternion conjugated() const;
-        quaternion operator-() const;
-        quaternion cross(const quaternion& other) const;
-        double dot(const quaternion& other) const;
-        double norm() const;
-        double length() const;
-        quaternion normalized() const;
-        quaternion polar_direction() const;
-        double polar_angle() const;
-        std::optional<quaternion> rotated(const quaternion& r) const;
-        matrix_3x3 to_matrix() const;
+        constexpr basic_xyz<T> vector() const;
+        constexpr T scalar() const;
+        basic_rotation<T> rotation() const;
+        constexpr basic_quaternion inverted() const;
+        constexpr basic_quaternion conjugated() const;
+        constexpr basic_quaternion operator-() const;
+        constexpr basic_quaternion cross(const basic_quaternion& other) const;
+        constexpr T dot(const basic_quaternion& other) const;
+        constexpr T norm() const;
+        T length() const;
+        basic_quaternion normalized() const;
+        basic_quaternion polar_direction() const;
+        T polar_angle() const;
+        std::optional<basic_quaternion> rotated(const basic_quaternion& r) const;
+        constexpr basic_matrix_3x3<T> to_matrix() const;
     };
 
-    quaternion operator+(const quaternion& a, const quaternion& b);
-    quaternion operator+(const quaternion& q, const double s);
-    quaternion operator+(const double s, const quaternion& q);
-    quaternion operator-(const quaternion& a, const quaternion& b);
-    quaternion operator*(const quaternion& a, const quaternion& b);
-    quaternion operator*(const quaternion& q, const double s);
-    quaternion operator*(const double s, const quaternion& q);
-
-    bool operator==(const quaternion& a, const quaternion& b);
-    bool almost_equal(double a, double b, double eps = 1E-12);
-    bool almost_equal(const quaternion& a, const quaternion& b, double eps = 1E-12);
+    template<typename T>
+    constexpr basic_quaternion<T> operator+(const basic_quaternion<T>& a, const basic_quaternion<T>& b);
+    template<typename T>
+    constexpr basic_quaternion<T> operator+(const basic_quaternion<T>& q, const std::type_identity_t<T> s);
+    template<typename T>
+    constexpr basic_quaternion<T> operator+(const std::type_identity_t<T> s, const basic_quaternion<T>& q);
+    template<typename T>
+    constexpr basic_quaternion<T> operator-(const basic_quaternion<T>& a, const basic_quaternion<T>& b);
+    template<typename T>
+    constexpr basic_quaternion<T> operator*(const basic_quaternion<T>& a, const basic_quaternion<T>& b);
+    template<typename T>
+    constexpr basic_quaternion<T> operator*(const basic_quaternion<T>& q, const std::type_identity_t<T> s);
+    template<typename T>
+    constexpr basic_quaternion<T> operator*(const std::type_identity_t<T> s, const basic_quaternion<T>& q);
+
+    /**
+     * r * q * r.conjugated() in one pass: for r = (w, u) and q = (s, v) this is
+     * (s |r|², (w² - u·u) v + 2 (u·v) u + 2 w u × v), without the intermediate product
+     */
+    template<typename T>
+    constexpr basic_quaternion<T> sandwich(const basic_quaternion<T>& r, const basic_quaternion<T>& q);
+
+    template<typename T>
+    constexpr bool operator==(const basic_quaternion<T>& a, const basic_quaternion<T>& b);
+    template<typename T>
+    constexpr bool almost_equal(const basic_quaternion<T>& a, const basic_quaternion<T>& b,
+                                std::type_identity_t<T> eps = default_eps<T>);
+
+    template<typename T>
+    inline constexpr std::size_t max_chars<basic_quaternion<T>> = 22 + 4 * max_chars<T>;
+
+    /**
+     * Writes q as `{ w: 1, x: 0, y: 0.5, z: -2 }` in shortest round-trip precision without allocating.
+     * Fails with std::errc::value_too_large if the buffer is smaller than needed, max_chars is always enough.
+     */
+    template<typename T>
+    std::to_chars_result to_chars(char* first, char* last, const basic_quaternion<T>& q);
+    /**
+     * Parses what to_chars writes, allowing any blanks between the tokens
+     */
+    template<typename T>
+    std::from_chars_result from_chars(const char* first, const char* last, basic_quaternion<T>& q);
+
+    using rotation = basic_rotation<double>;
+    using quaternion = basic_quaternion<double>;
+
+    template<typename T>
+    constexpr basic_quaternion<T> basic_quaternion<T>::from_vector(const basic_xyz<T>& v) {
+        return basic_quaternion{0, v.x, v.y, v.z};
+    }
+
+    template<typename T>
+    basic_quaternion<T> basic_quaternion<T>::from_rotation(basic_rotation<T> r) {
+        const auto s = std::sin(r.angle / T(2));
+        return basic_quaternion{
+            std::cos(r.angle / T(2)),
+            r.axis.x * s,
+            r.axis.y * s,
+            r.axis.z * s
+        };
+    }
+
+    template<typename T>
+    basic_quaternion<T> basic_quaternion<T>::from_matrix(const basic_matrix_3x3<T>& m) {
+        const auto trace = m.c1.x + m.c2.y + m.c3.z;
+        // 4w², 4x², 4y², 4z²: the largest one keeps the square root and the division accurate
+        const auto dw = 1 + trace;
+        const auto dx = 1 + 2 * m.c1.x - trace;
+        const auto dy = 1 + 2 * m.c2.y - trace;
+        const auto dz = 1 + 2 * m.c3.z - trace;
+        const auto xw = m.c2.z - m.c3.y;
+        const auto yw = m.c3.x - m.c1.z;
+        const auto zw = m.c1.y - m.c2.x;
+        const auto xy = m.c2.x + m.c1.y;
+        const auto xz = m.c3.x + m.c1.z;
+        const auto yz = m.c3.y + m.c2.z;
+
+        auto largest = dw;
+        auto q = basic_quaternion{dw, xw, yw, zw};
+        if (dx > largest) {
+            largest = dx;
+            q = {xw, dx, xy, xz};
+        }
+        if (dy > largest) {
+            largest = dy;
+            q = {yw, xy, dy, yz};
+        }
+        if (dz > largest) {
+            largest = dz;
+            q = {zw, xz, yz, dz};
+        }
+        return q * (T(0.5) / std::sqrt(largest));
+    }
+
+    template<typename T>
+    std::string basic_quaternion<T>::to_string() const
+    {
+        char buffer[max_chars<basic_quaternion>];
+        return std::string(buffer, to_chars(std::begin(buffer), std::end(buffer), *this).ptr);
+    }
+
+    template<typename T>
+    constexpr basic_xyz<T> basic_quaternion<T>::vector() const
+    {
+        return basic_xyz<T>{x, y, z};
+    }
+
+    template<typename T>
+    constexpr T basic_quaternion<T>::scalar() const
+    {
+        return w;
+    }
+
+    template<typename T>
+    basic_rotation<T> basic_quaternion<T>::rotation() const {
+        auto const divisor = std::sqrt(1 - w * w);
+        return basic_rotation<T>{
+            basic_xyz<T>{
+                (x / divisor),
+                (y / divisor),
+                (z / divisor)
+            },
+            2 * std::acos(w)
+        };
+    }
+
+    template<typename T>
+    constexpr basic_quaternion<T> basic_quaternion<T>::inverted() const {
+        const auto amplitude_squared = w * w + x * x + y * y + z * z;
+        const auto conj = conjugated();
+        return basic_quaternion{
+            conj.w / amplitude_squared,
+            conj.x / amplitude_squared,
+            conj.y / amplitude_squared,
+            conj.z / amplitude_squared
+        };
+    }
+
+    template<typename T>
+    constexpr basic_quaternion<T> basic_quaternion<T>::conjugated() const {
+        return basic_quaternion{w, -x, -y, -z};
+    }
+
+    template<typename T>
+    constexpr basic_quaternion<T> basic_quaternion<T>::operator-() const {
+        return basic_quaternion{-w, -x, -y, -z};
+    }
+
+    template<typename T>
+    constexpr basic_quaternion<T> basic_quaternion<T>::cross(const basic_quaternion& other) const {
+        return basic_quaternion{
+                0,
+                this->y * other.z - this->z * other.y,
+                this->z * other.x - this->x * other.z,
+                this->x * other.y - this->y * other.x,
+        };
+    }
+
+    template<typename T>
+    constexpr T basic_quaternion<T>::dot(const basic_quaternion& other) const {
+        return
+                this->w * other.w +
+                this->x * other.x +
+                this->y * other.y +
+                this->z * other.z;
+    }
+
+    template<typename T>
+    constexpr T basic_quaternion<T>::norm() const {
+        return dot(*this);
+    }
+
+    template<typename T>
+    T basic_quaternion<T>::length() const {
+        return std::sqrt(norm());
+    }
+
+    template<typename T>
+    basic_quaternion<T> basic_quaternion<T>::normalized() const {
+        const auto t_norm = length();
+        return basic_quaternion{
+                w / t_norm,
+                x / t_norm,
+                y / t_norm,
+                z / t_norm
+        };
+    }
+
+    template<typename T>
+    basic_quaternion<T> basic_quaternion<T>::polar_direction() const {
+        const auto diff = *this - conjugated();
+        const auto length = diff.length();
+        return basic_quaternion{
+            0,
+            diff.x / length,
+            diff.y / length,
+            diff.z / length,
+        };
+    }
+
+    template<typename T>
+    T basic_quaternion<T>::polar_angle() const {
+        const auto scalar_val = (*this + conjugated()).scalar();
+        return std::acos(scalar_val/(2*length()));
+    }
+
+    template<typename T>
+    std::optional<basic_quaternion<T>> basic_quaternion<T>::rotated(const basic_quaternion& r) const {
+        if(!almost_equal(r.length(), T(1)))
+            return std::nullopt;
+        return sandwich(r, *this);
+    }
+
+    template<typename T>
+    constexpr basic_matrix_3x3<T> basic_quaternion<T>::to_matrix() const {
+        return {
+            {1 - 2 * (y * y + z * z), 2 * (x * y + z * w), 2 * (x * z - y * w)},
+            {2 * (x * y - z * w), 1 - 2 * (x * x + z * z), 2 * (y * z + x * w)},
+            {2 * (x * z + y * w), 2 * (y * z - x * w), 1 - 2 * (x * x + y * y)},
+        };
+    }
+
+    template<typename T>
+    constexpr basic_quaternion<T> operator+(const basic_quaternion<T>& a, const basic_quaternion<T>& b)
+    {
+        return basic_quaternion<T>{a.w + b.w, a.x + b.x, a.y + b.y, a.z + b.z};
+    }
+
+    template<typename T>
+    constexpr basic_quaternion<T> operator+(const basic_quaternion<T>& q, const std::type_identity_t<T> s) {
+        return q + basic_quaternion<T>{s, 0, 0, 0};
+    }
+
+    template<typename T>
+    constexpr basic_quaternion<T> operator+(const std::type_identity_t<T> s, const basic_quaternion<T>& q) {
+        return q + s;
+    }
+
+    template<typename T>
+    constexpr basic_quaternion<T> operator-(const basic_quaternion<T>& a, const basic_quaternion<T>& b)
+    {
+        return basic_quaternion<T>{a.w - b.w, a.x - b.x, a.y - b.y, a.z - b.z};
+    }
+
+    template<typename T>
+    constexpr basic_quaternion<T> operator*(const basic_quaternion<T>& a, const basic_quaternion<T>& b) {
+        return basic_quaternion<T>{
+            a.w * b.w - a.x * b.x - a.y * b.y - a.z * b.z,
+            a.w * b.x + a.x * b.w + a.y * b.z - a.z * b.y,
+            a.w * b.y - a.x * b.z + a.y * b.w + a.z * b.x,
+            a.w * b.z + a.x * b.y - a.y * b.x + a.z * b.w,
+        };
+    }
+
+    template<typename T>
+    constexpr basic_quaternion<T> operator*(const basic_quaternion<T>& q, const std::type_identity_t<T> s) {
+        return basic_quaternion<T>{
+            q.w * s,
+            q.x * s,
+            q.y * s,
+            q.z * s,
+        };
+    }
+
+    template<typename T>
+    constexpr basic_quaternion<T> operator*(const std::type_identity_t<T> s, const basic_quaternion<T>& q) {
+        return q * s;
+    }
+
+    template<typename T>
+    constexpr basic_quaternion<T> sandwich(const basic_quaternion<T>& r, const basic_quaternion<T>& q) {
+        const auto ww = r.w * r.w;
+        const auto uu = r.x * r.x + r.y * r.y + r.z * r.z;
+        const auto a = ww - uu;
+        const auto uv2 = 2 * (r.x * q.x + r.y * q.y + r.z * q.z);
+        const auto w2 = 2 * r.w;
+        return basic_quaternion<T>{
+            q.w * (ww + uu),
+            a * q.x + uv2 * r.x + w2 * (r.y * q.z - r.z * q.y),
+            a * q.y + uv2 * r.y + w2 * (r.z * q.x - r.x * q.z),
+            a * q.z + uv2 * r.z + w2 * (r.x * q.y - r.y * q.x),
+        };
+    }
+
+    template<typename T>
+    constexpr bool operator==(const basic_quaternion<T>& a, const basic_quaternion<T>& b) {
+        return a.w == b.w && a.x == b.x && a.y == b.y && a.z == b.z;
+    }
+
+    template<typename T>
+    constexpr bool almost_equal(const basic_quaternion<T>& a, const basic_quaternion<T>& b,
+                                std::type_identity_t<T> eps) {
+        return
+            almost_equal(a.w, b.w, eps) &&
+            almost_equal(a.x, b.x, eps) &&
+            almost_equal(a.y, b.y, eps) &&
+            almost_equal(a.z, b.z, eps);
+    }
+
+    template<typename T>
+    std::to_chars_result to_chars(char* first, char* last, const basic_quaternion<T>& q) {
+        return chars::write_fields(first, last, std::array{'w', 'x', 'y', 'z'}, std::array{q.w, q.x, q.y, q.z});
+    }
+
+    template<typename T>
+    std::from_chars_result from_chars(const char* first, const char* last, basic_quaternion<T>& q) {
+        auto values = std::array<T, 4>{};
+        const auto result = chars::read_fields(first, last, std::array{'w', 'x', 'y', 'z'}, values);
+        if (result.ec == std::errc{})
+            q = {values[0], values[1], values[2], values[3]};
+        return result;
+    }
 }
 
+#if defined(__cpp_lib_format)
+template<typename T>
+struct std::formatter<quaternions::basic_quaternion<T>, char>
+    : quaternions::chars::formatter<quaternions::basic_quaternion<T>> {};
+#endif
+
 #endif //QUATERNIONS_QUATERNION_H
@@ -1,9 +1,12 @@
 #include <catch2/catch_test_macros.hpp>
+#include <catch2/catch_template_test_macros.hpp>
 #include <catch2/matchers/catch_matchers_floating_point.hpp>
 #include <catch2/matchers/catch_matchers_templated.hpp>
 #include "quaternion.h"
 #include "xyz.h"
 #include <cmath>
+#include <iterator>
+#include <string>
 #include "../test/helpers.h"
 
 namespace q = quaternions;
@@ -266,3 +269,86 @@ TEST_CASE("rotation matrix: rotating pi/4 around z")
     CHECK_THAT(mr.c3, WithinAbs(q::xyz{0, 0, 1}));
 }
 
+TEST_CASE("quaternion from rotation matrix")
+{
+    // the identity and half turns around each axis pick every one of the four diagonal cases
+    const auto rotations = std::vector<q::quaternion>{
+        {1, 0, 0, 0}, {0, 1, 0, 0}, {0, 0, 1, 0}, {0, 0, 0, 1},
+        q::quaternion::from_rotation({{1, 0, 0}, 3.1}),
+        q::quaternion::from_rotation({{0, 1, 0}, 3.1}),
+        q::quaternion::from_rotation({{0, 0, 1}, 3.1}),
+    };
+    for (const auto& r : rotations)
+        CHECK_THAT(q::quaternion::from_matrix(r.to_matrix()), WithinAbs(r));
+    for (const auto& r : random_unit_quaternions(100, 1)) {
+        const auto sign = q::quaternion::from_matrix(r.to_matrix()).dot(r) < 0 ? -1.0 : 1.0;
+        CHECK_THAT(sign * q::quaternion::from_matrix(r.to_matrix()), WithinAbs(r));
+    }
+}
+
+TEMPLATE_TEST_CASE("quaternion arithmetic for every scalar type", "", float, double, long double)
+{
+    using quaternion = q::basic_quaternion<TestType>;
+    const auto qa = quaternion{TestType(0.1), TestType(0.2), TestType(0.3), TestType(0.4)};
+    const auto qb = quaternion{TestType(0.2), TestType(0.3), TestType(0.4), TestType(0.5)};
+    const auto eps = TestType(1E-6);
+    CHECK(q::almost_equal(qa * qb, quaternion{TestType(-0.36), TestType(0.06), TestType(0.12), TestType(0.12)}, eps));
+    CHECK(q::almost_equal(qa.normalized().length(), TestType(1), eps));
+    CHECK(q::almost_equal(qa * qa.inverted(), quaternion{1, 0, 0, 0}, eps));
+
+    const auto r = quaternion::from_rotation({{0, 0, 1}, TestType(M_PI_2)});
+    const auto v = quaternion::from_vector({1, 0, 0}).rotated(r);
+    REQUIRE(v.has_value());
+    CHECK(q::almost_equal(v->vector(), q::basic_xyz<TestType>{0, 1, 0}, eps));
+}
+
+TEST_CASE("quaternion arithmetic is usable in constant expressions")
+{
+    constexpr auto qa = q::quaternion{1, 2, 3, 4};
+    constexpr auto qb = q::quaternion{2, 3, 4, 5};
+    static_assert(qa * qb == q::quaternion{-36, 6, 12, 12});
+    static_assert(qa + qb == q::quaternion{3, 5, 7, 9});
+    static_assert(qa - 1.0 * qb == q::quaternion{-1, -1, -1, -1});
+    static_assert(qa.conjugated() == q::quaternion{1, -2, -3, -4});
+    static_assert(qa.dot(qb) == 40);
+    static_assert(qa.norm() == 30);
+    static_assert(q::quaternion::from_vector({1, 2, 3}).vector().dot({1, 1, 1}) == 6);
+    static_assert(q::quaternion{1, 0, 0, 0}.to_matrix()[1][1] == 1);
+    static_assert(q::almost_equal(qa * qa.inverted(), q::quaternion{1, 0, 0, 0}));
+    CHECK(true);
+}
+
+TEST_CASE("quaternion text round trips through to_chars and from_chars")
+{
+    CHECK(q::quaternion{1, 0, -0.25, 3E100}.to_string() == "{ w: 1, x: 0, y: -0.25, z: 3e+100 }");
+    for (const auto& qa : random_quaternions(100, 1)) {
+        char buffer[q::max_chars<q::quaternion>];
+        const auto written = q::to_chars(std::begin(buffer), std::end(buffer), qa);
+        REQUIRE(written.ec == std::errc{});
+        auto parsed = q::quaternion{};
+        CHECK(q::from_chars(buffer, written.ptr, parsed).ec == std::errc{});
+        CHECK(parsed == qa);
+    }
+
+    const auto f = q::basic_quaternion<float>{0.1f, 0.2f, 0.3f, 0.4f};
+    auto parsed = q::basic_quaternion<float>{};
+    const auto text = f.to_string();
+    CHECK(text == "{ w: 0.1, x: 0.2, y: 0.3, z: 0.4 }");
+    CHECK(q::from_chars(text.data(), text.data() + text.size(), parsed).ec == std::errc{});
+    CHECK(parsed == f);
+}
+
+TEST_CASE("quaternion text of the wrong shape is not parsed")
+{
+    const auto text = std::string("{ x: 1, y: 2, z: 3 }");
+    auto parsed = q::quaternion{};
+    CHECK(q::from_chars(text.data(), text.data() + text.size(), parsed).ec == std::errc::invalid_argument);
+}
+
+#if defined(__cpp_lib_format)
+TEST_CASE("quaternions and vectors in std::format")
+{
+    CHECK(std::format("{} {}", q::quaternion{1, 0, 0, 0.5}, q::xyz{1, 2, 3}) ==
+          "{ w: 1, x: 0, y: 0, z: 0.5 } { x: 1, y: 2, z: 3 }");
+}
+#endif
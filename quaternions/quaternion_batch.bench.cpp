@@ -0,0 +1,141 @@
+#include <catch2/catch_test_macros.hpp>
+#include <catch2/benchmark/catch_benchmark.hpp>
+#include "dispatch.h"
+#include "execution.h"
+#include "parallel.h"
+#include "quaternion_batch.h"
+#include "thread_pool.h"
+#include "trigonometry.h"
+#include <string>
+#include <vector>
+#include "../test/benchmarks.h"
+#include "../test/helpers.h"
+
+namespace q = quaternions;
+namespace k = quaternions::kernels;
+
+TEST_CASE("batch kernels per instruction set level")
+{
+    for (const auto n : benchmark_batch_sizes) {
+        const auto a = q::quaternion_batch::from(random_quaternions(n, 1));
+        const auto r = q::quaternion_batch::from(random_unit_quaternions(n, 2));
+        auto result = q::quaternion_batch(n);
+        auto matrices = std::vector<double>(9 * n);
+        const auto in_a = k::soa_in{a.w.data(), a.x.data(), a.y.data(), a.z.data()};
+        const auto in_r = k::soa_in{r.w.data(), r.x.data(), r.y.data(), r.z.data()};
+        const auto column_major = k::matrix_layout{9, {0, 1, 2, 3, 4, 5, 6, 7, 8}, 0, {}};
+        const auto out = k::soa_out{result.w.data(), result.x.data(), result.y.data(), result.z.data()};
+        for (const auto level : q::supported_isas()) {
+            const auto& kernels = *k::table_for(level);
+            const auto suffix = " " + q::to_string(level) + " x" + batch_label(n);
+            BENCHMARK("batch product" + suffix) {
+                kernels.multiply(in_a, in_r, out, n);
+                return result.w[0];
+            };
+            BENCHMARK("batch rotate" + suffix) {
+                kernels.rotate(in_a, in_r, out, n);
+                return result.w[0];
+            };
+            BENCHMARK("batch to_matrix" + suffix) {
+                kernels.to_matrix(in_r, column_major, matrices.data(), n);
+                return matrices[0];
+            };
+            BENCHMARK("batch from_matrix" + suffix) {
+                kernels.from_matrix(matrices.data(), column_major, out, n);
+                return result.w[0];
+            };
+        }
+    }
+}
+
+TEST_CASE("batch matrix formats")
+{
+    for (const auto n : benchmark_batch_sizes) {
+        const auto r = q::quaternion_batch::from(random_unit_quaternions(n, 3));
+        auto doubles = std::vector<double>(12 * n);
+        auto floats = std::vector<float>(12 * n);
+        auto result = q::quaternion_batch(n);
+        const auto row_major_3x4 = q::matrix_format{q::matrix_order::row_major, q::matrix_shape::transform_3x4};
+        BENCHMARK("to_matrix double row-major 3x4 x" + batch_label(n)) {
+            q::to_matrix(r, doubles, row_major_3x4);
+            return doubles[0];
+        };
+        BENCHMARK("to_matrix float row-major 3x4 x" + batch_label(n)) {
+            q::to_matrix(r, floats, row_major_3x4);
+            return floats[0];
+        };
+        BENCHMARK("from_matrix float row-major 3x4 x" + batch_label(n)) {
+            q::from_matrix(std::span<const float>(floats), result, row_major_3x4);
+            return result.w[0];
+        };
+        const auto matrices = r.to_matrix();
+        BENCHMARK("single from_matrix x" + batch_label(n)) {
+            for (std::size_t i = 0; i < n; ++i)
+                result.set(i, q::quaternion::from_matrix(matrices[i]));
+            return result.w[0];
+        };
+    }
+}
+
+TEST_CASE("batch operations on all policies")
+{
+    for (const auto n : benchmark_batch_sizes) {
+        const auto a = q::quaternion_batch::from(random_quaternions(n, 1));
+        const auto r = q::quaternion_batch::from(random_unit_quaternions(n, 2));
+        auto out = q::quaternion_batch(n);
+        BENCHMARK("multiply seq x" + batch_label(n)) {
+            q::multiply(q::execution::seq, a, r, out);
+            return out.w[0];
+        };
+        BENCHMARK("multiply par x" + batch_label(n)) {
+            q::multiply(q::execution::par, a, r, out);
+            return out.w[0];
+        };
+        BENCHMARK("rotate seq x" + batch_label(n)) {
+            return q::rotate(q::execution::seq, a, r, out);
+        };
+        BENCHMARK("rotate par x" + batch_label(n)) {
+            return q::rotate(q::execution::par, a, r, out);
+        };
+    }
+}
+
+TEST_CASE("scaling of batch operations with the number of threads")
+{
+    // one pool per thread count from 1 to hardware_threads(), doubling in between
+    const auto n = std::size_t{4'000'000};
+    const auto a = q::quaternion_batch::from(random_quaternions(n, 3));
+    const auto unit = random_unit_quaternions(n, 4);
+    const auto r = q::quaternion_batch::from(unit);
+    auto axis_angles = std::vector<q::rotation>(n);
+    for (std::size_t i = 0; i < n; ++i)
+        axis_angles[i] = unit[i].rotation();
+    auto out = q::quaternion_batch(n);
+    auto converted = std::vector<q::quaternion>(n);
+    auto matrices = std::vector<double>(9 * n);
+    auto thread_counts = std::vector<std::size_t>{};
+    for (std::size_t threads = 1; threads < q::hardware_threads(); threads *= 2)
+        thread_counts.push_back(threads);
+    thread_counts.push_back(q::hardware_threads());
+
+    for (const auto threads : thread_counts) {
+        auto pool = q::thread_pool(threads);
+        const auto policy = q::execution::par.on(pool);
+        const auto label = " x4M on " + std::to_string(threads) + " threads";
+        BENCHMARK("multiply" + label) {
+            q::multiply(policy, a, r, out);
+            return out.w[0];
+        };
+        BENCHMARK("rotate" + label) {
+            return q::rotate(policy, a, r, out);
+        };
+        BENCHMARK("to_matrix" + label) {
+            q::to_matrix(policy, r, std::span(matrices));
+            return matrices[0];
+        };
+        BENCHMARK("from_rotations" + label) {
+            q::from_rotations(policy, axis_angles, converted);
+            return converted[0];
+        };
+    }
+}
@@ -0,0 +1,370 @@
+#include "quaternion_batch.h"
+#include "dispatch.h"
+#include "parallel.h"
+#include <atomic>
+#include <stdexcept>
+#include <string>
+
+namespace q = quaternions;
+namespace k = quaternions::kernels;
+
+namespace {
+    // smallest chunks worth handing to another thread, some 30 µs of work each
+    constexpr std::size_t product_chunk = 16384;
+    constexpr std::size_t rotation_chunk = 8192;
+
+    k::soa_in view(const q::quaternion_batch& b, std::size_t begin = 0) {
+        return {b.w.data() + begin, b.x.data() + begin, b.y.data() + begin, b.z.data() + begin};
+    }
+
+    k::soa_out view(q::quaternion_batch& b, std::size_t begin = 0) {
+        return {b.w.data() + begin, b.x.data() + begin, b.y.data() + begin, b.z.data() + begin};
+    }
+
+    void check_sizes(const q::quaternion_batch& a, const q::quaternion_batch& b) {
+        if (a.size() != b.size())
+            throw std::domain_error("batch sizes " + std::to_string(a.size()) +
+                                    " and " + std::to_string(b.size()) + " differ!");
+    }
+
+    k::matrix_layout layout_of(q::matrix_format format) {
+        const auto columns = std::size_t{format.shape == q::matrix_shape::transform_3x4 ? 4u : 3u};
+        const auto index = [&](std::size_t row, std::size_t column) {
+            return format.order == q::matrix_order::column_major ? column * 3 + row : row * columns + column;
+        };
+        auto layout = k::matrix_layout{3 * columns, {}, 3 * (columns - 3), {}};
+        for (std::size_t k = 0; k < 9; ++k)
+            layout.offsets[k] = index(k % 3, k / 3);
+        for (std::size_t row = 0; row < layout.padding_count; ++row)
+            layout.padding[row] = index(row, 3);
+        return layout;
+    }
+
+    k::matrix_layout check_matrices(std::size_t quaternions, std::size_t elements, q::matrix_format format) {
+        const auto layout = layout_of(format);
+        if (elements != quaternions * layout.stride)
+            throw std::domain_error("a buffer of " + std::to_string(elements) + " elements does not hold " +
+                                    std::to_string(quaternions) + " matrices!");
+        return layout;
+    }
+
+    std::size_t matrix_count(std::size_t elements, q::matrix_format format) {
+        const auto stride = layout_of(format).stride;
+        if (elements % stride != 0)
+            throw std::domain_error("a buffer of " + std::to_string(elements) + " elements does not hold whole matrices!");
+        return elements / stride;
+    }
+
+    bool normalized(const q::quaternion_batch& r, std::size_t begin, std::size_t end) {
+        for (auto i = begin; i < end; ++i)
+            if (!q::almost_equal(r[i].length(), 1.0))
+                return false;
+        return true;
+    }
+}
+
+q::quaternion_batch::quaternion_batch(std::size_t size)
+    : w(size), x(size), y(size), z(size) {}
+
+q::quaternion_batch q::quaternion_batch::from(std::span<const quaternion> quaternions) {
+    auto batch = quaternion_batch(quaternions.size());
+    for (std::size_t i = 0; i < quaternions.size(); ++i)
+        batch.set(i, quaternions[i]);
+    return batch;
+}
+
+q::quaternion_batch q::quaternion_batch::from_matrix(std::span<const matrix_3x3> matrices) {
+    static_assert(sizeof(matrix_3x3) == 9 * sizeof(double));
+    auto batch = quaternion_batch{};
+    quaternions::from_matrix({reinterpret_cast<const double*>(matrices.data()), 9 * matrices.size()}, batch);
+    return batch;
+}
+
+std::size_t q::quaternion_batch::size() const {
+    return w.size();
+}
+
+bool q::quaternion_batch::empty() const {
+    return w.empty();
+}
+
+void q::quaternion_batch::resize(std::size_t size) {
+    w.resize(size);
+    x.resize(size);
+    y.resize(size);
+    z.resize(size);
+}
+
+void q::quaternion_batch::reserve(std::size_t capacity) {
+    w.reserve(capacity);
+    x.reserve(capacity);
+    y.reserve(capacity);
+    z.reserve(capacity);
+}
+
+void q::quaternion_batch::push_back(const quaternion& q) {
+    w.push_back(q.w);
+    x.push_back(q.x);
+    y.push_back(q.y);
+    z.push_back(q.z);
+}
+
+void q::quaternion_batch::set(std::size_t i, const quaternion& q) {
+    w[i] = q.w;
+    x[i] = q.x;
+    y[i] = q.y;
+    z[i] = q.z;
+}
+
+q::quaternion q::quaternion_batch::operator[](std::size_t i) const {
+    return quaternion{w[i], x[i], y[i], z[i]};
+}
+
+std::vector<q::quaternion> q::quaternion_batch::to_vector() const {
+    auto result = std::vector<quaternion>(size());
+    for (std::size_t i = 0; i < size(); ++i)
+        result[i] = (*this)[i];
+    return result;
+}
+
+q::quaternion_batch q::quaternion_batch::conjugated() const {
+    auto result = quaternion_batch{};
+    conjugate(*this, result);
+    return result;
+}
+
+q::quaternion_batch q::quaternion_batch::normalized() const {
+    auto result = quaternion_batch{};
+    normalize(*this, result);
+    return result;
+}
+
+std::optional<q::quaternion_batch> q::quaternion_batch::rotated(const quaternion_batch& r) const {
+    auto result = quaternion_batch{};
+    if (!rotate(*this, r, result))
+        return std::nullopt;
+    return result;
+}
+
+std::vector<q::matrix_3x3> q::quaternion_batch::to_matrix() const {
+    static_assert(sizeof(matrix_3x3) == 9 * sizeof(double));
+    auto result = std::vector<matrix_3x3>(size());
+    quaternions::to_matrix(*this, {reinterpret_cast<double*>(result.data()), 9 * size()});
+    return result;
+}
+
+q::quaternion_batch q::operator+(const quaternion_batch& a, const quaternion_batch& b) {
+    auto result = quaternion_batch{};
+    add(a, b, result);
+    return result;
+}
+
+q::quaternion_batch q::operator-(const quaternion_batch& a, const quaternion_batch& b) {
+    auto result = quaternion_batch{};
+    subtract(a, b, result);
+    return result;
+}
+
+q::quaternion_batch q::operator*(const quaternion_batch& a, const quaternion_batch& b) {
+    auto result = quaternion_batch{};
+    multiply(a, b, result);
+    return result;
+}
+
+q::quaternion_batch q::operator*(const quaternion_batch& q, const double s) {
+    auto result = quaternion_batch{};
+    scale(q, s, result);
+    return result;
+}
+
+q::quaternion_batch q::operator*(const double s, const quaternion_batch& q) {
+    return q * s;
+}
+
+void q::add(const quaternion_batch& a, const quaternion_batch& b, quaternion_batch& out) {
+    add(execution::seq, a, b, out);
+}
+
+void q::add(execution::sequenced_policy, const quaternion_batch& a, const quaternion_batch& b, quaternion_batch& out) {
+    check_sizes(a, b);
+    out.resize(a.size());
+    k::active().add(view(a), view(b), view(out), a.size());
+}
+
+void q::add(execution::parallel_policy policy, const quaternion_batch& a, const quaternion_batch& b,
+            quaternion_batch& out) {
+    check_sizes(a, b);
+    out.resize(a.size());
+    parallel_for(policy, a.size(), product_chunk, [&](std::size_t begin, std::size_t end) {
+        k::active().add(view(a, begin), view(b, begin), view(out, begin), end - begin);
+    });
+}
+
+void q::subtract(const quaternion_batch& a, const quaternion_batch& b, quaternion_batch& out) {
+    subtract(execution::seq, a, b, out);
+}
+
+void q::subtract(execution::sequenced_policy, const quaternion_batch& a, const quaternion_batch& b,
+                 quaternion_batch& out) {
+    check_sizes(a, b);
+    out.resize(a.size());
+    k::active().subtract(view(a), view(b), view(out), a.size());
+}
+
+void q::subtract(execution::parallel_policy policy, const quaternion_batch& a, const quaternion_batch& b,
+                 quaternion_batch& out) {
+    check_sizes(a, b);
+    out.resize(a.size());
+    parallel_for(policy, a.size(), product_chunk, [&](std::size_t begin, std::size_t end) {
+        k::active().subtract(view(a, begin), view(b, begin), view(out, begin), end - begin);
+    });
+}
+
+void q::multiply(const quaternion_batch& a, const quaternion_batch& b, quaternion_batch& out) {
+    multiply(execution::seq, a, b, out);
+}
+
+void q::multiply(execution::sequenced_policy, const quaternion_batch& a, const quaternion_batch& b,
+                 quaternion_batch& out) {
+    check_sizes(a, b);
+    out.resize(a.size());
+    k::active().multiply(view(a), view(b), view(out), a.size());
+}
+
+void q::multiply(execution::parallel_policy policy, const quaternion_batch& a, const quaternion_batch& b,
+                 quaternion_batch& out) {
+    check_sizes(a, b);
+    out.resize(a.size());
+    parallel_for(policy, a.size(), product_chunk, [&](std::size_t begin, std::size_t end) {
+        k::active().multiply(view(a, begin), view(b, begin), view(out, begin), end - begin);
+    });
+}
+
+void q::scale(const quaternion_batch& q, double s, quaternion_batch& out) {
+    out.resize(q.size());
+    k::active().scale(view(q), s, view(out), q.size());
+}
+
+void q::conjugate(const quaternion_batch& q, quaternion_batch& out) {
+    out.resize(q.size());
+    k::active().conjugate(view(q), view(out), q.size());
+}
+
+void q::normalize(const quaternion_batch& q, quaternion_batch& out) {
+    normalize(execution::seq, q, out);
+}
+
+void q::normalize(execution::sequenced_policy, const quaternion_batch& q, quaternion_batch& out) {
+    out.resize(q.size());
+    k::active().normalize(view(q), view(out), q.size());
+}
+
+void q::normalize(execution::parallel_policy policy, const quaternion_batch& q, quaternion_batch& out) {
+    out.resize(q.size());
+    parallel_for(policy, q.size(), product_chunk, [&](std::size_t begin, std::size_t end) {
+        k::active().normalize(view(q, begin), view(out, begin), end - begin);
+    });
+}
+
+bool q::rotate(const quaternion_batch& v, const quaternion_batch& r, quaternion_batch& out) {
+    return rotate(execution::seq, v, r, out);
+}
+
+bool q::rotate(execution::sequenced_policy, const quaternion_batch& v, const quaternion_batch& r,
+               quaternion_batch& out) {
+    check_sizes(v, r);
+    if (!normalized(r, 0, r.size()))
+        return false;
+    out.resize(v.size());
+    k::active().rotate(view(v), view(r), view(out), v.size());
+    return true;
+}
+
+bool q::rotate(execution::parallel_policy policy, const quaternion_batch& v, const quaternion_batch& r,
+               quaternion_batch& out) {
+    check_sizes(v, r);
+    out.resize(v.size());
+    auto all_normalized = std::atomic<bool>{true};
+    parallel_for(policy, v.size(), rotation_chunk, [&](std::size_t begin, std::size_t end) {
+        if (!normalized(r, begin, end)) {
+            all_normalized = false;
+            return;
+        }
+        k::active().rotate(view(v, begin), view(r, begin), view(out, begin), end - begin);
+    });
+    return all_normalized;
+}
+
+void q::to_matrix(const quaternion_batch& q, std::span<double> out, matrix_format format) {
+    to_matrix(execution::seq, q, out, format);
+}
+
+void q::to_matrix(const quaternion_batch& q, std::span<float> out, matrix_format format) {
+    to_matrix(execution::seq, q, out, format);
+}
+
+void q::to_matrix(execution::sequenced_policy, const quaternion_batch& q, std::span<double> out,
+                  matrix_format format) {
+    const auto layout = check_matrices(q.size(), out.size(), format);
+    k::active().to_matrix(view(q), layout, out.data(), q.size());
+}
+
+void q::to_matrix(execution::sequenced_policy, const quaternion_batch& q, std::span<float> out,
+                  matrix_format format) {
+    const auto layout = check_matrices(q.size(), out.size(), format);
+    k::active().to_matrix_float(view(q), layout, out.data(), q.size());
+}
+
+void q::to_matrix(execution::parallel_policy policy, const quaternion_batch& q, std::span<double> out,
+                  matrix_format format) {
+    const auto layout = check_matrices(q.size(), out.size(), format);
+    parallel_for(policy, q.size(), rotation_chunk, [&](std::size_t begin, std::size_t end) {
+        k::active().to_matrix(view(q, begin), layout, out.data() + begin * layout.stride, end - begin);
+    });
+}
+
+void q::to_matrix(execution::parallel_policy policy, const quaternion_batch& q, std::span<float> out,
+                  matrix_format format) {
+    const auto layout = check_matrices(q.size(), out.size(), format);
+    parallel_for(policy, q.size(), rotation_chunk, [&](std::size_t begin, std::size_t end) {
+        k::active().to_matrix_float(view(q, begin), layout, out.data() + begin * layout.stride, end - begin);
+    });
+}
+
+void q::from_matrix(std::span<const double> in, quaternion_batch& out, matrix_format format) {
+    from_matrix(execution::seq, in, out, format);
+}
+
+void q::from_matrix(std::span<const float> in, quaternion_batch& out, matrix_format format) {
+    from_matrix(execution::seq, in, out, format);
+}
+
+void q::from_matrix(execution::sequenced_policy, std::span<const double> in, quaternion_batch& out,
+                    matrix_format format) {
+    out.resize(matrix_count(in.size(), format));
+    k::active().from_matrix(in.data(), layout_of(format), view(out), out.size());
+}
+
+void q::from_matrix(execution::sequenced_policy, std::span<const float> in, quaternion_batch& out,
+                    matrix_format format) {
+    out.resize(matrix_count(in.size(), format));
+    k::active().from_matrix_float(in.data(), layout_of(format), view(out), out.size());
+}
+
+void q::from_matrix(execution::parallel_policy policy, std::span<const double> in, quaternion_batch& out,
+                    matrix_format format) {
+    out.resize(matrix_count(in.size(), format));
+    const auto layout = layout_of(format);
+    parallel_for(policy, out.size(), rotation_chunk, [&](std::size_t begin, std::size_t end) {
+        k::active().from_matrix(in.data() + begin * layout.stride, layout, view(out, begin), end - begin);
+    });
+}
+
+void q::from_matrix(execution::parallel_policy policy, std::span<const float> in, quaternion_batch& out,
+                    matrix_format format) {
+    out.resize(matrix_count(in.size(), format));
+    const auto layout = layout_of(format);
+    parallel_for(policy, out.size(), rotation_chunk, [&](std::size_t begin, std::size_t end) {
+        k::active().from_matrix_float(in.data() + begin * layout.stride, layout, view(out, begin), end - begin);
+    });
+}
@@ -0,0 +1,141 @@
+#ifndef QUATERNIONS_QUATERNION_BATCH_H
+#define QUATERNIONS_QUATERNION_BATCH_H
+
+#include <cstddef>
+#include <optional>
+#include <span>
+#include <vector>
+#include "aligned_allocator.h"
+#include "execution.h"
+#include "quaternion.h"
+
+namespace quaternions {
+    /**
+     * Many quaternions stored as structure of arrays: one aligned array per component,
+     * so that batch operations can load a full vector register of w, x, y or z at once.
+     */
+    class quaternion_batch {
+    public:
+        using storage = std::vector<double, aligned_allocator<double>>;
+
+        storage w;
+        storage x;
+        storage y;
+        storage z;
+
+        quaternion_batch() = default;
+        explicit quaternion_batch(std::size_t size);
+        quaternion_batch static from(std::span<const quaternion> quaternions);
+        quaternion_batch static from_matrix(std::span<const matrix_3x3> matrices);
+
+        std::size_t size() const;
+        bool empty() const;
+        void resize(std::size_t size);
+        void reserve(std::size_t capacity);
+        void push_back(const quaternion& q);
+        void set(std::size_t i, const quaternion& q);
+        quaternion operator[](std::size_t i) const;
+        std::vector<quaternion> to_vector() const;
+
+        quaternion_batch conjugated() const;
+        quaternion_batch normalized() const;
+        /**
+         * Rotates every quaternion by the rotation with the same index, fails if any rotation
+         * is not normalized
+         */
+        std::optional<quaternion_batch> rotated(const quaternion_batch& r) const;
+        std::vector<matrix_3x3> to_matrix() const;
+    };
+
+    quaternion_batch operator+(const quaternion_batch& a, const quaternion_batch& b);
+    quaternion_batch operator-(const quaternion_batch& a, const quaternion_batch& b);
+    quaternion_batch operator*(const quaternion_batch& a, const quaternion_batch& b);
+    quaternion_batch operator*(const quaternion_batch& q, const double s);
+    quaternion_batch operator*(const double s, const quaternion_batch& q);
+
+    enum class matrix_order {
+        column_major,
+        row_major,
+    };
+
+    /**
+     * Either the 3x3 rotation matrix or the 3x4 transformation [R | t], whose translation t is
+     * written as zero and ignored when read
+     */
+    enum class matrix_shape {
+        rotation_3x3,
+        transform_3x4,
+    };
+
+    struct matrix_format {
+        matrix_order order = matrix_order::column_major;
+        matrix_shape shape = matrix_shape::rotation_3x3;
+    };
+
+    /**
+     * Writes the rotation matrices of unit quaternions back to back into a contiguous buffer,
+     * e.g. for uploading them to a GPU. The buffer must hold exactly one matrix per quaternion.
+     */
+    void to_matrix(const quaternion_batch& q, std::span<double> out, matrix_format format = {});
+    void to_matrix(const quaternion_batch& q, std::span<float> out, matrix_format format = {});
+    void to_matrix(execution::sequenced_policy, const quaternion_batch& q, std::span<double> out,
+                   matrix_format format = {});
+    void to_matrix(execution::sequenced_policy, const quaternion_batch& q, std::span<float> out,
+                   matrix_format format = {});
+    void to_matrix(execution::parallel_policy, const quaternion_batch& q, std::span<double> out,
+                   matrix_format format = {});
+    void to_matrix(execution::parallel_policy, const quaternion_batch& q, std::span<float> out,
+                   matrix_format format = {});
+
+    /**
+     * Reads back to back rotation matrices from a contiguous buffer, out is resized to one
+     * quaternion per matrix. Signs are chosen like quaternion::from_matrix does.
+     */
+    void from_matrix(std::span<const double> in, quaternion_batch& out, matrix_format format = {});
+    void from_matrix(std::span<const float> in, quaternion_batch& out, matrix_format format = {});
+    void from_matrix(execution::sequenced_policy, std::span<const double> in, quaternion_batch& out,
+                     matrix_format format = {});
+    void from_matrix(execution::sequenced_policy, std::span<const float> in, quaternion_batch& out,
+                     matrix_format format = {});
+    void from_matrix(execution::parallel_policy, std::span<const double> in, quaternion_batch& out,
+                     matrix_format format = {});
+    void from_matrix(execution::parallel_policy, std::span<const float> in, quaternion_batch& out,
+                     matrix_format format = {});
+
+    /**
+     * Allocation-free variants writing into a caller-provided batch, which is resized to fit.
+     * The output may be one of the inputs. With execution::par the batches are split into chunks
+     * on the executor of the policy, each running the same kernels; batches too short to pay for
+     * that stay on the calling thread.
+     */
+    void add(const quaternion_batch& a, const quaternion_batch& b, quaternion_batch& out);
+    void add(execution::sequenced_policy, const quaternion_batch& a, const quaternion_batch& b, quaternion_batch& out);
+    void add(execution::parallel_policy, const quaternion_batch& a, const quaternion_batch& b, quaternion_batch& out);
+    void subtract(const quaternion_batch& a, const quaternion_batch& b, quaternion_batch& out);
+    void subtract(execution::sequenced_policy, const quaternion_batch& a, const quaternion_batch& b,
+                  quaternion_batch& out);
+    void subtract(execution::parallel_policy, const quaternion_batch& a, const quaternion_batch& b,
+                  quaternion_batch& out);
+    void multiply(const quaternion_batch& a, const quaternion_batch& b, quaternion_batch& out);
+    void multiply(execution::sequenced_policy, const quaternion_batch& a, const quaternion_batch& b,
+                  quaternion_batch& out);
+    void multiply(execution::parallel_policy, const quaternion_batch& a, const quaternion_batch& b,
+                  quaternion_batch& out);
+    void scale(const quaternion_batch& q, double s, quaternion_batch& out);
+    void conjugate(const quaternion_batch& q, quaternion_batch& out);
+    void normalize(const quaternion_batch& q, quaternion_batch& out);
+    void normalize(execution::sequenced_policy, const quaternion_batch& q, quaternion_batch& out);
+    void normalize(execution::parallel_policy, const quaternion_batch& q, quaternion_batch& out);
+
+    /**
+     * Rotates every quaternion of v by the rotation of r with the same index, false if any
+     * rotation is not normalized, in which case out is left incomplete
+     */
+    bool rotate(const quaternion_batch& v, const quaternion_batch& r, quaternion_batch& out);
+    bool rotate(execution::sequenced_policy, const quaternion_batch& v, const quaternion_batch& r,
+                quaternion_batch& out);
+    bool rotate(execution::parallel_policy, const quaternion_batch& v, const quaternion_batch& r,
+                quaternion_batch& out);
+}
+
+#endif //QUATERNIONS_QUATERNION_BATCH_H
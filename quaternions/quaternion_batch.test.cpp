@@ -0,0 +1,190 @@
+#include <catch2/catch_test_macros.hpp>
+#include <catch2/generators/catch_generators.hpp>
+#include <catch2/matchers/catch_matchers_floating_point.hpp>
+#include "execution.h"
+#include "quaternion_batch.h"
+#include "thread_pool.h"
+#include <algorithm>
+#include <cmath>
+#include <cstdint>
+#include <stdexcept>
+#include <vector>
+#include "../test/helpers.h"
+
+namespace q = quaternions;
+using Catch::Matchers::WithinAbs;
+
+namespace {
+    /**
+     * Largest component difference between two batches of the same size
+     */
+    double max_difference(const q::quaternion_batch& a, const q::quaternion_batch& b) {
+        auto difference = 0.0;
+        for (std::size_t i = 0; i < a.size(); ++i)
+            difference = std::max(difference, (a[i] - b[i]).length());
+        return difference;
+    }
+}
+
+TEST_CASE("batch round trip from and to single quaternions")
+{
+    const auto qs = random_quaternions(13, 1);
+    const auto batch = q::quaternion_batch::from(qs);
+    CHECK(batch.size() == 13);
+    CHECK(batch.to_vector() == qs);
+    CHECK(reinterpret_cast<std::uintptr_t>(batch.w.data()) % 64 == 0);
+}
+
+TEST_CASE("batch operations match single quaternion operations")
+{
+    // sizes chosen to hit empty batches, pure tails and full vector registers
+    const auto n = GENERATE(std::size_t{0}, 1, 3, 8, 17, 1023);
+    const auto as = random_quaternions(n, 2);
+    const auto bs = random_quaternions(n, 3);
+    const auto a = q::quaternion_batch::from(as);
+    const auto b = q::quaternion_batch::from(bs);
+
+    const auto product = a * b;
+    const auto sum = a + b;
+    const auto difference = a - b;
+    const auto scaled = 2.5 * a;
+    const auto conjugated = a.conjugated();
+    const auto normalized = a.normalized();
+    REQUIRE(product.size() == n);
+    for (std::size_t i = 0; i < n; ++i) {
+        CHECK_THAT(product[i], WithinAbs(as[i] * bs[i]));
+        CHECK_THAT(sum[i], WithinAbs(as[i] + bs[i]));
+        CHECK_THAT(difference[i], WithinAbs(as[i] - bs[i]));
+        CHECK_THAT(scaled[i], WithinAbs(as[i] * 2.5));
+        CHECK(conjugated[i] == as[i].conjugated());
+        CHECK_THAT(normalized[i], WithinAbs(as[i].normalized()));
+    }
+}
+
+TEST_CASE("batch product may write into one of its operands")
+{
+    const auto as = random_quaternions(9, 4);
+    const auto bs = random_quaternions(9, 5);
+    auto a = q::quaternion_batch::from(as);
+    q::multiply(a, q::quaternion_batch::from(bs), a);
+    for (std::size_t i = 0; i < as.size(); ++i)
+        CHECK_THAT(a[i], WithinAbs(as[i] * bs[i]));
+}
+
+TEST_CASE("batch operations give the same results with every policy")
+{
+    // large enough to be split into chunks, with a length that is no multiple of any register;
+    // chunks may end in scalar tails, which round differently than full registers
+    const auto n = std::size_t{50'001};
+    const auto a = q::quaternion_batch::from(random_quaternions(n, 1));
+    const auto r = q::quaternion_batch::from(random_unit_quaternions(n, 2));
+    auto pool = q::thread_pool(4);
+    const auto policy = q::execution::par.on(pool);
+
+    auto seq = q::quaternion_batch{}, par = q::quaternion_batch{};
+    q::add(q::execution::seq, a, r, seq);
+    q::add(policy, a, r, par);
+    CHECK(max_difference(par, seq) < 1E-14);
+    q::subtract(q::execution::seq, a, r, seq);
+    q::subtract(policy, a, r, par);
+    CHECK(max_difference(par, seq) < 1E-14);
+    q::multiply(q::execution::seq, a, r, seq);
+    q::multiply(q::execution::par, a, r, par);
+    CHECK(max_difference(par, seq) < 1E-14);
+    q::normalize(q::execution::seq, a, seq);
+    q::normalize(policy, a, par);
+    CHECK(max_difference(par, seq) < 1E-14);
+    CHECK(q::rotate(q::execution::seq, a, r, seq));
+    CHECK(q::rotate(policy, a, r, par));
+    CHECK(max_difference(par, seq) < 1E-14);
+
+    const auto format = q::matrix_format{q::matrix_order::row_major, q::matrix_shape::transform_3x4};
+    auto seq_matrices = std::vector<float>(12 * n), par_matrices = seq_matrices;
+    q::to_matrix(q::execution::seq, r, std::span(seq_matrices), format);
+    q::to_matrix(policy, r, std::span(par_matrices), format);
+    auto matrix_difference = 0.0f;
+    for (std::size_t i = 0; i < par_matrices.size(); ++i)
+        matrix_difference = std::max(matrix_difference, std::abs(par_matrices[i] - seq_matrices[i]));
+    CHECK(matrix_difference < 1E-6f);
+    q::from_matrix(q::execution::seq, std::span<const float>(seq_matrices), seq, format);
+    q::from_matrix(policy, std::span<const float>(par_matrices), par, format);
+    CHECK(max_difference(par, seq) < 1E-14);
+
+    // in place, and rotations which are not normalized in a late chunk
+    auto v = a;
+    q::multiply(policy, v, r, v);
+    CHECK(v[40'000] == a[40'000] * r[40'000]);
+    auto scaled = r;
+    scaled.set(45'000, r[45'000] * 2.0);
+    CHECK(!q::rotate(policy, a, scaled, par));
+    CHECK(!a.rotated(scaled));
+    CHECK_THROWS_AS(q::add(policy, a, q::quaternion_batch(n - 1), par), std::domain_error);
+}
+
+TEST_CASE("batch matrices in every buffer format")
+{
+    const auto order = GENERATE(q::matrix_order::column_major, q::matrix_order::row_major);
+    const auto shape = GENERATE(q::matrix_shape::rotation_3x3, q::matrix_shape::transform_3x4);
+    const auto format = q::matrix_format{order, shape};
+    const auto columns = std::size_t{shape == q::matrix_shape::transform_3x4 ? 4u : 3u};
+    const auto at = [&](std::size_t row, std::size_t column) {
+        return order == q::matrix_order::column_major ? column * 3 + row : row * columns + column;
+    };
+
+    const auto rs = random_unit_quaternions(11, 6);
+    const auto r = q::quaternion_batch::from(rs);
+    auto doubles = std::vector<double>(3 * columns * rs.size(), -1);
+    auto floats = std::vector<float>(3 * columns * rs.size(), -1);
+    q::to_matrix(r, doubles, format);
+    q::to_matrix(r, floats, format);
+    for (std::size_t i = 0; i < rs.size(); ++i) {
+        const auto expected = rs[i].to_matrix();
+        for (std::size_t row = 0; row < 3; ++row) {
+            for (std::size_t column = 0; column < columns; ++column) {
+                const auto value = column < 3 ? expected[column][row] : 0.0;
+                CHECK_THAT(doubles[i * 3 * columns + at(row, column)], WithinAbs(value, 1E-12));
+                CHECK_THAT(floats[i * 3 * columns + at(row, column)], WithinAbs(value, 1E-6));
+            }
+        }
+    }
+
+    auto from_doubles = q::quaternion_batch{};
+    auto from_floats = q::quaternion_batch{};
+    q::from_matrix(std::span<const double>(doubles), from_doubles, format);
+    q::from_matrix(std::span<const float>(floats), from_floats, format);
+    REQUIRE(from_doubles.size() == rs.size());
+    REQUIRE(from_floats.size() == rs.size());
+    for (std::size_t i = 0; i < rs.size(); ++i) {
+        const auto expected = q::quaternion::from_matrix(rs[i].to_matrix());
+        CHECK_THAT(from_doubles[i], WithinAbs(expected));
+        CHECK_THAT(from_floats[i], WithinAbs(expected, 1E-6));
+    }
+}
+
+TEST_CASE("batch matrices from and to matrix_3x3")
+{
+    const auto rs = random_unit_quaternions(9, 7);
+    const auto matrices = q::quaternion_batch::from(rs).to_matrix();
+    const auto back = q::quaternion_batch::from_matrix(matrices);
+    for (std::size_t i = 0; i < rs.size(); ++i)
+        CHECK_THAT(back[i], WithinAbs(q::quaternion::from_matrix(matrices[i])));
+}
+
+TEST_CASE("matrix buffers not fitting the batch should fail")
+{
+    const auto r = q::quaternion_batch(2);
+    auto out = std::vector<double>(17);
+    auto batch = q::quaternion_batch{};
+    CHECK_THROWS(q::to_matrix(r, out));
+    CHECK_THROWS(q::to_matrix(r, out, {q::matrix_order::row_major, q::matrix_shape::transform_3x4}));
+    CHECK_THROWS(q::from_matrix(std::span<const double>(out), batch));
+}
+
+TEST_CASE("combining batches of different sizes should fail")
+{
+    const auto a = q::quaternion_batch(3);
+    const auto b = q::quaternion_batch(4);
+    CHECK_THROWS(a * b);
+    CHECK_THROWS(a + b);
+    CHECK_THROWS(a - b);
+}
@@ -0,0 +1,37 @@
+#include <catch2/catch_test_macros.hpp>
+#include <catch2/benchmark/catch_benchmark.hpp>
+#include "rotation_sequence.h"
+#include <algorithm>
+#include <vector>
+#include "../test/benchmarks.h"
+
+namespace q = quaternions;
+
+TEST_CASE("fixed step rotation sequences")
+{
+    const auto axis = q::xyz{0.6, 0, 0.8};
+    for (const auto n : benchmark_batch_sizes) {
+        auto out = std::vector<q::quaternion>(n);
+        BENCHMARK("from_rotation per step x" + batch_label(n)) {
+            for (std::size_t k = 0; k < n; ++k)
+                out[k] = q::quaternion::from_rotation({axis, static_cast<double>(k) * 1E-3});
+            return out[0];
+        };
+        BENCHMARK("rotation_sequence next x" + batch_label(n)) {
+            auto sequence = q::rotation_sequence({axis, 0}, 1E-3);
+            for (auto& q : out)
+                q = sequence.next();
+            return out[0];
+        };
+        BENCHMARK("rotation_sequence fill x" + batch_label(n)) {
+            auto sequence = q::rotation_sequence({axis, 0}, 1E-3);
+            sequence.fill(out);
+            return out[0];
+        };
+        // writing a constant, the bound set by memory bandwidth
+        BENCHMARK("std::fill x" + batch_label(n)) {
+            std::fill(out.begin(), out.end(), q::quaternion{1, 0, 0, 0});
+            return out[0];
+        };
+    }
+}
@@ -0,0 +1,116 @@
+#include "rotation_sequence.h"
+#include <algorithm>
+#include <cmath>
+#include <stdexcept>
+
+namespace q = quaternions;
+
+namespace {
+    // independent chains fill() advances together, as many as fit the widest vector registers
+    constexpr std::size_t lanes = 8;
+}
+
+q::rotation_sequence::iterator::iterator(rotation_sequence& sequence) : sequence(&sequence) {}
+
+q::quaternion q::rotation_sequence::iterator::operator*() const {
+    return sequence->current();
+}
+
+q::rotation_sequence::iterator& q::rotation_sequence::iterator::operator++() {
+    sequence->next();
+    return *this;
+}
+
+void q::rotation_sequence::iterator::operator++(int) {
+    sequence->next();
+}
+
+bool q::rotation_sequence::iterator::operator==(std::unreachable_sentinel_t) const {
+    return false;
+}
+
+q::rotation_sequence::rotation_sequence(const rotation& first, double step_angle, std::size_t resync_every)
+    : first_angle(first.angle),
+      step_angle(step_angle),
+      resync_every(resync_every),
+      step_cos(std::cos(step_angle / 2)),
+      step_sin(std::sin(step_angle / 2)) {
+    const auto length = first.axis.length();
+    if (!(length > 0))
+        throw std::domain_error("a rotation sequence needs an axis!");
+    axis = first.axis.normalized();
+    sync(0, c, s);
+}
+
+void q::rotation_sequence::sync(std::uint64_t position, double& cos, double& sin) const {
+    const auto half_angle = (first_angle + static_cast<double>(position) * step_angle) / 2;
+    cos = std::cos(half_angle);
+    sin = std::sin(half_angle);
+}
+
+std::uint64_t q::rotation_sequence::position() const {
+    return k;
+}
+
+q::quaternion q::rotation_sequence::current() const {
+    return quaternion{c, s * axis.x, s * axis.y, s * axis.z};
+}
+
+q::quaternion q::rotation_sequence::next() {
+    const auto result = current();
+    ++k;
+    if (resync_every != 0 && ++since_sync == resync_every) {
+        sync(k, c, s);
+        since_sync = 0;
+    } else {
+        const auto previous_c = c;
+        c = c * step_cos - s * step_sin;
+        s = s * step_cos + previous_c * step_sin;
+    }
+    return result;
+}
+
+void q::rotation_sequence::fill(std::span<quaternion> out) {
+    const auto n = out.size();
+    if (n < 4 * lanes) {
+        for (auto& q : out)
+            q = next();
+        return;
+    }
+
+    // chain j holds position k + j + i for the block at i and advances by lanes positions at once
+    double lane_c[lanes];
+    double lane_s[lanes];
+    const auto stride_angle = static_cast<double>(lanes) * step_angle / 2;
+    const auto stride_cos = std::cos(stride_angle);
+    const auto stride_sin = std::sin(stride_angle);
+    // resyncs happen at whole blocks, at least every resync_every rotations
+    const auto sync_blocks = resync_every == 0 ? 0 : std::max<std::size_t>(1, resync_every / lanes);
+    std::size_t i = 0;
+    for (std::size_t block = 0; i + lanes <= n; i += lanes, ++block) {
+        if (block == 0 || (sync_blocks != 0 && block % sync_blocks == 0))
+            for (std::size_t j = 0; j < lanes; ++j)
+                sync(k + i + j, lane_c[j], lane_s[j]);
+        for (std::size_t j = 0; j < lanes; ++j)
+            out[i + j] = quaternion{lane_c[j], lane_s[j] * axis.x, lane_s[j] * axis.y, lane_s[j] * axis.z};
+        for (std::size_t j = 0; j < lanes; ++j) {
+            const auto previous_c = lane_c[j];
+            lane_c[j] = lane_c[j] * stride_cos - lane_s[j] * stride_sin;
+            lane_s[j] = lane_s[j] * stride_cos + previous_c * stride_sin;
+        }
+    }
+
+    k += i;
+    since_sync = 0;
+    sync(k, c, s);
+    for (; i < n; ++i)
+        out[i] = next();
+}
+
+q::rotation_sequence::iterator q::rotation_sequence::begin() {
+    return iterator{*this};
+}
+
+std::unreachable_sentinel_t q::rotation_sequence::end() const {
+    return std::unreachable_sentinel;
+}
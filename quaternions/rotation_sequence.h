@@ -0,0 +1,86 @@
+#ifndef QUATERNIONS_ROTATION_SEQUENCE_H
+#define QUATERNIONS_ROTATION_SEQUENCE_H
+
+#include <cstddef>
+#include <cstdint>
+#include <iterator>
+#include <span>
+#include "quaternion.h"
+
+namespace quaternions {
+    /**
+     * The rotations from_rotation({axis, first_angle + k step_angle}) for k = 0, 1, 2, ..., e.g. of a
+     * turntable or a sweep, produced without trigonometry per rotation: all of them share the axis,
+     * so each follows from the previous one by multiplying cos and sin of the half angle with those
+     * of the half step.
+     *
+     * Rounding makes repeated multiplication drift in both length and angle, so every
+     * resync_every-th rotation is computed exactly instead, which keeps the components within
+     * about 1E-16 resync_every of the exact ones. resync_every = 0 never resyncs.
+     *
+     * Usable as a generator through next(), as an endless input range, e.g. with
+     * std::views::take, or in batches through fill().
+     */
+    class rotation_sequence {
+    public:
+        class iterator {
+        public:
+            using value_type = quaternion;
+            using difference_type = std::ptrdiff_t;
+
+            iterator() = default;
+            explicit iterator(rotation_sequence& sequence);
+
+            quaternion operator*() const;
+            iterator& operator++();
+            void operator++(int);
+            bool operator==(std::unreachable_sentinel_t) const;
+
+        private:
+            rotation_sequence* sequence = nullptr;
+        };
+
+        /**
+         * The axis is normalized. Throws std::domain_error for a zero axis.
+         */
+        rotation_sequence(const rotation& first, double step_angle, std::size_t resync_every = 1024);
+
+        /**
+         * Index k of the rotation next() returns
+         */
+        std::uint64_t position() const;
+        /**
+         * Rotation at position(), without advancing
+         */
+        quaternion current() const;
+        quaternion next();
+        /**
+         * Writes the next out.size() rotations, several chains at a time so that the multiplications
+         * overlap, and advances past them
+         */
+        void fill(std::span<quaternion> out);
+
+        iterator begin();
+        std::unreachable_sentinel_t end() const;
+
+    private:
+        /**
+         * cos and sin of the half angle at position k, computed exactly
+         */
+        void sync(std::uint64_t k, double& c, double& s) const;
+
+        xyz axis;
+        double first_angle;
+        double step_angle;
+        std::size_t resync_every;
+        // cos and sin of half the step
+        double step_cos;
+        double step_sin;
+        std::uint64_t k = 0;
+        std::uint64_t since_sync = 0;
+        double c;
+        double s;
+    };
+}
+
+#endif //QUATERNIONS_ROTATION_SEQUENCE_H
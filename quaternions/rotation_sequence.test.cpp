@@ -0,0 +1,80 @@
+#include <catch2/catch_test_macros.hpp>
+#include <catch2/matchers/catch_matchers_floating_point.hpp>
+#include "rotation_sequence.h"
+#include <iterator>
+#include <ranges>
+#include <stdexcept>
+#include <vector>
+#include "../test/helpers.h"
+
+namespace q = quaternions;
+using Catch::Matchers::WithinAbs;
+
+namespace {
+    q::quaternion exact(const q::xyz& axis, double first_angle, double step_angle, std::size_t k) {
+        return q::quaternion::from_rotation({axis, first_angle + static_cast<double>(k) * step_angle});
+    }
+}
+
+static_assert(std::input_iterator<q::rotation_sequence::iterator>);
+static_assert(std::ranges::input_range<q::rotation_sequence>);
+
+TEST_CASE("rotation sequences step around their axis")
+{
+    const auto axis = q::xyz{1, 2, 2}.normalized();
+    auto sequence = q::rotation_sequence({q::xyz{2, 4, 4}, 0.3}, 0.01);
+    CHECK(sequence.position() == 0);
+    for (std::size_t k = 0; k < 5000; ++k) {
+        CHECK_THAT(sequence.current(), WithinAbs(exact(axis, 0.3, 0.01, k), 1E-12));
+        CHECK_THAT(sequence.next(), WithinAbs(exact(axis, 0.3, 0.01, k), 1E-12));
+    }
+    CHECK(sequence.position() == 5000);
+}
+
+TEST_CASE("resyncing bounds the drift of long sequences")
+{
+    const auto axis = q::xyz{0, 0, 1};
+    auto synced = q::rotation_sequence({axis, 0}, 1E-3, 64);
+    auto unsynced = q::rotation_sequence({axis, 0}, 1E-3, 0);
+    auto synced_error = 0.0;
+    auto unsynced_error = 0.0;
+    for (std::size_t k = 0; k < 1'000'000; ++k) {
+        const auto expected = exact(axis, 0, 1E-3, k);
+        synced_error = std::max(synced_error, (synced.next() - expected).length());
+        unsynced_error = std::max(unsynced_error, (unsynced.next() - expected).length());
+    }
+    CHECK(synced_error < 1E-12);
+    CHECK(unsynced_error > synced_error);
+}
+
+TEST_CASE("filled batches continue the sequence")
+{
+    const auto axis = q::xyz{0, 1, 0};
+    for (const std::size_t resync_every : {0, 5, 1024}) {
+        auto sequence = q::rotation_sequence({axis, -1}, 0.02, resync_every);
+        auto out = std::vector<q::quaternion>(3000);
+        sequence.fill(std::span(out).first(7));
+        sequence.fill(std::span(out).subspan(7, 2000));
+        for (auto& q : std::span(out).subspan(2007, 10))
+            q = sequence.next();
+        sequence.fill(std::span(out).subspan(2017));
+        for (std::size_t k = 0; k < out.size(); ++k)
+            CHECK_THAT(out[k], WithinAbs(exact(axis, -1, 0.02, k), 1E-12));
+        CHECK(sequence.position() == out.size());
+        CHECK_THAT(sequence.current(), WithinAbs(exact(axis, -1, 0.02, out.size()), 1E-12));
+    }
+}
+
+TEST_CASE("rotation sequences are ranges")
+{
+    const auto axis = q::xyz{1, 0, 0};
+    auto sequence = q::rotation_sequence({axis, 0}, M_PI / 2);
+    auto taken = std::vector<q::quaternion>{};
+    for (const auto& q : sequence | std::views::take(5))
+        taken.push_back(q);
+    REQUIRE(taken.size() == 5);
+    CHECK_THAT(taken[2], WithinAbs(q::quaternion{0, 1, 0, 0}, 1E-15));
+    CHECK_THAT(taken[4], WithinAbs(q::quaternion{-1, 0, 0, 0}, 1E-15));
+
+    CHECK_THROWS_AS(q::rotation_sequence({q::xyz{0, 0, 0}, 0}, 0.1), std::domain_error);
+}
@@ -0,0 +1,32 @@
+#include <catch2/catch_test_macros.hpp>
+#include <catch2/benchmark/catch_benchmark.hpp>
+#include "rotator.h"
+#include "quaternion.h"
+#include <vector>
+#include "../test/benchmarks.h"
+#include "../test/helpers.h"
+
+namespace q = quaternions;
+
+TEST_CASE("rotating many vectors")
+{
+    const auto r = q::quaternion{1, -2, 3, 0.5}.normalized();
+    const auto rotator = q::rotator::from_quaternion(r).value();
+    for (const auto n : benchmark_batch_sizes) {
+        const auto in = random_vectors(n, 1);
+        auto out = std::vector<q::xyz>(n);
+        BENCHMARK("quaternion sandwich x" + batch_label(n)) {
+            for (std::size_t i = 0; i < n; ++i)
+                out[i] = (r * q::quaternion::from_vector(in[i]) * r.conjugated()).vector();
+            return out[0];
+        };
+        BENCHMARK("rotator x" + batch_label(n)) {
+            rotator.apply(in, out);
+            return out[0];
+        };
+        BENCHMARK("rotator parallel x" + batch_label(n)) {
+            rotator.apply(q::execution::par, in, out);
+            return out[0];
+        };
+    }
+}
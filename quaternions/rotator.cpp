@@ -0,0 +1,56 @@
+#include "rotator.h"
+#include "dispatch.h"
+#include "parallel.h"
+#include <stdexcept>
+
+namespace q = quaternions;
+
+namespace {
+    constexpr std::size_t min_chunk = 16384;
+
+    void check_sizes(std::span<const q::xyz> in, std::span<q::xyz> out) {
+        if (in.size() != out.size())
+            throw std::domain_error("rotating vectors needs one output per input!");
+    }
+
+    void transform(const q::matrix_3x3& m, std::span<const q::xyz> in, std::span<q::xyz> out) {
+        static_assert(sizeof(q::xyz) == 3 * sizeof(double));
+        static_assert(sizeof(q::matrix_3x3) == 9 * sizeof(double));
+        q::kernels::active().transform_points(reinterpret_cast<const double*>(&m),
+                                              reinterpret_cast<const double*>(in.data()),
+                                              reinterpret_cast<double*>(out.data()),
+                                              in.size());
+    }
+}
+
+q::rotator::rotator(const matrix_3x3& m) : m(m) {}
+
+std::optional<q::rotator> q::rotator::from_quaternion(const quaternion& r) {
+    if(!almost_equal(r.length(), 1.0))
+        return std::nullopt;
+    return rotator{r.to_matrix()};
+}
+
+const q::matrix_3x3& q::rotator::matrix() const {
+    return m;
+}
+
+q::xyz q::rotator::apply(const xyz& v) const {
+    return v.x * m.c1 + v.y * m.c2 + v.z * m.c3;
+}
+
+void q::rotator::apply(std::span<const xyz> in, std::span<xyz> out) const {
+    apply(execution::seq, in, out);
+}
+
+void q::rotator::apply(execution::sequenced_policy, std::span<const xyz> in, std::span<xyz> out) const {
+    check_sizes(in, out);
+    transform(m, in, out);
+}
+
+void q::rotator::apply(execution::parallel_policy policy, std::span<const xyz> in, std::span<xyz> out) const {
+    check_sizes(in, out);
+    parallel_for(policy, in.size(), min_chunk, [&](std::size_t begin, std::size_t end) {
+        transform(m, in.subspan(begin, end - begin), out.subspan(begin, end - begin));
+    });
+}
@@ -0,0 +1,51 @@
+#include <catch2/catch_test_macros.hpp>
+#include "rotator.h"
+#include "quaternion.h"
+#include "xyz.h"
+#include <cmath>
+#include <vector>
+#include "../test/helpers.h"
+
+namespace q = quaternions;
+
+TEST_CASE("rotator rotates like the quaternion it is made of")
+{
+    const auto r = q::quaternion::from_rotation({{0, 0, 1}, M_PI_2});
+    const auto rotator = q::rotator::from_quaternion(r);
+    REQUIRE(rotator.has_value());
+    CHECK_THAT(rotator->apply({1, 0, 0}), WithinAbs(q::xyz{0, 1, 0}));
+    for (const auto& v : random_vectors(100, 1))
+        CHECK_THAT(rotator->apply(v), WithinAbs(q::quaternion::from_vector(v).rotated(r)->vector()));
+}
+
+TEST_CASE("not normalized rotator quaternion is not allowed")
+{
+    CHECK(q::rotator::from_quaternion({1, 1, 0, 0}) == std::nullopt);
+}
+
+TEST_CASE("rotating many vectors matches rotating them one by one")
+{
+    const auto rotator = q::rotator::from_quaternion(q::quaternion{1, -2, 3, 0.5}.normalized()).value();
+    const auto in = random_vectors(100'003, 2);
+    auto sequential = std::vector<q::xyz>(in.size());
+    auto parallel = std::vector<q::xyz>(in.size());
+    rotator.apply(in, sequential);
+    rotator.apply(q::execution::par, in, parallel);
+    for (std::size_t i = 0; i < in.size(); i += 101) {
+        CHECK_THAT(sequential[i], WithinAbs(rotator.apply(in[i])));
+        CHECK_THAT(parallel[i], WithinAbs(rotator.apply(in[i])));
+    }
+
+    auto in_place = in;
+    rotator.apply(q::execution::par, in_place, in_place);
+    for (std::size_t i = 0; i < in.size(); i += 101)
+        CHECK_THAT(in_place[i], WithinAbs(sequential[i]));
+}
+
+TEST_CASE("rotating vectors into an output of different size should fail")
+{
+    const auto rotator = q::rotator::from_quaternion({1, 0, 0, 0}).value();
+    const auto in = std::vector<q::xyz>(3);
+    auto out = std::vector<q::xyz>(2);
+    CHECK_THROWS(rotator.apply(in, out));
+}
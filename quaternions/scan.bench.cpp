@@ -0,0 +1,29 @@
+#include <catch2/catch_test_macros.hpp>
+#include <catch2/benchmark/catch_benchmark.hpp>
+#include "scan.h"
+#include <vector>
+#include "../test/benchmarks.h"
+#include "../test/helpers.h"
+
+namespace q = quaternions;
+
+TEST_CASE("rotation chains")
+{
+    for (const auto n : benchmark_batch_sizes) {
+        const auto in = random_unit_quaternions(n, 1);
+        auto out = std::vector<q::quaternion>(n);
+        BENCHMARK("serial running product x" + batch_label(n)) {
+            auto running = q::quaternion{1, 0, 0, 0};
+            for (std::size_t i = 0; i < n; ++i)
+                out[i] = running = running * in[i];
+            return out.back();
+        };
+        BENCHMARK("inclusive_scan x" + batch_label(n)) {
+            q::inclusive_scan(in, out, 256);
+            return out.back();
+        };
+        BENCHMARK("reduce x" + batch_label(n)) {
+            return q::reduce(in, 256);
+        };
+    }
+}
@@ -0,0 +1,115 @@
+#include "scan.h"
+#include "parallel.h"
+#include <algorithm>
+#include <stdexcept>
+#include <vector>
+
+namespace q = quaternions;
+
+namespace {
+    constexpr std::size_t min_chunk = 16384;
+    constexpr auto identity = q::quaternion{1, 0, 0, 0};
+
+    /**
+     * Blocks of the scan; more blocks than the executor runs at once so that uneven threads
+     * balance out
+     */
+    std::size_t block_count(q::execution::parallel_policy policy, std::size_t n) {
+        return std::clamp<std::size_t>(n / min_chunk, 1, 4 * q::executor_of(policy).concurrency());
+    }
+
+    struct renormalizer {
+        std::size_t every;
+        std::size_t count = 0;
+
+        q::quaternion operator()(const q::quaternion& running) {
+            if (every == 0 || ++count < every)
+                return running;
+            count = 0;
+            return running.normalized();
+        }
+    };
+
+    /**
+     * Products of each block of in
+     */
+    std::vector<q::quaternion> block_products(q::execution::parallel_policy policy, std::span<const q::quaternion> in,
+                                              std::size_t blocks, std::size_t renormalize_every) {
+        auto products = std::vector<q::quaternion>(blocks, identity);
+        const auto n = in.size();
+        q::parallel_for(policy, blocks, 1, [&](std::size_t first, std::size_t last) {
+            for (auto block = first; block < last; ++block) {
+                auto renormalize = renormalizer{renormalize_every};
+                auto running = identity;
+                for (auto i = block * n / blocks; i < (block + 1) * n / blocks; ++i)
+                    running = renormalize(running * in[i]);
+                products[block] = running;
+            }
+        });
+        return products;
+    }
+
+    void check_sizes(std::span<const q::quaternion> in, std::span<q::quaternion> out) {
+        if (in.size() != out.size())
+            throw std::domain_error("scan needs one output per input!");
+    }
+}
+
+void q::inclusive_scan(std::span<const quaternion> in, std::span<quaternion> out, std::size_t renormalize_every) {
+    inclusive_scan(execution::par, in, out, renormalize_every);
+}
+
+void q::inclusive_scan(execution::sequenced_policy, std::span<const quaternion> in, std::span<quaternion> out,
+                       std::size_t renormalize_every) {
+    check_sizes(in, out);
+    auto renormalize = renormalizer{renormalize_every};
+    auto running = identity;
+    for (std::size_t i = 0; i < in.size(); ++i)
+        out[i] = running = renormalize(running * in[i]);
+}
+
+void q::inclusive_scan(execution::parallel_policy policy, std::span<const quaternion> in, std::span<quaternion> out,
+                       std::size_t renormalize_every) {
+    check_sizes(in, out);
+    const auto n = in.size();
+    const auto blocks = block_count(policy, n);
+    // products of all blocks before each block
+    auto prefixes = block_products(policy, in, blocks, renormalize_every);
+    auto running = identity;
+    for (auto& prefix : prefixes) {
+        const auto block_product = prefix;
+        prefix = running;
+        running = running * block_product;
+    }
+
+    parallel_for(policy, blocks, 1, [&](std::size_t first, std::size_t last) {
+        for (auto block = first; block < last; ++block) {
+            auto renormalize = renormalizer{renormalize_every};
+            auto running = prefixes[block];
+            for (auto i = block * n / blocks; i < (block + 1) * n / blocks; ++i)
+                out[i] = running = renormalize(running * in[i]);
+        }
+    });
+}
+
+q::quaternion q::reduce(std::span<const quaternion> in, std::size_t renormalize_every) {
+    return reduce(execution::par, in, renormalize_every);
+}
+
+q::quaternion q::reduce(execution::sequenced_policy, std::span<const quaternion> in, std::size_t renormalize_every) {
+    auto renormalize = renormalizer{renormalize_every};
+    auto running = identity;
+    for (const auto& q : in)
+        running = renormalize(running * q);
+    return running;
+}
+
+q::quaternion q::reduce(execution::parallel_policy policy, std::span<const quaternion> in,
+                        std::size_t renormalize_every) {
+    const auto products = block_products(policy, in, block_count(policy, in.size()), renormalize_every);
+    auto renormalize = renormalizer{renormalize_every};
+    auto running = identity;
+    for (const auto& product : products)
+        running = renormalize(running * product);
+    return running;
+}
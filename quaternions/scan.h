@@ -0,0 +1,31 @@
+#ifndef QUATERNIONS_SCAN_H
+#define QUATERNIONS_SCAN_H
+
+#include <cstddef>
+#include <span>
+#include "execution.h"
+#include "quaternion.h"
+
+namespace quaternions {
+    /**
+     * Running products out[i] = in[0] * in[1] * ... * in[i]. out may be in. With execution::par,
+     * the default, they are computed as a blocked scan on the executor of the policy. With
+     * renormalize_every = n > 0 every n-th running product of a block is normalized, which keeps
+     * long chains of unit quaternions from drifting.
+     */
+    void inclusive_scan(std::span<const quaternion> in, std::span<quaternion> out,
+                        std::size_t renormalize_every = 0);
+    void inclusive_scan(execution::sequenced_policy, std::span<const quaternion> in, std::span<quaternion> out,
+                        std::size_t renormalize_every = 0);
+    void inclusive_scan(execution::parallel_policy, std::span<const quaternion> in, std::span<quaternion> out,
+                        std::size_t renormalize_every = 0);
+
+    /**
+     * Product in[0] * in[1] * ... of all quaternions, or the identity for an empty span
+     */
+    quaternion reduce(std::span<const quaternion> in, std::size_t renormalize_every = 0);
+    quaternion reduce(execution::sequenced_policy, std::span<const quaternion> in, std::size_t renormalize_every = 0);
+    quaternion reduce(execution::parallel_policy, std::span<const quaternion> in, std::size_t renormalize_every = 0);
+}
+
+#endif //QUATERNIONS_SCAN_H
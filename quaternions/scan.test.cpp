@@ -0,0 +1,134 @@
+#include <catch2/catch_test_macros.hpp>
+#include <catch2/generators/catch_generators.hpp>
+#include <catch2/matchers/catch_matchers_floating_point.hpp>
+#include "execution.h"
+#include "scan.h"
+#include "quaternion.h"
+#include "thread_pool.h"
+#include <algorithm>
+#include <cmath>
+#include <functional>
+#include <stdexcept>
+#include <vector>
+#include "../test/helpers.h"
+
+namespace q = quaternions;
+using Catch::Matchers::WithinAbs;
+
+namespace {
+    /**
+     * Runs all chunks on the calling thread in order, remembering the largest bulk call
+     */
+    class recording_executor : public q::execution::executor {
+    public:
+        std::size_t threads;
+        std::size_t most_chunks = 0;
+
+        explicit recording_executor(std::size_t threads) : threads(threads) {}
+
+        std::size_t concurrency() const override {
+            return threads;
+        }
+
+        void bulk(std::size_t chunks, const std::function<void(std::size_t)>& body) override {
+            most_chunks = std::max(most_chunks, chunks);
+            for (std::size_t chunk = 0; chunk < chunks; ++chunk)
+                body(chunk);
+        }
+    };
+
+    // small rotations, so that long chains stay well conditioned
+    std::vector<q::quaternion> small_rotations(std::size_t n) {
+        auto result = std::vector<q::quaternion>{};
+        for (const auto& axis : random_vectors(n, 7))
+            result.push_back(q::quaternion::from_rotation({axis.normalized(), 0.01}));
+        return result;
+    }
+}
+
+TEST_CASE("inclusive scan matches a serial loop")
+{
+    const auto n = GENERATE(std::size_t{0}, 1, 1000, 100'001);
+    const auto in = small_rotations(n);
+    auto out = std::vector<q::quaternion>(n);
+    q::inclusive_scan(in, out);
+
+    auto running = q::quaternion{1, 0, 0, 0};
+    auto max_error = 0.0;
+    for (std::size_t i = 0; i < n; ++i) {
+        running = running * in[i];
+        max_error = std::max(max_error, (out[i] - running).length());
+    }
+    CHECK_THAT(max_error, WithinAbs(0, 1E-9));
+    if (n > 0)
+        CHECK_THAT(q::reduce(in), WithinAbs(out.back(), 1E-9));
+}
+
+TEST_CASE("scan and reduce agree on every policy")
+{
+    const auto in = small_rotations(100'001);
+    auto pool = q::thread_pool(3);
+    auto seq = std::vector<q::quaternion>(in.size()), par = seq;
+    q::inclusive_scan(q::execution::seq, in, seq);
+    q::inclusive_scan(q::execution::par.on(pool), in, par);
+    auto running = q::quaternion{1, 0, 0, 0};
+    for (std::size_t i = 0; i < in.size(); ++i)
+        running = running * in[i];
+    CHECK(seq.back() == running);
+    CHECK(q::reduce(q::execution::seq, in) == running);
+    CHECK_THAT(par.back(), WithinAbs(running, 1E-9));
+    CHECK_THAT(q::reduce(q::execution::par.on(pool), in), WithinAbs(running, 1E-9));
+    CHECK_THROWS_AS(q::inclusive_scan(q::execution::seq, in, std::span(seq).first(10)), std::domain_error);
+}
+
+TEST_CASE("scan blocks follow the concurrency of the executor")
+{
+    // enough rotations for 24 blocks of the minimum size
+    const auto in = small_rotations(24 * 16384);
+    auto out = std::vector<q::quaternion>(in.size());
+    for (const auto threads : {std::size_t{2}, std::size_t{5}}) {
+        auto executor = recording_executor(threads);
+        q::inclusive_scan(q::execution::par.on(executor), in, out);
+        CHECK(executor.most_chunks == std::min<std::size_t>(24, 4 * threads));
+        executor.most_chunks = 0;
+        q::reduce(q::execution::par.on(executor), in);
+        CHECK(executor.most_chunks == std::min<std::size_t>(24, 4 * threads));
+    }
+}
+
+TEST_CASE("scan of non-commuting rotations keeps their order")
+{
+    const auto in = std::vector<q::quaternion>{
+        q::quaternion::from_rotation({{0, 0, 1}, M_PI_2}),
+        q::quaternion::from_rotation({{1, 0, 0}, M_PI_2}),
+    };
+    auto out = std::vector<q::quaternion>(2);
+    q::inclusive_scan(in, out);
+    CHECK_THAT(out[1], WithinAbs(in[0] * in[1]));
+    CHECK_THAT(q::reduce(in), WithinAbs(in[0] * in[1]));
+}
+
+TEST_CASE("renormalization keeps long chains on the unit sphere")
+{
+    auto in = small_rotations(200'000);
+    for (auto& r : in)
+        r = r * (1 + 1E-9);
+    auto out = std::vector<q::quaternion>(in.size());
+    q::inclusive_scan(in, out, 64);
+    for (std::size_t i = 0; i < out.size(); i += 997)
+        CHECK_THAT(out[i].length(), WithinAbs(1, 1E-6));
+    CHECK_THAT(q::reduce(in, 64).length(), WithinAbs(1, 1E-6));
+}
+
+TEST_CASE("scan may write into its input")
+{
+    auto values = small_rotations(50'000);
+    const auto expected = q::reduce(values);
+    q::inclusive_scan(values, values);
+    CHECK_THAT(values.back(), WithinAbs(expected, 1E-9));
+}
+
+TEST_CASE("reduce of nothing is the identity")
+{
+    CHECK(q::reduce({}) == q::quaternion{1, 0, 0, 0});
+}
@@ -0,0 +1,110 @@
+#ifndef QUATERNIONS_SIMD_H
+#define QUATERNIONS_SIMD_H
+
+#include <cmath>
+#include <cstddef>
+#if defined(__SSE2__)
+#include <immintrin.h>
+#endif
+
+/**
+ * Thin wrappers around the vector registers the current translation unit is compiled for.
+ * Everything lives in an unnamed namespace, so translation units built for different
+ * instruction sets never share (and never accidentally link against) each other's code.
+ */
+namespace quaternions::simd {
+    namespace {
+        struct scalar {
+            using reg = double;
+            static constexpr std::size_t width = 1;
+
+            static reg load(const double* p) { return *p; }
+            static void store(double* p, reg v) { *p = v; }
+            static reg broadcast(double s) { return s; }
+            static reg add(reg a, reg b) { return a + b; }
+            static reg sub(reg a, reg b) { return a - b; }
+            static reg mul(reg a, reg b) { return a * b; }
+            static reg div(reg a, reg b) { return a / b; }
+            static reg sqrt(reg a) { return std::sqrt(a); }
+            static reg neg(reg a) { return -a; }
+            // a * b + c
+            static reg fmadd(reg a, reg b, reg c) { return a * b + c; }
+            // c - a * b
+            static reg fnmadd(reg a, reg b, reg c) { return c - a * b; }
+            // a > b ? x : y
+            static reg select_greater(reg a, reg b, reg x, reg y) { return a > b ? x : y; }
+        };
+
+#if defined(__SSE2__)
+        struct sse2 {
+            using reg = __m128d;
+            static constexpr std::size_t width = 2;
+
+            static reg load(const double* p) { return _mm_loadu_pd(p); }
+            static void store(double* p, reg v) { _mm_storeu_pd(p, v); }
+            static reg broadcast(double s) { return _mm_set1_pd(s); }
+            static reg add(reg a, reg b) { return _mm_add_pd(a, b); }
+            static reg sub(reg a, reg b) { return _mm_sub_pd(a, b); }
+            static reg mul(reg a, reg b) { return _mm_mul_pd(a, b); }
+            static reg div(reg a, reg b) { return _mm_div_pd(a, b); }
+            static reg sqrt(reg a) { return _mm_sqrt_pd(a); }
+            static reg neg(reg a) { return _mm_xor_pd(a, _mm_set1_pd(-0.0)); }
+            static reg fmadd(reg a, reg b, reg c) { return _mm_add_pd(_mm_mul_pd(a, b), c); }
+            static reg fnmadd(reg a, reg b, reg c) { return _mm_sub_pd(c, _mm_mul_pd(a, b)); }
+            static reg select_greater(reg a, reg b, reg x, reg y) {
+                const auto mask = _mm_cmpgt_pd(a, b);
+                return _mm_or_pd(_mm_and_pd(mask, x), _mm_andnot_pd(mask, y));
+            }
+        };
+#endif
+
+#if defined(__AVX2__) && defined(__FMA__)
+        struct avx2 {
+            using reg = __m256d;
+            static constexpr std::size_t width = 4;
+
+            static reg load(const double* p) { return _mm256_loadu_pd(p); }
+            static void store(double* p, reg v) { _mm256_storeu_pd(p, v); }
+            static reg broadcast(double s) { return _mm256_set1_pd(s); }
+            static reg add(reg a, reg b) { return _mm256_add_pd(a, b); }
+            static reg sub(reg a, reg b) { return _mm256_sub_pd(a, b); }
+            static reg mul(reg a, reg b) { return _mm256_mul_pd(a, b); }
+            static reg div(reg a, reg b) { return _mm256_div_pd(a, b); }
+            static reg sqrt(reg a) { return _mm256_sqrt_pd(a); }
+            static reg neg(reg a) { return _mm256_xor_pd(a, _mm256_set1_pd(-0.0)); }
+            static reg fmadd(reg a, reg b, reg c) { return _mm256_fmadd_pd(a, b, c); }
+            static reg fnmadd(reg a, reg b, reg c) { return _mm256_fnmadd_pd(a, b, c); }
+            static reg select_greater(reg a, reg b, reg x, reg y) {
+                return _mm256_blendv_pd(y, x, _mm256_cmp_pd(a, b, _CMP_GT_OQ));
+            }
+        };
+#endif
+
+#if defined(__AVX512F__)
+        struct avx512 {
+            using reg = __m512d;
+            static constexpr std::size_t width = 8;
+
+            static reg load(const double* p) { return _mm512_loadu_pd(p); }
+            static void store(double* p, reg v) { _mm512_storeu_pd(p, v); }
+            static reg broadcast(double s) { return _mm512_set1_pd(s); }
+            static reg add(reg a, reg b) { return _mm512_add_pd(a, b); }
+            static reg sub(reg a, reg b) { return _mm512_sub_pd(a, b); }
+            static reg mul(reg a, reg b) { return _mm512_mul_pd(a, b); }
+            static reg div(reg a, reg b) { return _mm512_div_pd(a, b); }
+            static reg sqrt(reg a) { return _mm512_sqrt_pd(a); }
+            static reg neg(reg a) {
+                return _mm512_castsi512_pd(_mm512_xor_si512(
+                    _mm512_castpd_si512(a), _mm512_set1_epi64(static_cast<long long>(0x8000000000000000ULL))));
+            }
+            static reg fmadd(reg a, reg b, reg c) { return _mm512_fmadd_pd(a, b, c); }
+            static reg fnmadd(reg a, reg b, reg c) { return _mm512_fnmadd_pd(a, b, c); }
+            static reg select_greater(reg a, reg b, reg x, reg y) {
+                return _mm512_mask_blend_pd(_mm512_cmp_pd_mask(a, b, _CMP_GT_OQ), y, x);
+            }
+        };
+#endif
+    }
+}
+
+#endif //QUATERNIONS_SIMD_H
@@ -0,0 +1,39 @@
+#include <catch2/catch_test_macros.hpp>
+#include <catch2/benchmark/catch_benchmark.hpp>
+#include "quaternion_batch.h"
+#include "swing_twist.h"
+#include <vector>
+#include "../test/benchmarks.h"
+#include "../test/helpers.h"
+
+namespace q = quaternions;
+
+TEST_CASE("single and batch joint clamping")
+{
+    for (const auto n : benchmark_batch_sizes) {
+        const auto rotations = random_unit_quaternions(n, 1);
+        const auto axes = random_vectors(n, 2);
+        auto limits = std::vector<q::joint_limit>{};
+        for (const auto& axis : axes)
+            limits.push_back({axis, 0.8, -0.5, 0.5});
+        const auto soa = q::joint_limits(limits);
+        const auto joints = q::quaternion_batch::from(rotations);
+        auto single = std::vector<q::quaternion>(n);
+        auto batch = joints;
+        BENCHMARK("decompose x" + batch_label(n)) {
+            for (std::size_t i = 0; i < n; ++i)
+                single[i] = q::decompose(rotations[i], limits[i].twist_axis).swing;
+            return single[0];
+        };
+        BENCHMARK("clamped x" + batch_label(n)) {
+            for (std::size_t i = 0; i < n; ++i)
+                single[i] = q::clamped(rotations[i], limits[i]);
+            return single[0];
+        };
+        BENCHMARK("batch clamp x" + batch_label(n)) {
+            batch = joints;
+            q::clamp(batch, soa);
+            return batch[0];
+        };
+    }
+}
@@ -0,0 +1,85 @@
+#include "swing_twist.h"
+#include "dispatch.h"
+#include <algorithm>
+#include <cmath>
+#include <stdexcept>
+#include <string>
+
+namespace q = quaternions;
+namespace k = quaternions::kernels;
+
+namespace {
+    /**
+     * A joint_limit as the values clamping compares against
+     */
+    struct prepared_limit {
+        q::xyz axis;
+        double cos_half_swing;
+        double sin_half_swing;
+        double sin_half_min_twist;
+        double sin_half_max_twist;
+    };
+
+    prepared_limit prepare(const q::joint_limit& limit) {
+        if (limit.twist_axis.norm() == 0)
+            throw std::domain_error("a joint limit needs a twist axis!");
+        if (!(limit.max_swing >= 0 && limit.max_swing <= M_PI))
+            throw std::domain_error("the largest swing must be within [0, π]!");
+        if (!(-M_PI <= limit.min_twist && limit.min_twist <= limit.max_twist && limit.max_twist <= M_PI))
+            throw std::domain_error("the twist limits must be ordered and within [-π, π]!");
+        return {
+            limit.twist_axis.normalized(),
+            std::cos(limit.max_swing / 2),
+            std::sin(limit.max_swing / 2),
+            std::sin(limit.min_twist / 2),
+            std::sin(limit.max_twist / 2),
+        };
+    }
+}
+
+q::quaternion q::clamped(const quaternion& q, const joint_limit& limit) {
+    const auto l = prepare(limit);
+    // with w >= 0 the half twist angle is within [-π/2, π/2], where its sine grows with it
+    const auto sign = q.w < 0 ? -1.0 : 1.0;
+    const auto [swing, twist] = decompose(q * sign, l.axis);
+    const auto s = std::clamp(twist.vector().dot(l.axis), l.sin_half_min_twist, l.sin_half_max_twist);
+    const auto limited_twist = quaternion{std::sqrt(1 - s * s), s * l.axis.x, s * l.axis.y, s * l.axis.z};
+    auto limited_swing = swing;
+    if (swing.w < l.cos_half_swing) {
+        const auto length = swing.vector().length();
+        const auto f = length > 0 ? l.sin_half_swing / length : 0.0;
+        limited_swing = quaternion{l.cos_half_swing, swing.x * f, swing.y * f, swing.z * f};
+    }
+    return limited_swing * limited_twist * sign;
+}
+
+q::joint_limits::joint_limits(std::span<const joint_limit> limits) {
+    for (auto* s : {&axis_x, &axis_y, &axis_z, &cos_half_swing, &sin_half_swing, &sin_half_min_twist,
+                    &sin_half_max_twist})
+        s->reserve(limits.size());
+    for (const auto& limit : limits) {
+        const auto l = prepare(limit);
+        axis_x.push_back(l.axis.x);
+        axis_y.push_back(l.axis.y);
+        axis_z.push_back(l.axis.z);
+        cos_half_swing.push_back(l.cos_half_swing);
+        sin_half_swing.push_back(l.sin_half_swing);
+        sin_half_min_twist.push_back(l.sin_half_min_twist);
+        sin_half_max_twist.push_back(l.sin_half_max_twist);
+    }
+}
+
+std::size_t q::joint_limits::size() const {
+    return axis_x.size();
+}
+
+void q::clamp(quaternion_batch& joints, const joint_limits& limits) {
+    if (joints.size() != limits.size())
+        throw std::domain_error("batch sizes " + std::to_string(joints.size()) +
+                                " and " + std::to_string(limits.size()) + " differ!");
+    const auto l = k::soa_limits{
+        limits.axis_x.data(), limits.axis_y.data(), limits.axis_z.data(), limits.cos_half_swing.data(),
+        limits.sin_half_swing.data(), limits.sin_half_min_twist.data(), limits.sin_half_max_twist.data(),
+    };
+    k::active().clamp_joints({joints.w.data(), joints.x.data(), joints.y.data(), joints.z.data()}, l, joints.size());
+}
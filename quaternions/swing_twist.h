@@ -0,0 +1,95 @@
+#ifndef QUATERNIONS_SWING_TWIST_H
+#define QUATERNIONS_SWING_TWIST_H
+
+#include <cmath>
+#include <cstddef>
+#include <span>
+#include <vector>
+#include "aligned_allocator.h"
+#include "quaternion.h"
+#include "quaternion_batch.h"
+#include "xyz.h"
+
+namespace quaternions {
+    /**
+     * A rotation split into swing * twist: twist turns about a given axis and swing about an axis
+     * perpendicular to it, e.g. a bone's roll and the tilt of its direction
+     */
+    template<typename T>
+    struct basic_swing_twist {
+        basic_quaternion<T> swing;
+        basic_quaternion<T> twist;
+    };
+
+    using swing_twist = basic_swing_twist<double>;
+
+    namespace twist {
+        // length of q's projection onto the twist axis below which the twist is taken as the identity
+        inline constexpr double degenerate = 1E-9;
+    }
+
+    /**
+     * Swing and twist of the unit quaternion q about the unit vector axis, with q == swing * twist.
+     * Where q turns axis by π the twist is not determined and taken as the identity.
+     */
+    template<typename T>
+    basic_swing_twist<T> decompose(const basic_quaternion<T>& q, const basic_xyz<T>& axis) {
+        const auto p = q.vector().dot(axis);
+        const auto length = std::sqrt(q.w * q.w + p * p);
+        const auto t = length > T(twist::degenerate)
+            ? basic_quaternion<T>{q.w / length, p / length * axis.x, p / length * axis.y, p / length * axis.z}
+            : basic_quaternion<T>{1, 0, 0, 0};
+        return {q * t.conjugated(), t};
+    }
+
+    /**
+     * Range of motion of a joint in radians: the swing may tilt twist_axis by up to max_swing in
+     * [0, π], the twist about it must be within [min_twist, max_twist] in [-π, π]
+     */
+    struct joint_limit {
+        xyz twist_axis;
+        double max_swing;
+        double min_twist;
+        double max_twist;
+    };
+
+    /**
+     * The unit quaternion q with its swing and twist about limit.twist_axis clamped to the limit.
+     * A swing beyond max_swing keeps its direction, a twist angle in (-π, π] is clamped to
+     * [min_twist, max_twist]. Throws std::domain_error for an invalid limit.
+     */
+    quaternion clamped(const quaternion& q, const joint_limit& limit);
+
+    /**
+     * Limits of many joints as structure of arrays, validated once and kept as the unit twist
+     * axes and the cosines and sines of the half angles that clamping compares against
+     */
+    class joint_limits {
+    public:
+        using storage = std::vector<double, aligned_allocator<double>>;
+
+        storage axis_x;
+        storage axis_y;
+        storage axis_z;
+        storage cos_half_swing;
+        storage sin_half_swing;
+        storage sin_half_min_twist;
+        storage sin_half_max_twist;
+
+        joint_limits() = default;
+        /**
+         * Throws std::domain_error for an invalid limit
+         */
+        explicit joint_limits(std::span<const joint_limit> limits);
+
+        std::size_t size() const;
+    };
+
+    /**
+     * Clamps every joint to the limits with the same index in one pass of the batch kernels,
+     * like clamped() does for one joint. Throws std::domain_error if the sizes differ.
+     */
+    void clamp(quaternion_batch& joints, const joint_limits& limits);
+}
+
+#endif //QUATERNIONS_SWING_TWIST_H
@@ -0,0 +1,122 @@
+#include <catch2/catch_test_macros.hpp>
+#include <catch2/matchers/catch_matchers_floating_point.hpp>
+#include "dispatch.h"
+#include "quaternion.h"
+#include "quaternion_batch.h"
+#include "swing_twist.h"
+#include <cmath>
+#include <stdexcept>
+#include <vector>
+#include "../test/helpers.h"
+
+namespace q = quaternions;
+namespace k = quaternions::kernels;
+
+namespace {
+    // rotation angle in [0, π]
+    double angle(const q::quaternion& r) {
+        return 2 * std::atan2(r.vector().length(), std::abs(r.w));
+    }
+
+    std::vector<q::joint_limit> random_limits(std::size_t n, std::uint32_t seed) {
+        auto limits = std::vector<q::joint_limit>{};
+        const auto axes = random_vectors(n, seed);
+        for (std::size_t i = 0; i < n; ++i) {
+            const auto t = static_cast<double>(i % 7) / 7;
+            limits.push_back({axes[i], 0.2 + 2 * t, -0.3 - t, 0.1 + 2 * t});
+        }
+        return limits;
+    }
+}
+
+TEST_CASE("swing times twist is the rotation and the twist turns about the axis")
+{
+    const auto axes = random_vectors(200, 1);
+    const auto rotations = random_unit_quaternions(200, 2);
+    for (std::size_t i = 0; i < rotations.size(); ++i) {
+        const auto axis = axes[i].normalized();
+        const auto [swing, twist] = q::decompose(rotations[i], axis);
+        CHECK_THAT(swing * twist, WithinAbs(rotations[i]));
+        CHECK_THAT(swing.vector().dot(axis), Catch::Matchers::WithinAbs(0, 1E-12));
+        const auto along = twist.vector().dot(axis);
+        CHECK_THAT(twist.vector(), WithinAbs(q::xyz{along * axis.x, along * axis.y, along * axis.z}));
+        CHECK_THAT(twist.norm(), Catch::Matchers::WithinAbs(1, 1E-12));
+    }
+
+    const auto half_turn = q::quaternion::from_rotation({{1, 0, 0}, M_PI});
+    const auto [swing, twist] = q::decompose(half_turn, q::xyz{0, 0, 1});
+    CHECK(twist == q::quaternion{1, 0, 0, 0});
+    CHECK(swing == half_turn);
+}
+
+TEST_CASE("clamping keeps rotations within the limits and moves others onto them")
+{
+    const auto limit = q::joint_limit{{0, 0, 2}, 0.4, -0.5, 0.3};
+    const auto inside = q::quaternion::from_rotation({{1, 0, 0}, 0.3}) * q::quaternion::from_rotation({{0, 0, 1}, -0.4});
+    CHECK_THAT(q::clamped(inside, limit), WithinAbs(inside));
+    CHECK_THAT(q::clamped(-inside, limit), WithinAbs(-inside));
+
+    const auto twisted = q::quaternion::from_rotation({{0, 0, 1}, 1.5});
+    CHECK_THAT(q::clamped(twisted, limit), WithinAbs(q::quaternion::from_rotation({{0, 0, 1}, 0.3})));
+    const auto twisted_back = q::quaternion::from_rotation({{0, 0, 1}, -2.5});
+    CHECK_THAT(q::clamped(twisted_back, limit), WithinAbs(q::quaternion::from_rotation({{0, 0, 1}, -0.5})));
+
+    const auto swung = q::quaternion::from_rotation({{0.6, 0.8, 0}, 1.2});
+    CHECK_THAT(q::clamped(swung, limit), WithinAbs(q::quaternion::from_rotation({{0.6, 0.8, 0}, 0.4})));
+
+    const auto limits = random_limits(100, 3);
+    const auto rotations = random_unit_quaternions(100, 4);
+    for (std::size_t i = 0; i < rotations.size(); ++i) {
+        const auto r = q::clamped(rotations[i], limits[i]);
+        const auto axis = limits[i].twist_axis.normalized();
+        const auto [swing, twist] = q::decompose(r, axis);
+        CHECK_THAT(r.norm(), Catch::Matchers::WithinAbs(1, 1E-12));
+        CHECK(angle(swing) <= limits[i].max_swing + 1E-12);
+        const auto sign = twist.w < 0 ? -1.0 : 1.0;
+        const auto twist_angle = 2 * std::atan2(sign * twist.vector().dot(axis), sign * twist.w);
+        CHECK(twist_angle >= limits[i].min_twist - 1E-12);
+        CHECK(twist_angle <= limits[i].max_twist + 1E-12);
+        CHECK_THAT(q::clamped(r, limits[i]), WithinAbs(r));
+    }
+}
+
+TEST_CASE("joint limits must be valid")
+{
+    const auto r = q::quaternion{1, 0, 0, 0};
+    CHECK_THROWS_AS(q::clamped(r, {{0, 0, 0}, 1, -1, 1}), std::domain_error);
+    CHECK_THROWS_AS(q::clamped(r, {{0, 0, 1}, -0.1, -1, 1}), std::domain_error);
+    CHECK_THROWS_AS(q::clamped(r, {{0, 0, 1}, 4, -1, 1}), std::domain_error);
+    CHECK_THROWS_AS(q::clamped(r, {{0, 0, 1}, 1, 1, -1}), std::domain_error);
+    CHECK_THROWS_AS(q::clamped(r, {{0, 0, 1}, 1, -4, 1}), std::domain_error);
+    const auto invalid = std::vector<q::joint_limit>{{{0, 1, 0}, 1, -1, 1}, {{0, 1, 0}, 1, 0, 4}};
+    CHECK_THROWS_AS(q::joint_limits(invalid), std::domain_error);
+}
+
+TEST_CASE("batch clamping of every supported level matches clamping single joints")
+{
+    const auto n = std::size_t{37};
+    const auto limits = random_limits(n, 5);
+    const auto soa = q::joint_limits(limits);
+    auto rotations = random_unit_quaternions(n, 6);
+    rotations[3] = q::quaternion::from_rotation({limits[3].twist_axis.normalized(), 2.0});
+    rotations[4] = -rotations[4];
+    const auto joints = q::quaternion_batch::from(rotations);
+    for (const auto level : q::supported_isas()) {
+        INFO("instruction set level " << q::to_string(level));
+        auto clamped = joints;
+        const auto l = k::soa_limits{
+            soa.axis_x.data(), soa.axis_y.data(), soa.axis_z.data(), soa.cos_half_swing.data(),
+            soa.sin_half_swing.data(), soa.sin_half_min_twist.data(), soa.sin_half_max_twist.data(),
+        };
+        k::table_for(level)->clamp_joints({clamped.w.data(), clamped.x.data(), clamped.y.data(), clamped.z.data()},
+                                          l, n);
+        for (std::size_t i = 0; i < n; ++i)
+            CHECK_THAT(clamped[i], WithinAbs(q::clamped(rotations[i], limits[i])));
+    }
+
+    auto batch = joints;
+    q::clamp(batch, soa);
+    CHECK_THAT(batch[9], WithinAbs(q::clamped(rotations[9], limits[9])));
+    auto too_long = q::quaternion_batch(n + 1);
+    CHECK_THROWS_AS(q::clamp(too_long, soa), std::domain_error);
+}
@@ -0,0 +1,130 @@
+#include "thread_pool.h"
+#include "parallel.h"
+#include <algorithm>
+#include <exception>
+#include <stdexcept>
+
+namespace q = quaternions;
+
+namespace {
+    // the pool and deque of the worker running on this thread, if any
+    thread_local const q::thread_pool* current_pool = nullptr;
+    thread_local std::size_t current_queue = 0;
+}
+
+q::thread_pool::thread_pool(std::size_t concurrency) {
+    if (concurrency == 0)
+        throw std::domain_error("a thread pool needs a concurrency of at least one!");
+    for (std::size_t i = 1; i < concurrency; ++i)
+        queues.push_back(std::make_unique<queue>());
+    workers.reserve(queues.size());
+    for (std::size_t i = 0; i < queues.size(); ++i)
+        workers.emplace_back([this, i] { work(i); });
+}
+
+q::thread_pool::~thread_pool() {
+    {
+        const auto lock = std::lock_guard{sleep_mutex};
+        stopping = true;
+    }
+    wake.notify_all();
+    for (auto& worker : workers)
+        worker.join();
+}
+
+q::thread_pool& q::thread_pool::shared() {
+    static auto pool = thread_pool(hardware_threads());
+    return pool;
+}
+
+std::size_t q::thread_pool::concurrency() const {
+    return workers.size() + 1;
+}
+
+void q::thread_pool::submit(std::function<void()> task) {
+    if (queues.empty()) {
+        task();
+        return;
+    }
+    const auto index = current_pool == this ? current_queue : next_queue++ % queues.size();
+    {
+        const auto lock = std::lock_guard{queues[index]->mutex};
+        queues[index]->tasks.push_back(std::move(task));
+    }
+    {
+        const auto lock = std::lock_guard{sleep_mutex};
+        ++pending;
+    }
+    wake.notify_one();
+}
+
+void q::thread_pool::bulk(std::size_t chunks, const std::function<void(std::size_t)>& body) {
+    auto next = std::atomic<std::size_t>{0};
+    auto finished = std::atomic<std::size_t>{0};
+    auto error = std::exception_ptr{};
+    auto error_mutex = std::mutex{};
+    const auto run_chunks = [&] {
+        for (auto chunk = next++; chunk < chunks; chunk = next++) {
+            try {
+                body(chunk);
+            } catch (...) {
+                const auto lock = std::lock_guard{error_mutex};
+                if (!error)
+                    error = std::current_exception();
+            }
+        }
+    };
+
+    const auto helpers = std::min(chunks > 0 ? chunks - 1 : 0, workers.size());
+    for (std::size_t i = 0; i < helpers; ++i)
+        submit([&] {
+            run_chunks();
+            finished.fetch_add(1, std::memory_order_release);
+        });
+    run_chunks();
+    // helpers still queued find no chunks left, running them here is cheaper than waiting for them
+    const auto home = current_pool == this ? current_queue : queues.size();
+    while (finished.load(std::memory_order_acquire) < helpers)
+        if (!run_one(home))
+            std::this_thread::yield();
+    if (error)
+        std::rethrow_exception(error);
+}
+
+void q::thread_pool::work(std::size_t index) {
+    current_pool = this;
+    current_queue = index;
+    while (true) {
+        if (run_one(index))
+            continue;
+        auto lock = std::unique_lock{sleep_mutex};
+        wake.wait(lock, [&] { return stopping || pending > 0; });
+        if (stopping && pending == 0)
+            return;
+    }
+}
+
+bool q::thread_pool::run_one(std::size_t home) {
+    auto task = std::function<void()>{};
+    if (home < queues.size()) {
+        auto& own = *queues[home];
+        const auto lock = std::lock_guard{own.mutex};
+        if (!own.tasks.empty()) {
+            task = std::move(own.tasks.back());
+            own.tasks.pop_back();
+        }
+    }
+    for (std::size_t i = 1; !task && i <= queues.size(); ++i) {
+        auto& victim = *queues[(home + i) % queues.size()];
+        const auto lock = std::lock_guard{victim.mutex};
+        if (!victim.tasks.empty()) {
+            task = std::move(victim.tasks.front());
+            victim.tasks.pop_front();
+        }
+    }
+    if (!task)
+        return false;
+    --pending;
+    task();
+    return true;
+}
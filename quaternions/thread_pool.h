@@ -0,0 +1,71 @@
+#ifndef QUATERNIONS_THREAD_POOL_H
+#define QUATERNIONS_THREAD_POOL_H
+
+#include <atomic>
+#include <condition_variable>
+#include <cstddef>
+#include <deque>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <vector>
+#include "execution.h"
+
+namespace quaternions {
+    /**
+     * Work-stealing pool of concurrency - 1 worker threads; the thread calling bulk is the last one.
+     * Every worker has its own task deque: it runs its newest task first and, when that is empty,
+     * steals the oldest task of another worker. Threads waiting in bulk run pending tasks meanwhile,
+     * so bulk may be called from inside a task.
+     */
+    class thread_pool : public execution::executor {
+    public:
+        explicit thread_pool(std::size_t concurrency);
+        thread_pool(const thread_pool&) = delete;
+        thread_pool& operator=(const thread_pool&) = delete;
+        /**
+         * Runs the tasks still queued, then joins the workers
+         */
+        ~thread_pool() override;
+
+        /**
+         * Pool with hardware_threads() concurrency used by all parallel policies without an executor,
+         * started on first use
+         */
+        static thread_pool& shared();
+
+        std::size_t concurrency() const override;
+
+        /**
+         * Queues task on the deque of the calling worker, or of the next worker in turn when called
+         * from another thread. A task must not throw.
+         */
+        void submit(std::function<void()> task);
+
+        /**
+         * Chunks are claimed one at a time by the calling thread and by up to concurrency() - 1
+         * workers, so that uneven chunks balance out
+         */
+        void bulk(std::size_t chunks, const std::function<void(std::size_t chunk)>& body) override;
+
+    private:
+        struct queue {
+            std::mutex mutex;
+            std::deque<std::function<void()>> tasks;
+        };
+
+        void work(std::size_t index);
+        bool run_one(std::size_t home);
+
+        std::vector<std::unique_ptr<queue>> queues;
+        std::vector<std::thread> workers;
+        std::atomic<std::size_t> next_queue = 0;
+        std::atomic<std::size_t> pending = 0;
+        std::mutex sleep_mutex;
+        std::condition_variable wake;
+        bool stopping = false;
+    };
+}
+
+#endif //QUATERNIONS_THREAD_POOL_H
@@ -0,0 +1,103 @@
+#include <catch2/catch_test_macros.hpp>
+#include <catch2/generators/catch_generators.hpp>
+#include "execution.h"
+#include "parallel.h"
+#include "thread_pool.h"
+#include <algorithm>
+#include <atomic>
+#include <stdexcept>
+#include <thread>
+#include <vector>
+
+namespace q = quaternions;
+
+namespace {
+    /**
+     * Runs all chunks on the calling thread in order, counting the calls
+     */
+    class counting_executor : public q::execution::executor {
+    public:
+        std::size_t calls = 0;
+
+        std::size_t concurrency() const override {
+            return 3;
+        }
+
+        void bulk(std::size_t chunks, const std::function<void(std::size_t)>& body) override {
+            ++calls;
+            for (std::size_t chunk = 0; chunk < chunks; ++chunk)
+                body(chunk);
+        }
+    };
+}
+
+TEST_CASE("a thread pool runs every chunk of a bulk call exactly once")
+{
+    const auto concurrency = GENERATE(std::size_t{1}, 2, 4);
+    const auto chunks = GENERATE(std::size_t{0}, 1, 3, 1000);
+    auto pool = q::thread_pool(concurrency);
+    CHECK(pool.concurrency() == concurrency);
+    auto visits = std::vector<std::atomic<int>>(chunks);
+    pool.bulk(chunks, [&](std::size_t chunk) { ++visits[chunk]; });
+    CHECK(std::all_of(visits.begin(), visits.end(), [](const auto& v) { return v == 1; }));
+}
+
+TEST_CASE("bulk calls can be nested inside the tasks of a thread pool")
+{
+    auto pool = q::thread_pool(3);
+    auto sum = std::atomic<int>{0};
+    pool.bulk(8, [&](std::size_t) {
+        pool.bulk(8, [&](std::size_t chunk) { sum += static_cast<int>(chunk); });
+    });
+    CHECK(sum == 8 * 28);
+}
+
+TEST_CASE("a thread pool rethrows the exceptions of its chunks after running all of them")
+{
+    auto pool = q::thread_pool(4);
+    auto visits = std::atomic<int>{0};
+    CHECK_THROWS_AS(pool.bulk(100, [&](std::size_t chunk) {
+        ++visits;
+        if (chunk % 10 == 3)
+            throw std::domain_error("chunk failed");
+    }), std::domain_error);
+    CHECK(visits == 100);
+}
+
+TEST_CASE("a thread pool runs all submitted tasks before it is destroyed")
+{
+    auto done = std::atomic<int>{0};
+    {
+        auto pool = q::thread_pool(3);
+        for (int i = 0; i < 100; ++i)
+            pool.submit([&] { ++done; });
+    }
+    CHECK(done == 100);
+}
+
+TEST_CASE("a thread pool of concurrency one runs everything on the calling thread")
+{
+    auto pool = q::thread_pool(1);
+    const auto caller = std::this_thread::get_id();
+    auto elsewhere = false;
+    pool.submit([&] { elsewhere |= std::this_thread::get_id() != caller; });
+    pool.bulk(10, [&](std::size_t) { elsewhere |= std::this_thread::get_id() != caller; });
+    CHECK(!elsewhere);
+    CHECK_THROWS_AS(q::thread_pool(0), std::domain_error);
+}
+
+TEST_CASE("parallel policies run on the executor they name")
+{
+    auto executor = counting_executor{};
+    auto visits = std::vector<int>(10'000);
+    q::parallel_for(q::execution::par.on(executor), visits.size(), 100, [&](std::size_t begin, std::size_t end) {
+        for (auto i = begin; i < end; ++i)
+            ++visits[i];
+    });
+    CHECK(executor.calls == 1);
+    CHECK(std::all_of(visits.begin(), visits.end(), [](int v) { return v == 1; }));
+
+    // too little work for a second chunk
+    q::parallel_for(q::execution::par.on(executor), 150, 100, [](std::size_t, std::size_t) {});
+    CHECK(executor.calls == 1);
+}
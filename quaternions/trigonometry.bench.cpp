@@ -0,0 +1,56 @@
+#include <catch2/catch_test_macros.hpp>
+#include <catch2/benchmark/catch_benchmark.hpp>
+#include "trigonometry.h"
+#include <algorithm>
+#include <cmath>
+#include <vector>
+#include "../test/benchmarks.h"
+#include "../test/helpers.h"
+
+namespace q = quaternions;
+
+TEST_CASE("exact and fast from_rotation")
+{
+    for (const auto n : benchmark_batch_sizes) {
+        auto rotations = std::vector<q::rotation>{};
+        for (const auto& v : random_vectors(n, 1))
+            rotations.push_back({v.normalized(), v.x * M_PI});
+        auto exact = std::vector<q::quaternion>(n);
+        auto fast = std::vector<q::quaternion>(n);
+        BENCHMARK("exact from_rotations x" + batch_label(n)) {
+            q::from_rotations(rotations, exact);
+            return exact[0];
+        };
+        BENCHMARK("fast from_rotations x" + batch_label(n)) {
+            q::fast::from_rotations(rotations, fast);
+            return fast[0];
+        };
+
+        auto error = 0.0;
+        for (std::size_t i = 0; i < n; ++i)
+            error = std::max(error, (fast[i] - exact[i]).length());
+        WARN("fast from_rotations x" << batch_label(n) << ": largest error " << error);
+    }
+}
+
+TEST_CASE("exact and fast rotation")
+{
+    for (const auto n : benchmark_batch_sizes) {
+        const auto unit = random_unit_quaternions(n, 2);
+        auto exact = std::vector<q::rotation>(n);
+        auto fast = std::vector<q::rotation>(n);
+        BENCHMARK("exact to_rotations x" + batch_label(n)) {
+            q::to_rotations(unit, exact);
+            return exact[0];
+        };
+        BENCHMARK("fast to_rotations x" + batch_label(n)) {
+            q::fast::to_rotations(unit, fast);
+            return fast[0];
+        };
+
+        auto error = 0.0;
+        for (std::size_t i = 0; i < n; ++i)
+            error = std::max(error, std::abs(fast[i].angle - exact[i].angle));
+        WARN("fast to_rotations x" << batch_label(n) << ": largest angle error " << error);
+    }
+}
@@ -0,0 +1,100 @@
+#include "trigonometry.h"
+#include "dispatch.h"
+#include "parallel.h"
+#include <algorithm>
+#include <stdexcept>
+
+namespace q = quaternions;
+namespace k = quaternions::kernels;
+
+namespace {
+    constexpr std::size_t block_size = 128;
+    // sin and cos or acos take some 20 ns per rotation
+    constexpr std::size_t min_chunk = 2048;
+
+    void check_sizes(std::size_t in, std::size_t out) {
+        if (in != out)
+            throw std::domain_error("converting rotations needs one output per input!");
+    }
+
+    void from_rotation_range(std::span<const q::rotation> in, std::span<q::quaternion> out,
+                             std::size_t begin, std::size_t end) {
+        for (auto i = begin; i < end; ++i)
+            out[i] = q::quaternion::from_rotation(in[i]);
+    }
+
+    void to_rotation_range(std::span<const q::quaternion> in, std::span<q::rotation> out,
+                           std::size_t begin, std::size_t end) {
+        for (auto i = begin; i < end; ++i)
+            out[i] = in[i].rotation();
+    }
+}
+
+void q::from_rotations(std::span<const rotation> in, std::span<quaternion> out) {
+    from_rotations(execution::seq, in, out);
+}
+
+void q::from_rotations(execution::sequenced_policy, std::span<const rotation> in, std::span<quaternion> out) {
+    check_sizes(in.size(), out.size());
+    from_rotation_range(in, out, 0, in.size());
+}
+
+void q::from_rotations(execution::parallel_policy policy, std::span<const rotation> in, std::span<quaternion> out) {
+    check_sizes(in.size(), out.size());
+    parallel_for(policy, in.size(), min_chunk, [&](std::size_t begin, std::size_t end) {
+        from_rotation_range(in, out, begin, end);
+    });
+}
+
+void q::to_rotations(std::span<const quaternion> in, std::span<rotation> out) {
+    to_rotations(execution::seq, in, out);
+}
+
+void q::to_rotations(execution::sequenced_policy, std::span<const quaternion> in, std::span<rotation> out) {
+    check_sizes(in.size(), out.size());
+    to_rotation_range(in, out, 0, in.size());
+}
+
+void q::to_rotations(execution::parallel_policy policy, std::span<const quaternion> in, std::span<rotation> out) {
+    check_sizes(in.size(), out.size());
+    parallel_for(policy, in.size(), min_chunk, [&](std::size_t begin, std::size_t end) {
+        to_rotation_range(in, out, begin, end);
+    });
+}
+
+void q::fast::from_rotations(std::span<const rotation> in, std::span<quaternion> out) {
+    check_sizes(in.size(), out.size());
+    // the half angles of block_size rotations at a time go through the vectorized kernel
+    double half_angles[block_size], sin[block_size], cos[block_size];
+    const auto& kernels = k::active();
+    for (std::size_t begin = 0; begin < in.size(); begin += block_size) {
+        const auto count = std::min(block_size, in.size() - begin);
+        for (std::size_t j = 0; j < count; ++j)
+            half_angles[j] = in[begin + j].angle / 2;
+        kernels.sincos(half_angles, sin, cos, count);
+        for (std::size_t j = 0; j < count; ++j) {
+            const auto& axis = in[begin + j].axis;
+            out[begin + j] = quaternion{cos[j], axis.x * sin[j], axis.y * sin[j], axis.z * sin[j]};
+        }
+    }
+}
+
+void q::fast::to_rotations(std::span<const quaternion> in, std::span<rotation> out) {
+    check_sizes(in.size(), out.size());
+    double w[block_size], half_angles[block_size];
+    const auto& kernels = k::active();
+    for (std::size_t begin = 0; begin < in.size(); begin += block_size) {
+        const auto count = std::min(block_size, in.size() - begin);
+        for (std::size_t j = 0; j < count; ++j)
+            w[j] = in[begin + j].w;
+        kernels.acos(w, half_angles, count);
+        for (std::size_t j = 0; j < count; ++j) {
+            const auto& qi = in[begin + j];
+            const auto inverse_divisor = 1 / std::sqrt(1 - qi.w * qi.w);
+            out[begin + j] = rotation{
+                {qi.x * inverse_divisor, qi.y * inverse_divisor, qi.z * inverse_divisor},
+                2 * half_angles[j],
+            };
+        }
+    }
+}
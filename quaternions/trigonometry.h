@@ -0,0 +1,135 @@
+#ifndef QUATERNIONS_TRIGONOMETRY_H
+#define QUATERNIONS_TRIGONOMETRY_H
+
+#include <cmath>
+#include <cstddef>
+#include <cstdint>
+#include <limits>
+#include <span>
+#include <utility>
+#include "execution.h"
+#include "quaternion.h"
+
+namespace quaternions {
+    /**
+     * Batch quaternion::from_rotation and quaternion::rotation(), in and out must have the same size
+     */
+    void from_rotations(std::span<const rotation> in, std::span<quaternion> out);
+    void from_rotations(execution::sequenced_policy, std::span<const rotation> in, std::span<quaternion> out);
+    void from_rotations(execution::parallel_policy, std::span<const rotation> in, std::span<quaternion> out);
+    void to_rotations(std::span<const quaternion> in, std::span<rotation> out);
+    void to_rotations(execution::sequenced_policy, std::span<const quaternion> in, std::span<rotation> out);
+    void to_rotations(execution::parallel_policy, std::span<const quaternion> in, std::span<rotation> out);
+}
+
+/**
+ * Opt-in approximations of the trigonometry in conversions between quaternions and rotations,
+ * built from polynomials instead of libm calls and free of branches, so that batches vectorize.
+ * Error bounds are stated for double.
+ */
+namespace quaternions::fast {
+    /**
+     * sin(x) and cos(x) with an absolute error below 2E-9 for |x| <= 1E6
+     */
+    template<typename T>
+    std::pair<T, T> sincos(T x);
+
+    /**
+     * acos(x) for x in [-1, 1] with an absolute error below 3E-8
+     */
+    template<typename T>
+    T acos(T x);
+
+    /**
+     * quaternion::from_rotation with components off by less than 2E-9
+     */
+    template<typename T>
+    basic_quaternion<T> from_rotation(const basic_rotation<T>& r);
+
+    /**
+     * quaternion::rotation() with the angle off by less than 6E-8
+     */
+    template<typename T>
+    basic_rotation<T> to_rotation(const basic_quaternion<T>& q);
+
+    /**
+     * quaternion::polar_angle() off by less than 3E-8
+     */
+    template<typename T>
+    T polar_angle(const basic_quaternion<T>& q);
+
+    void from_rotations(std::span<const rotation> in, std::span<quaternion> out);
+    void to_rotations(std::span<const quaternion> in, std::span<rotation> out);
+
+    /**
+     * Constants shared with the batch kernels
+     */
+    namespace constants {
+        inline constexpr double two_over_pi = 0.636619772367581343076;
+        // π/2 split in two, so that k π/2 is exact for |k| < 2^20
+        inline constexpr double pi_over_2_high = 1.57079632673412561417e+00;
+        inline constexpr double pi_over_2_low = 6.07710050650619224932e-11;
+        // Taylor polynomials of sin(r) / r and cos(r) in r², highest power first: their remainders
+        // stay below 2E-9 for |r| <= π/4
+        inline constexpr double sin[] = {1.0 / 362880, -1.0 / 5040, 1.0 / 120, -1.0 / 6, 1};
+        inline constexpr double cos[] = {-1.0 / 3628800, 1.0 / 40320, -1.0 / 720, 1.0 / 24, -0.5, 1};
+        // Abramowitz and Stegun 4.4.46: acos(x) = sqrt(1 - x) p(x) for x in [0, 1] with an error
+        // below 2E-8, highest power first
+        inline constexpr double acos[] = {-0.0012624911, 0.0066700901, -0.0170881256, 0.0308918810,
+                                          -0.0501743046, 0.0889789874, -0.2145988016, 1.5707963050};
+    }
+
+    template<typename T, std::size_t N>
+    T polynomial(const double (&coefficients)[N], T x) {
+        auto result = T(coefficients[0]);
+        for (std::size_t i = 1; i < N; ++i)
+            result = result * x + T(coefficients[i]);
+        return result;
+    }
+
+    template<typename T>
+    std::pair<T, T> sincos(T x) {
+        // x = k π/2 + r with |r| <= π/4; adding and subtracting 1.5 * 2^(digits - 1) rounds to
+        // the nearest integer
+        constexpr auto round = T(1.5) * T(std::uint64_t{1} << (std::numeric_limits<T>::digits - 1));
+        const auto k = (x * T(constants::two_over_pi) + round) - round;
+        const auto r = (x - k * T(constants::pi_over_2_high)) - k * T(constants::pi_over_2_low);
+        const auto r2 = r * r;
+        const auto s = r * polynomial(constants::sin, r2);
+        const auto c = polynomial(constants::cos, r2);
+
+        const auto quadrant = static_cast<std::int32_t>(k) & 3;
+        const auto sin = (quadrant & 1) ? c : s;
+        const auto cos = (quadrant & 1) ? s : c;
+        return {(quadrant & 2) ? -sin : sin, ((quadrant + 1) & 2) ? -cos : cos};
+    }
+
+    template<typename T>
+    T acos(T x) {
+        const auto a = std::abs(x);
+        const auto result = std::sqrt(1 - a) * polynomial(constants::acos, a);
+        return x < 0 ? T(M_PI) - result : result;
+    }
+
+    template<typename T>
+    basic_quaternion<T> from_rotation(const basic_rotation<T>& r) {
+        const auto [s, c] = sincos(r.angle / T(2));
+        return basic_quaternion<T>{c, r.axis.x * s, r.axis.y * s, r.axis.z * s};
+    }
+
+    template<typename T>
+    basic_rotation<T> to_rotation(const basic_quaternion<T>& q) {
+        const auto inverse_divisor = 1 / std::sqrt(1 - q.w * q.w);
+        return basic_rotation<T>{
+            basic_xyz<T>{q.x * inverse_divisor, q.y * inverse_divisor, q.z * inverse_divisor},
+            2 * acos(q.w),
+        };
+    }
+
+    template<typename T>
+    T polar_angle(const basic_quaternion<T>& q) {
+        return acos(q.w / q.length());
+    }
+}
+
+#endif //QUATERNIONS_TRIGONOMETRY_H
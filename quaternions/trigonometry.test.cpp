@@ -0,0 +1,92 @@
+#include <catch2/catch_test_macros.hpp>
+#include <catch2/catch_template_test_macros.hpp>
+#include <catch2/matchers/catch_matchers_floating_point.hpp>
+#include "execution.h"
+#include "thread_pool.h"
+#include "trigonometry.h"
+#include <algorithm>
+#include <cmath>
+#include <vector>
+#include "../test/helpers.h"
+
+namespace q = quaternions;
+using Catch::Matchers::WithinAbs;
+
+TEST_CASE("fast sincos stays within its error bound")
+{
+    auto worst = 0.0;
+    for (auto x = -20.0; x <= 20.0; x += 1E-3) {
+        const auto [s, c] = q::fast::sincos(x);
+        worst = std::max({worst, std::abs(s - std::sin(x)), std::abs(c - std::cos(x))});
+    }
+    for (const auto x : {1E3, -12345.678, 999999.5, M_PI, -M_PI_2, M_PI_4}) {
+        const auto [s, c] = q::fast::sincos(x);
+        worst = std::max({worst, std::abs(s - std::sin(x)), std::abs(c - std::cos(x))});
+    }
+    CHECK(worst < 2E-9);
+}
+
+TEST_CASE("fast acos stays within its error bound")
+{
+    auto worst = 0.0;
+    for (auto x = -1.0; x <= 1.0; x += 1E-5)
+        worst = std::max(worst, std::abs(q::fast::acos(x) - std::acos(x)));
+    CHECK(worst < 3E-8);
+    CHECK_THAT(q::fast::acos(1.0), WithinAbs(0, 3E-8));
+    CHECK_THAT(q::fast::acos(-1.0), WithinAbs(M_PI, 3E-8));
+}
+
+TEMPLATE_TEST_CASE("fast trigonometry for every scalar type", "", float, double, long double)
+{
+    const auto [s, c] = q::fast::sincos(TestType(2));
+    CHECK(std::abs(s - std::sin(TestType(2))) < TestType(1E-6));
+    CHECK(std::abs(c - std::cos(TestType(2))) < TestType(1E-6));
+    CHECK(std::abs(q::fast::acos(TestType(0.3)) - std::acos(TestType(0.3))) < TestType(1E-6));
+}
+
+TEST_CASE("fast conversions between quaternions and rotations match the exact ones")
+{
+    auto rotations = std::vector<q::rotation>{};
+    for (const auto& v : random_vectors(1000, 1))
+        rotations.push_back({v.normalized(), v.x * 7});
+    auto exact = std::vector<q::quaternion>(rotations.size());
+    auto fast = std::vector<q::quaternion>(rotations.size());
+    q::from_rotations(rotations, exact);
+    q::fast::from_rotations(rotations, fast);
+    for (std::size_t i = 0; i < rotations.size(); ++i) {
+        CHECK_THAT(fast[i], WithinAbs(exact[i], 2E-9));
+        CHECK_THAT(fast[i], WithinAbs(q::fast::from_rotation(rotations[i]), 1E-15));
+    }
+
+    const auto unit = random_unit_quaternions(1000, 2);
+    auto exact_rotations = std::vector<q::rotation>(unit.size());
+    auto fast_rotations = std::vector<q::rotation>(unit.size());
+    q::to_rotations(unit, exact_rotations);
+    q::fast::to_rotations(unit, fast_rotations);
+    for (std::size_t i = 0; i < unit.size(); ++i) {
+        CHECK_THAT(fast_rotations[i].angle, WithinAbs(exact_rotations[i].angle, 6E-8));
+        CHECK_THAT(fast_rotations[i].axis, WithinAbs(exact_rotations[i].axis, 1E-12));
+        CHECK_THAT(q::fast::polar_angle(2.0 * unit[i]), WithinAbs((2.0 * unit[i]).polar_angle(), 3E-8));
+    }
+    CHECK_THROWS(q::fast::to_rotations(unit, std::span(fast_rotations).subspan(1)));
+}
+
+TEST_CASE("batch conversions between quaternions and rotations give the same results with every policy")
+{
+    auto rotations = std::vector<q::rotation>{};
+    for (const auto& v : random_vectors(20'000, 3))
+        rotations.push_back({v.normalized(), v.x * 7});
+    auto pool = q::thread_pool(4);
+    auto seq = std::vector<q::quaternion>(rotations.size()), par = seq;
+    q::from_rotations(q::execution::seq, rotations, seq);
+    q::from_rotations(q::execution::par.on(pool), rotations, par);
+    CHECK(par == seq);
+
+    auto seq_rotations = std::vector<q::rotation>(seq.size()), par_rotations = seq_rotations;
+    q::to_rotations(q::execution::seq, seq, seq_rotations);
+    q::to_rotations(q::execution::par.on(pool), seq, par_rotations);
+    for (std::size_t i = 0; i < seq.size(); i += 97) {
+        CHECK(par_rotations[i].angle == seq_rotations[i].angle);
+        CHECK_THAT(par_rotations[i].axis, WithinAbs(seq_rotations[i].axis));
+    }
+}
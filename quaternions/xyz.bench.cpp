@@ -0,0 +1,37 @@
+#include <catch2/catch_test_macros.hpp>
+#include <catch2/benchmark/catch_benchmark.hpp>
+#include "xyz.h"
+#include <iterator>
+#include "../test/benchmarks.h"
+#include "../test/helpers.h"
+
+namespace q = quaternions;
+
+namespace {
+    const auto n_max = benchmark_batch_sizes[std::size(benchmark_batch_sizes) - 1];
+    const auto vectors = random_vectors(n_max, 4);
+}
+
+TEST_CASE("xyz normalized")
+{
+    const auto& v = vectors[0];
+    BENCHMARK("xyz normalized") { return v.normalized(); };
+    benchmark_batches("xyz normalized", vectors, [](const q::xyz& vi) { return vi.normalized(); });
+}
+
+TEST_CASE("xyz dot and cross product")
+{
+    const auto& a = vectors[0];
+    const auto& b = vectors[1];
+    BENCHMARK("xyz dot") { return a.dot(b); };
+    BENCHMARK("xyz cross") { return a * b; };
+    benchmark_batches("xyz dot", vectors, [&](const q::xyz& vi) { return vi.dot(b); });
+    benchmark_batches("xyz cross", vectors, [&](const q::xyz& vi) { return vi * b; });
+}
+
+TEST_CASE("xyz to_string")
+{
+    const auto& v = vectors[0];
+    BENCHMARK("xyz to_string") { return v.to_string(); };
+    benchmark_batches("xyz to_string", vectors, [](const q::xyz& vi) { return vi.to_string(); });
+}
@@ -1,41 +1,213 @@
 #ifndef QUATERNIONS_XYZ_H
 #define QUATERNIONS_XYZ_H
 
+#include <cmath>
+#include <cstdint>
+#include <stdexcept>
 #include <string>
+#include <type_traits>
+#include "chars.h"
 
 namespace quaternions {
-    struct xyz {
-        double x;
-        double y;
-        double z;
-        double norm() const;
-        double length() const;
-        bool is_normalized() const;
-        xyz normalized() const;
-        double dot(const xyz& other) const;
+    /**
+     * Default tolerance of almost_equal, loose enough for the rounding error of the scalar type
+     */
+    template<typename T>
+    inline constexpr T default_eps = std::is_same_v<T, float> ? T(1E-6) : T(1E-12);
+
+    template<typename T>
+        requires std::is_floating_point_v<T>
+    constexpr bool almost_equal(T a, std::type_identity_t<T> b, std::type_identity_t<T> eps = default_eps<T>);
+
+    template<typename T>
+    struct basic_xyz {
+        T x;
+        T y;
+        T z;
+        constexpr T norm() const;
+        T length() const;
+        constexpr bool is_normalized() const;
+        basic_xyz normalized() const;
+        constexpr T dot(const basic_xyz& other) const;
         std::string to_string() const;
 
-        double operator[](uint32_t i) const;
+        constexpr T operator[](uint32_t i) const;
     };
 
-    xyz operator+(const xyz a, const xyz b);
-    xyz operator*(const xyz a, const xyz b);
-    xyz operator*(const double a, const xyz b);
-    xyz operator*(const xyz a, const double b);
+    template<typename T>
+    constexpr basic_xyz<T> operator+(const basic_xyz<T> a, const basic_xyz<T> b);
+    template<typename T>
+    constexpr basic_xyz<T> operator*(const basic_xyz<T> a, const basic_xyz<T> b);
+    template<typename T>
+    constexpr basic_xyz<T> operator*(const std::type_identity_t<T> a, const basic_xyz<T> b);
+    template<typename T>
+    constexpr basic_xyz<T> operator*(const basic_xyz<T> a, const std::type_identity_t<T> b);
 
-    bool almost_equal(double a, double b, double eps = 1E-12);
-    bool almost_equal(const xyz& a, const xyz& b, double eps = 1E-12);
+    template<typename T>
+    constexpr bool almost_equal(const basic_xyz<T>& a, const basic_xyz<T>& b,
+                                std::type_identity_t<T> eps = default_eps<T>);
+
+    template<typename T>
+    inline constexpr std::size_t max_chars<basic_xyz<T>> = 17 + 3 * max_chars<T>;
+
+    /**
+     * Writes v as `{ x: 1, y: 0.5, z: -2 }` in shortest round-trip precision without allocating.
+     * Fails with std::errc::value_too_large if the buffer is smaller than needed, max_chars is always enough.
+     */
+    template<typename T>
+    std::to_chars_result to_chars(char* first, char* last, const basic_xyz<T>& v);
+    /**
+     * Parses what to_chars writes, allowing any blanks between the tokens
+     */
+    template<typename T>
+    std::from_chars_result from_chars(const char* first, const char* last, basic_xyz<T>& v);
 
     /**
      * 3x3 matrix with column-major order
      */
-    struct matrix_3x3 {
-        xyz c1;
-        xyz c2;
-        xyz c3;
+    template<typename T>
+    struct basic_matrix_3x3 {
+        basic_xyz<T> c1;
+        basic_xyz<T> c2;
+        basic_xyz<T> c3;
 
-        xyz operator[](uint32_t i) const;
+        constexpr basic_xyz<T> operator[](uint32_t i) const;
     };
+
+    using xyz = basic_xyz<double>;
+    using matrix_3x3 = basic_matrix_3x3<double>;
+
+    template<typename T>
+        requires std::is_floating_point_v<T>
+    constexpr bool almost_equal(T a, std::type_identity_t<T> b, std::type_identity_t<T> eps) {
+        return a - b < eps && b - a < eps;
+    }
+
+    template<typename T>
+    constexpr T basic_xyz<T>::norm() const { return x*x + y*y + z*z; }
+
+    template<typename T>
+    T basic_xyz<T>::length() const { return std::sqrt(norm()); }
+
+    template<typename T>
+    constexpr bool basic_xyz<T>::is_normalized() const {
+        return almost_equal(norm(), T(1), T(1E-6));
+    }
+
+    template<typename T>
+    basic_xyz<T> basic_xyz<T>::normalized() const {
+        return is_normalized()
+               ? *this
+               : [&](){
+                    const auto length = this->length();
+                    return basic_xyz {
+                            x/length,
+                            y/length,
+                            z/length,
+                    };
+                }();
+    }
+
+    template<typename T>
+    constexpr T basic_xyz<T>::dot(const basic_xyz& other) const {
+        return x * other.x + y * other.y + z * other.z;
+    }
+
+    template<typename T>
+    std::string basic_xyz<T>::to_string() const
+    {
+        char buffer[max_chars<basic_xyz>];
+        return std::string(buffer, to_chars(std::begin(buffer), std::end(buffer), *this).ptr);
+    }
+
+    template<typename T>
+    constexpr T basic_xyz<T>::operator[](uint32_t i) const {
+        switch(i)
+        {
+            case 0:
+                return x;
+            case 1:
+                return y;
+            case 2:
+                return z;
+            default:
+                throw std::domain_error("index " + std::to_string(i) + " too high for 3D vector!");
+        }
+    }
+
+    template<typename T>
+    constexpr basic_xyz<T> operator+(const basic_xyz<T> a, const basic_xyz<T> b) {
+        return {
+                a.x + b.x,
+                a.y + b.y,
+                a.z + b.z,
+        };
+    }
+
+    template<typename T>
+    constexpr basic_xyz<T> operator*(const basic_xyz<T> a, const basic_xyz<T> b) {
+        return {
+                a.y * b.z - a.z * b.y,
+                a.z * b.x - a.x * b.z,
+                a.x * b.y - a.y * b.x,
+        };
+    }
+
+    template<typename T>
+    constexpr basic_xyz<T> operator*(const std::type_identity_t<T> a, const basic_xyz<T> b) {
+        return {
+                a * b.x,
+                a * b.y,
+                a * b.z,
+        };
+    }
+
+    template<typename T>
+    constexpr basic_xyz<T> operator*(const basic_xyz<T> a, const std::type_identity_t<T> b) {
+        return b * a;
+    }
+
+    template<typename T>
+    constexpr bool almost_equal(const basic_xyz<T>& a, const basic_xyz<T>& b, std::type_identity_t<T> eps) {
+        return
+                almost_equal(a.x, b.x, eps) &&
+                almost_equal(a.y, b.y, eps) &&
+                almost_equal(a.z, b.z, eps);
+    }
+
+    template<typename T>
+    std::to_chars_result to_chars(char* first, char* last, const basic_xyz<T>& v) {
+        return chars::write_fields(first, last, std::array{'x', 'y', 'z'}, std::array{v.x, v.y, v.z});
+    }
+
+    template<typename T>
+    std::from_chars_result from_chars(const char* first, const char* last, basic_xyz<T>& v) {
+        auto values = std::array<T, 3>{};
+        const auto result = chars::read_fields(first, last, std::array{'x', 'y', 'z'}, values);
+        if (result.ec == std::errc{})
+            v = {values[0], values[1], values[2]};
+        return result;
+    }
+
+    template<typename T>
+    constexpr basic_xyz<T> basic_matrix_3x3<T>::operator[](uint32_t i) const {
+        switch(i)
+        {
+            case 0:
+                return c1;
+            case 1:
+                return c2;
+            case 2:
+                return c3;
+            default:
+                throw std::domain_error("index " + std::to_string(i) + " too high for 3x3 matrix!");
+        }
+    }
 }
 
+#if defined(__cpp_lib_format)
+template<typename T>
+struct std::formatter<quaternions::basic_xyz<T>, char> : quaternions::chars::formatter<quaternions::basic_xyz<T>> {};
+#endif
+
 #endif //QUATERNIONS_XYZ_H
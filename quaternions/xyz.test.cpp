@@ -84,4 +84,54 @@ TEST_CASE("accessing 3x3 matrix with to large index should fail")
 {
     const auto m = q::matrix_3x3{};
     CHECK_THROWS(m[3]);
-}
\ No newline at end of file
+}
+TEST_CASE("vector arithmetic is usable in constant expressions")
+{
+    constexpr auto v1 = q::basic_xyz<float>{2, 3, 4};
+    constexpr auto v2 = q::basic_xyz<float>{3, 4, 5};
+    static_assert(v1.dot(v2) == 38);
+    static_assert(v1.norm() == 29);
+    static_assert(q::almost_equal(v1 * v2, q::basic_xyz<float>{-1, 2, -1}));
+    static_assert(q::almost_equal(2 * v1 + v2, q::basic_xyz<float>{7, 10, 13}));
+    static_assert(q::basic_xyz<long double>{0, 0, 1}.is_normalized());
+    CHECK(v1[2] == 4);
+}
+
+TEST_CASE("vector text in shortest round-trip precision")
+{
+    CHECK(q::xyz{1, -0.5, 1E-300}.to_string() == "{ x: 1, y: -0.5, z: 1e-300 }");
+    for (const auto& v : random_vectors(100, 1)) {
+        char buffer[q::max_chars<q::xyz>];
+        const auto written = q::to_chars(std::begin(buffer), std::end(buffer), v);
+        REQUIRE(written.ec == std::errc{});
+        auto parsed = q::xyz{};
+        const auto read = q::from_chars(buffer, written.ptr, parsed);
+        CHECK(read.ec == std::errc{});
+        CHECK(read.ptr == written.ptr);
+        CHECK((parsed.x == v.x && parsed.y == v.y && parsed.z == v.z));
+    }
+}
+
+TEST_CASE("vector text written into too small buffer should fail")
+{
+    char buffer[12];
+    CHECK(q::to_chars(std::begin(buffer), std::end(buffer), q::xyz{1, 2, 3}).ec == std::errc::value_too_large);
+}
+
+TEST_CASE("parsing vector text")
+{
+    const auto text = std::string("{x:1,  y :\t2.5e3 , z: -0 }  trailing");
+    auto v = q::xyz{};
+    const auto read = q::from_chars(text.data(), text.data() + text.size(), v);
+    CHECK(read.ec == std::errc{});
+    CHECK(std::string(read.ptr) == "  trailing");
+    CHECK_THAT(v, WithinAbs(q::xyz{1, 2500, 0}));
+
+    const auto invalid = GENERATE(as<std::string>{}, "", "{ x: 1, y: 2 }", "{ x: 1, z: 2, y: 3 }", "{ x: a, y: 2, z: 3 }",
+                                  "{ x: 1, y: 2, z: 3");
+    auto unchanged = q::xyz{7, 7, 7};
+    const auto failed = q::from_chars(invalid.data(), invalid.data() + invalid.size(), unchanged);
+    CHECK(failed.ec == std::errc::invalid_argument);
+    CHECK(failed.ptr == invalid.data());
+    CHECK_THAT(unchanged, WithinAbs(q::xyz{7, 7, 7}));
+}
@@ -0,0 +1,93 @@
+#include <catch2/reporters/catch_reporter_registrars.hpp>
+#include <catch2/reporters/catch_reporter_streaming_base.hpp>
+#include <catch2/interfaces/catch_interfaces_reporter.hpp>
+#include <catch2/catch_test_case_info.hpp>
+#include <ostream>
+#include <string>
+#include <vector>
+
+namespace {
+    std::string json_escaped(const std::string& s) {
+        auto result = std::string{};
+        for (const auto c : s) {
+            switch (c) {
+                case '"':
+                    result += "\\\"";
+                    break;
+                case '\\':
+                    result += "\\\\";
+                    break;
+                case '\n':
+                    result += "\\n";
+                    break;
+                default:
+                    result += c;
+            }
+        }
+        return result;
+    }
+
+    struct benchmark_result {
+        std::string test_case;
+        std::string name;
+        unsigned int samples;
+        int iterations;
+        double mean_ns;
+        double mean_lower_ns;
+        double mean_upper_ns;
+        double standard_deviation_ns;
+    };
+
+    /**
+     * Writes all benchmark results of a run as one JSON document, e.g. for
+     * `benchmarks --reporter benchmark-json::out=benchmarks.json`
+     */
+    class benchmark_json_reporter : public Catch::StreamingReporterBase {
+    public:
+        using StreamingReporterBase::StreamingReporterBase;
+
+        static std::string getDescription() {
+            return "Reports benchmark timings as JSON";
+        }
+
+        void benchmarkEnded(Catch::BenchmarkStats<> const& stats) override {
+            results.push_back(benchmark_result{
+                currentTestCaseInfo ? currentTestCaseInfo->name : std::string{},
+                stats.info.name,
+                static_cast<unsigned int>(stats.info.samples),
+                stats.info.iterations,
+                stats.mean.point.count(),
+                stats.mean.lower_bound.count(),
+                stats.mean.upper_bound.count(),
+                stats.standardDeviation.point.count(),
+            });
+        }
+
+        void testRunEnded(Catch::TestRunStats const& stats) override {
+            StreamingReporterBase::testRunEnded(stats);
+            m_stream.precision(12);
+            m_stream << "{\n  \"benchmarks\": [";
+            for (std::size_t i = 0; i < results.size(); ++i) {
+                const auto& r = results[i];
+                m_stream << (i == 0 ? "\n" : ",\n")
+                         << "    {"
+                         << "\"test_case\": \"" << json_escaped(r.test_case) << "\", "
+                         << "\"name\": \"" << json_escaped(r.name) << "\", "
+                         << "\"samples\": " << r.samples << ", "
+                         << "\"iterations\": " << r.iterations << ", "
+                         << "\"mean_ns\": " << r.mean_ns << ", "
+                         << "\"mean_lower_ns\": " << r.mean_lower_ns << ", "
+                         << "\"mean_upper_ns\": " << r.mean_upper_ns << ", "
+                         << "\"standard_deviation_ns\": " << r.standard_deviation_ns
+                         << "}";
+            }
+            m_stream << "\n  ]\n}\n";
+            m_stream.flush();
+        }
+
+    private:
+        std::vector<benchmark_result> results;
+    };
+}
+
+CATCH_REGISTER_REPORTER("benchmark-json", benchmark_json_reporter)
@@ -0,0 +1,9 @@
+#include "benchmarks.h"
+
+std::string batch_label(std::size_t n) {
+    if (n % 1'000'000 == 0)
+        return std::to_string(n / 1'000'000) + "M";
+    if (n % 1'000 == 0)
+        return std::to_string(n / 1'000) + "K";
+    return std::to_string(n);
+}
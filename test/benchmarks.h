@@ -0,0 +1,36 @@
+#ifndef QUATERNIONS_TEST_BENCHMARKS_H
+#define QUATERNIONS_TEST_BENCHMARKS_H
+#include <catch2/benchmark/catch_benchmark.hpp>
+#include <cstddef>
+#include <string>
+#include <type_traits>
+#include <vector>
+
+/**
+ * Batch sizes every operation is timed for, in addition to single calls
+ */
+inline constexpr std::size_t benchmark_batch_sizes[] = {1'000, 1'000'000};
+
+/**
+ * Short label for a batch size, e.g. "1K" or "1M"
+ */
+std::string batch_label(std::size_t n);
+
+/**
+ * Times op applied to each of the first n inputs for all benchmark_batch_sizes.
+ * input needs at least as many elements as the largest batch size.
+ */
+template<typename In, typename Op>
+void benchmark_batches(const std::string& name, const std::vector<In>& input, Op op) {
+    using Out = std::decay_t<decltype(op(input[0]))>;
+    for (const auto n : benchmark_batch_sizes) {
+        auto output = std::vector<Out>(n);
+        BENCHMARK(name + " x" + batch_label(n)) {
+            for (std::size_t i = 0; i < n; ++i)
+                output[i] = op(input[i]);
+            return output.data();
+        };
+    }
+}
+
+#endif //QUATERNIONS_TEST_BENCHMARKS_H
@@ -1,4 +1,7 @@
 #include "helpers.h"
+#include <cmath>
+#include <random>
+#include "../quaternions/exponential.h"
 
 auto WithinAbs(const q::xyz &xyz, double eps) -> WithinAbsXyzMatcher {
     return WithinAbsXyzMatcher{xyz, eps};
@@ -8,3 +11,57 @@ auto WithinAbs(const q::quaternion &quaternion,
                double eps) -> WithinAbsQuaternionMatcher {
     return WithinAbsQuaternionMatcher{quaternion, eps};
 }
+
+std::vector<q::quaternion> random_quaternions(std::size_t n, std::uint32_t seed) {
+    auto engine = std::mt19937{seed};
+    auto dist = std::uniform_real_distribution<double>{-1.0, 1.0};
+    auto result = std::vector<q::quaternion>(n);
+    for (auto& q : result)
+        q = q::quaternion{dist(engine), dist(engine), dist(engine), dist(engine)};
+    return result;
+}
+
+std::vector<q::quaternion> random_unit_quaternions(std::size_t n, std::uint32_t seed) {
+    auto result = random_quaternions(n, seed);
+    for (auto& q : result)
+        q = q.normalized();
+    return result;
+}
+
+std::vector<q::xyz> random_vectors(std::size_t n, std::uint32_t seed) {
+    auto engine = std::mt19937{seed};
+    auto dist = std::uniform_real_distribution<double>{-1.0, 1.0};
+    auto result = std::vector<q::xyz>(n);
+    for (auto& v : result)
+        v = q::xyz{dist(engine), dist(engine), dist(engine)};
+    return result;
+}
+
+imu_recording synthetic_imu(std::size_t sensors, std::size_t samples, double sample_period,
+                            double noise, std::uint32_t seed) {
+    const auto initial = random_unit_quaternions(sensors, seed);
+    const auto rates = random_vectors(sensors, seed + 1);
+    auto engine = std::mt19937{seed + 2};
+    auto dist = std::normal_distribution<double>{0, noise > 0 ? noise : 1};
+    const auto disturbed = [&](const q::xyz& v) {
+        return noise > 0 ? q::xyz{v.x + noise * dist(engine), v.y + noise * dist(engine), v.z + noise * dist(engine)} : v;
+    };
+    // readings are the earth references in sensor coordinates
+    const auto sensed = [](const q::quaternion& orientation, const q::xyz& v) {
+        return (orientation.conjugated() * q::quaternion::from_vector(v) * orientation).vector();
+    };
+    const auto field = q::xyz{std::cos(M_PI / 3), 0, -std::sin(M_PI / 3)};
+
+    auto recording = imu_recording{};
+    for (std::size_t k = 1; k <= samples; ++k)
+        for (std::size_t i = 0; i < sensors; ++i) {
+            const auto& w = rates[i];
+            const auto half_angle = static_cast<double>(k) * sample_period / 2;
+            const auto orientation = initial[i] * q::exp(q::quaternion{0, w.x, w.y, w.z} * half_angle);
+            recording.truth.push_back(orientation);
+            recording.gyroscope.push_back(disturbed(w));
+            recording.accelerometer.push_back(disturbed(sensed(orientation, {0, 0, 1})));
+            recording.magnetometer.push_back(disturbed(sensed(orientation, field)));
+        }
+    return recording;
+}
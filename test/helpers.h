@@ -1,6 +1,9 @@
 #ifndef QUATERNIONS_TEST_HELPERS_H
 #define QUATERNIONS_TEST_HELPERS_H
 #include <catch2/matchers/catch_matchers_templated.hpp>
+#include <cstddef>
+#include <cstdint>
+#include <vector>
 #include "../quaternions/xyz.h"
 #include "../quaternions/quaternion.h"
 
@@ -64,4 +67,27 @@ private:
 
 auto WithinAbs(const q::xyz& xyz, double eps = 1E-12) -> WithinAbsXyzMatcher;
 
+/**
+ * Reproducible pseudo-random inputs with components in [-1, 1]
+ */
+std::vector<q::quaternion> random_quaternions(std::size_t n, std::uint32_t seed = 1);
+std::vector<q::quaternion> random_unit_quaternions(std::size_t n, std::uint32_t seed = 1);
+std::vector<q::xyz> random_vectors(std::size_t n, std::uint32_t seed = 1);
+
+/**
+ * Readings of sensors turning at constant random rates up to 1 rad/s from random orientations,
+ * sample-major, with the true orientations (sensor to earth) after every sample. The accelerometers
+ * measure gravity along z, the magnetometers a field pointing north and 60 degrees down. noise is
+ * the standard deviation added to every reading component.
+ */
+struct imu_recording {
+    std::vector<q::quaternion> truth;
+    std::vector<q::xyz> gyroscope;
+    std::vector<q::xyz> accelerometer;
+    std::vector<q::xyz> magnetometer;
+};
+
+imu_recording synthetic_imu(std::size_t sensors, std::size_t samples, double sample_period,
+                            double noise = 0, std::uint32_t seed = 1);
+
 #endif //QUATERNIONS_TEST_HELPERS_H